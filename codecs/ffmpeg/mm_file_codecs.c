@@ -131,3 +131,9 @@ int mmfile_codec_close (MMFileCodecContext *codecContext)
     return MMFILE_CODEC_SUCCESS;
 }
 
+EXPORT_API
+const MMFileCodecFuncs mmfile_codec_funcs = {
+    mmfile_codec_open,
+    mmfile_codec_decode,
+    mmfile_codec_close,
+};
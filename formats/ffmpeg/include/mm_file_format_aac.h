@@ -76,7 +76,7 @@ typedef struct _mmfileaactaginfo {
 } tMMFILE_AAC_TAG_INFO;
 
 
-int mmfile_aacparser_open (MMFileAACHandle *handle, const char *src);
+int mmfile_aacparser_open (MMFileAACHandle *handle, MMFileFormatContext *formatContext);
 int mmfile_aacparser_get_stream_info (MMFileAACHandle handle, tMMFILE_AAC_STREAM_INFO *aacinfo);
 int mmfile_aacparser_get_tag_info (MMFileAACHandle handle, tMMFILE_AAC_TAG_INFO *info);
 int mmfile_aacparser_get_next_frame (MMFileAACHandle handle, tMMFILE_AAC_STREAM_INFO *aacinfo);
@@ -44,7 +44,7 @@ typedef struct _mmfileamrstreaminfo {
 } tMMFILE_AMR_STREAM_INFO;
 
 
-int mmfile_amrparser_open (MMFileAMRHandle *handle, const char *src);
+int mmfile_amrparser_open (MMFileAMRHandle *handle, MMFileFormatContext *formatContext);
 int mmfile_amrparser_get_stream_info (MMFileAMRHandle handle, tMMFILE_AMR_STREAM_INFO *amrinfo);
 int mmfile_amrparser_close (MMFileAMRHandle handle);
 
@@ -27,6 +27,14 @@
 extern "C" {
 #endif
 
+void mmfile_format_init_ffmpeg (void);
+
+struct AVCodecContext;
+struct AVCodec;
+
+/* avcodec_open()/avcodec_close() serialized inside this library */
+int mmfile_format_codec_open_ffmpeg (struct AVCodecContext *codecCtx, struct AVCodec *codec);
+int mmfile_format_codec_close_ffmpeg (struct AVCodecContext *codecCtx);
 
 #ifdef __cplusplus
 }
@@ -39,6 +39,8 @@ typedef struct {
 } MIDI_INFO_SIMPLE;
 
 MIDI_INFO_SIMPLE*	mmfile_format_get_midi_infomation (char* uri);
+MIDI_INFO_SIMPLE*	mmfile_format_get_midi_infomation_from_buffer (unsigned char *data, unsigned int size);
+MIDI_INFO_SIMPLE*	mmfile_format_get_midi_infomation_from_context (MMFileFormatContext *formatContext);
 void				mmfile_format_free_midi_infomation (MIDI_INFO_SIMPLE *info);
 
 #ifdef __cplusplus
@@ -43,6 +43,14 @@ int mmfile_format_open_wav   (MMFileFormatContext *fileContext);
 int mmfile_format_open_mid   (MMFileFormatContext *fileContext);
 int mmfile_format_open_imy   (MMFileFormatContext *fileContext);
 
+/* shared I/O of the format context, opened by mmfile_format_open */
+#define MMFILE_FORMAT_IS_PROBED(ctx, format)	((ctx)->probedFormats & (1 << (format)))
+
+int				mmfile_format_read_at	(MMFileFormatContext *formatContext, long long offset, unsigned char *buf, int size);
+unsigned char*	mmfile_format_load_all	(MMFileFormatContext *formatContext, int *size);
+int				mmfile_format_peek		(MMFileFormatContext *formatContext, long long offset, int size, const unsigned char **ptr);
+void			mmfile_format_peek_release	(MMFileFormatContext *formatContext, const unsigned char *ptr);
+
 
 #ifdef __cplusplus
 }
@@ -202,17 +202,24 @@ int _parse_id3_tag(tMMFILE_AAC_HANDLE* pData)
   int ret = FALSE;
   int readed = 0;
 
+  /* the tag only, the file may be larger than memory */
+  if(hTag->tagV2Info.tagLen <= 0 || hTag->tagV2Info.tagLen > hTag->fileLen) {
+    ret = MMFILE_AAC_PARSER_FAIL;
+    debug_error ("invalid tag length. %d\n", hTag->tagV2Info.tagLen);
+    goto failure;
+  }
+
   mmfile_seek(pData->hFile, pData->tagOffset, MMFILE_SEEK_SET);
-  tagBuff = (unsigned char*) mmfile_malloc(hTag->fileLen);
+  tagBuff = (unsigned char*) mmfile_malloc(hTag->tagV2Info.tagLen);
   if(tagBuff == NULL) {
     ret = MMFILE_AAC_PARSER_FAIL;
-    debug_error ("failed to memory allocation. %d\n", hTag->fileLen);
+    debug_error ("failed to memory allocation. %d\n", hTag->tagV2Info.tagLen);
     goto failure;
   }
 
-  readed = mmfile_read(pData->hFile, tagBuff, hTag->fileLen);
-  if (readed != hTag->fileLen) {
-    debug_error ("faied to read. %d, %lld\n", readed, hTag->fileLen);
+  readed = mmfile_read(pData->hFile, tagBuff, hTag->tagV2Info.tagLen);
+  if (readed != hTag->tagV2Info.tagLen) {
+    debug_error ("faied to read. %d, %d\n", readed, hTag->tagV2Info.tagLen);
     goto failure;
   }
  
@@ -237,6 +244,8 @@ int _parse_id3_tag(tMMFILE_AAC_HANDLE* pData)
     goto failure;
   }
 
+  /* no lyrics are reported for AAC */
+  mm_file_id3tag_decode(hTag, tagBuff, AV_ID3V2_FRAME_TEXT | AV_ID3V2_FRAME_IMAGE);
   mm_file_id3tag_restore_content_info(hTag);
 
   pData->tagInfo.title = hTag->pTitle;
@@ -521,7 +530,7 @@ function_end:
 }
 
 
-int mmfile_aacparser_open (MMFileAACHandle *handle, const char *filenamec)
+int mmfile_aacparser_open (MMFileAACHandle *handle, MMFileFormatContext *formatContext)
 {
   tMMFILE_AAC_HANDLE *privateData = NULL;
   int ret = 0;
@@ -529,7 +538,7 @@ int mmfile_aacparser_open (MMFileAACHandle *handle, const char *filenamec)
   int firstFrameLen = 0;
   int readed = 0;
   
-  if (NULL == filenamec) {
+  if (NULL == formatContext || NULL == formatContext->ioHandle) {
     debug_error ("file source is NULL\n");
     return MMFILE_AAC_PARSER_FAIL;
   }
@@ -540,17 +549,12 @@ int mmfile_aacparser_open (MMFileAACHandle *handle, const char *filenamec)
     return MMFILE_AAC_PARSER_FAIL;
   }
 
-  ret = mmfile_open (&privateData->hFile, filenamec, MMFILE_RDONLY);
-  if(ret == MMFILE_UTIL_FAIL) {    	
-    debug_error ("error: mmfile_open\n");
-    goto exception;        
-  }
-
    /* Initialize the members of handle */
   _aac_init_handle(privateData);
- 
-  mmfile_seek (privateData->hFile, 0, MMFILE_SEEK_END);
-  privateData->streamInfo.fileSize= mmfile_tell(privateData->hFile);
+
+  /* borrowed from the format context, which opened it while probing */
+  privateData->hFile = formatContext->ioHandle;
+  privateData->streamInfo.fileSize = formatContext->fileSize;
 
   mmfile_seek (privateData->hFile, 0, MMFILE_SEEK_SET);
  
@@ -601,7 +605,6 @@ int mmfile_aacparser_open (MMFileAACHandle *handle, const char *filenamec)
 
 exception:
   if (privateData) { 
-    mmfile_close (privateData->hFile);
     mmfile_free (privateData);
     *handle = NULL;
   }
@@ -644,6 +647,12 @@ int mmfile_aacparser_get_stream_info (MMFileAACHandle handle, tMMFILE_AAC_STREAM
   if(privateData->formatType == AAC_FORMAT_ADTS) {
 
     while(TRUE) {
+      /* checked once per 64 frames, the walk can cover the whole file */
+      if(!(totalFrames & 0x3F) && mmfile_abort_check()) {
+        debug_warning("aborted while walking adts frames\n");
+        return MMFILE_AAC_PARSER_FAIL;
+      }
+
       ret = _get_next_adts_frame_length(privateData, &frameLen);
       if(ret != MMFILE_AAC_PARSER_SUCCESS) {
         break;
@@ -657,7 +666,7 @@ int mmfile_aacparser_get_stream_info (MMFileAACHandle handle, tMMFILE_AAC_STREAM
     }
 
 #ifdef __MMFILE_TEST_MODE__    
-    debug_msg("No of ADTS frames: %d\n", totalFrames);
+    debug_msg("No of ADTS frames: %lld\n", totalFrames);
 #endif    
     privateData->streamInfo.frameRate = privateData->streamInfo.samplingRate / AAC_ADTS_SAMPLES_PER_FRAME;
     
@@ -718,8 +727,7 @@ int mmfile_aacparser_close (MMFileAACHandle handle)
 
   privateData = (tMMFILE_AAC_HANDLE *) handle;
   mm_file_free_AvFileContentInfo(&privateData->id3Handle);
-  
-  mmfile_close(privateData->hFile);
+  privateData->hFile = NULL;
 
   return MMFILE_AAC_PARSER_SUCCESS;
 }
@@ -744,8 +752,7 @@ int mmfile_format_open_aac (MMFileFormatContext *formatContext)
 	}
 
 	if (formatContext->pre_checked == 0) {
-		res = MMFileFormatIsValidAAC (formatContext->uriFileName);
-		if (res == 0) {
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_AAC)) {
 			debug_error("It is not AAC file\n");
 			return MMFILE_FORMAT_FAIL;        
 		}
@@ -759,7 +766,7 @@ int mmfile_format_open_aac (MMFileFormatContext *formatContext)
 	formatContext->videoTotalTrackNum = 0;
 	formatContext->audioTotalTrackNum = 1;
 
-	res = mmfile_aacparser_open (&handle, formatContext->uriFileName);
+	res = mmfile_aacparser_open (&handle, formatContext);
 	if (MMFILE_AAC_PARSER_FAIL == res) {
 		debug_error ("mmfile_aacparser_open\n");
 		return MMFILE_FORMAT_FAIL;
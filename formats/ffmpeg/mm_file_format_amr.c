@@ -199,6 +199,12 @@ int _parse_amr_stream(tMMFILE_AMR_HANDLE* pData)
 	}
 
 	for (readed = 0;;) {
+		if (mmfile_abort_check ()) {
+			debug_warning ("aborted while parsing amr stream\n");
+			ret = MMFILE_AMR_PARSER_FAIL;
+			break;
+		}
+
 		readed = mmfile_read (pData->hFile, buf, AMR_MAX_READ_BUF_SZ);
 		if (readed <= 0) break;
 
@@ -233,12 +239,12 @@ int _parse_amr_stream(tMMFILE_AMR_HANDLE* pData)
 }
 
 
-int mmfile_amrparser_open (MMFileAMRHandle *handle, const char *filenamec)
+int mmfile_amrparser_open (MMFileAMRHandle *handle, MMFileFormatContext *formatContext)
 {
   tMMFILE_AMR_HANDLE *privateData = NULL;
   int ret = 0;
   
-  if (NULL == filenamec || NULL == handle) {
+  if (NULL == formatContext || NULL == formatContext->ioHandle || NULL == handle) {
     debug_error ("file source is NULL\n");
     return MMFILE_AMR_PARSER_FAIL;
   }
@@ -252,14 +258,9 @@ int mmfile_amrparser_open (MMFileAMRHandle *handle, const char *filenamec)
    /* Initialize the members of handle */
   _amr_init_handle(privateData);
   
-  ret = mmfile_open (&privateData->hFile, filenamec, MMFILE_RDONLY);
-  if(ret == MMFILE_UTIL_FAIL) {    	
-    debug_error ("error: mmfile_open\n");
-    goto exception;        
-  }
-
-  mmfile_seek (privateData->hFile, 0, MMFILE_SEEK_END);
-  privateData->fileSize= mmfile_tell(privateData->hFile);
+  /* borrowed from the format context, which opened it while probing */
+  privateData->hFile = formatContext->ioHandle;
+  privateData->fileSize = formatContext->fileSize;
   mmfile_seek (privateData->hFile, 0, MMFILE_SEEK_SET);
 
   if(privateData->fileSize < MMFILE_AMR_MIN_HEADER_SIZE) {
@@ -289,7 +290,6 @@ int mmfile_amrparser_open (MMFileAMRHandle *handle, const char *filenamec)
   
 exception:
   if (privateData) { 
-    mmfile_close (privateData->hFile);
     mmfile_free (privateData);
     *handle = NULL;
   }
@@ -346,8 +346,7 @@ int mmfile_amrparser_close (MMFileAMRHandle handle)
   }
 
   privateData = (tMMFILE_AMR_HANDLE *) handle;
-  
-  mmfile_close(privateData->hFile);
+  privateData->hFile = NULL;
 
   return MMFILE_AMR_PARSER_SUCCESS;
 }
@@ -380,7 +379,7 @@ int mmfile_format_open_amr (MMFileFormatContext *formatContext)
 	formatContext->videoTotalTrackNum = 0;
 	formatContext->audioTotalTrackNum = 1;
 
-	res = mmfile_amrparser_open (&handle, formatContext->uriFileName);
+	res = mmfile_amrparser_open (&handle, formatContext);
 	if (MMFILE_AMR_PARSER_FAIL == res) {
 		debug_error ("mmfile_amrparser_open\n");
 		return MMFILE_FORMAT_FAIL;
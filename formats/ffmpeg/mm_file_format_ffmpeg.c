@@ -21,6 +21,8 @@
  
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include <libavformat/avformat.h>
 #include <libavcodec/avcodec.h>
@@ -34,7 +36,6 @@
 #include "mm_file_utils.h"
 #include "mm_file_format_ffmpeg.h"
 
-#include "mm_file_format_ffmpeg_mem.h"
 #include <sys/time.h>
 
 
@@ -65,23 +66,71 @@ int mmfile_format_read_tag_ffmpg    (MMFileFormatContext *formatContext);
 int mmfile_format_close_ffmpg       (MMFileFormatContext *formatContext);
 static int getMimeType(int formatId, char *mimeType); 
 
+static pthread_once_t g_ffmpeg_once = PTHREAD_ONCE_INIT;
 
+/**
+ * AVFormatContext.interrupt_callback came with libavformat 53.15, the 0.8.x
+ * releases only have the process wide url_set_interrupt_cb(). Either way the
+ * callback asks mmfile_abort_check(), which sees the calling thread's
+ * deadline only.
+ */
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 15, 0)
+#define _FFMPEG_HAS_INTERRUPT_CB
 
-EXPORT_API
-int mmfile_format_open_ffmpg (MMFileFormatContext *formatContext)
+/* ffmpeg polls this during blocking I/O and av_find_stream_info() */
+static int _ffmpeg_interrupt (void *opaque)
+{
+	return mmfile_abort_check () != MMFILE_ABORT_NONE;
+}
+
+static void _ffmpeg_set_interrupt (AVFormatContext *ctx)
+{
+	ctx->interrupt_callback.callback = _ffmpeg_interrupt;
+	ctx->interrupt_callback.opaque = NULL;
+}
+#else
+/* registered once by _ffmpeg_init() */
+static int _ffmpeg_interrupt (void)
+{
+	return mmfile_abort_check () != MMFILE_ABORT_NONE;
+}
+
+static void _ffmpeg_set_interrupt (AVFormatContext *ctx)
+{
+}
+#endif
+
+/**
+ * avcodec_open()/avcodec_close() are not thread safe. They are serialized here
+ * instead of by av_lockmgr_register(): there is one lock manager per process,
+ * and it belongs to the application.
+ */
+static pthread_mutex_t g_ffmpeg_codec_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int mmfile_format_codec_open_ffmpeg (AVCodecContext *codecCtx, AVCodec *codec)
 {
-	AVFormatContext     *pFormatCtx = NULL;
-	AVInputFormat       *grab_iformat = NULL;
 	int ret = 0;
-	int i;
-	char ffmpegFormatName[MMFILE_FILE_FMT_MAX_LEN] = {0,};
-	char mimeType[MMFILE_MIMETYPE_MAX_LEN] = {0,};
 
-	formatContext->ReadStream   = mmfile_format_read_stream_ffmpg;
-	formatContext->ReadFrame    = mmfile_format_read_frame_ffmpg;
-	formatContext->ReadTag      = mmfile_format_read_tag_ffmpg;
-	formatContext->Close        = mmfile_format_close_ffmpg;
+	pthread_mutex_lock (&g_ffmpeg_codec_lock);
+	ret = avcodec_open (codecCtx, codec);
+	pthread_mutex_unlock (&g_ffmpeg_codec_lock);
+
+	return ret;
+}
+
+int mmfile_format_codec_close_ffmpeg (AVCodecContext *codecCtx)
+{
+	int ret = 0;
 
+	pthread_mutex_lock (&g_ffmpeg_codec_lock);
+	ret = avcodec_close (codecCtx);
+	pthread_mutex_unlock (&g_ffmpeg_codec_lock);
+
+	return ret;
+}
+
+static void _ffmpeg_init (void)
+{
 #ifdef __MMFILE_TEST_MODE__
 	debug_msg ("ffmpeg version: %d\n", avformat_version ());
 	/**
@@ -101,13 +150,150 @@ int mmfile_format_open_ffmpg (MMFileFormatContext *formatContext)
 
 	av_register_all();
 
-	if (formatContext->filesrc->type  == MM_FILE_SRC_TYPE_MEMORY) {
+#ifndef _FFMPEG_HAS_INTERRUPT_CB
+	url_set_interrupt_cb (_ffmpeg_interrupt);
+#endif
+}
+
+#ifdef __MMFILE_FFMPEG_V085__
+#define _FFMPEG_AVIO_BUFFER_SIZE	(32 * 1024)
+
+/**
+ * ffmpeg reads every source through a MMFileIOHandle, no protocol is registered.
+ * So its reads go through the block buffer and show in the I/O counters.
+ */
+static int _ffmpeg_avio_read (void *opaque, uint8_t *buf, int size)
+{
+	int readed = mmfile_read ((MMFileIOHandle *)opaque, buf, size);
+
+	return (readed < 0) ? AVERROR(EIO) : readed;
+}
+
+static int64_t _ffmpeg_avio_seek (void *opaque, int64_t offset, int whence)
+{
+	MMFileIOHandle *handle = (MMFileIOHandle *)opaque;
+	long long pos = 0;
+	long long size = 0;
+
+	if (whence & AVSEEK_SIZE) {
+		pos = mmfile_tell (handle);
+		size = mmfile_seek (handle, 0, MMFILE_SEEK_END);
+		mmfile_seek (handle, pos, MMFILE_SEEK_SET);
+		return size;
+	}
+
+	return mmfile_seek (handle, offset, whence & ~AVSEEK_FORCE);
+}
+
+/* name is only a probing hint (file extension), "" if there is none */
+static int _ffmpeg_open_io (AVFormatContext **pFormatCtx, const char *uri, const char *name, AVInputFormat *fmt)
+{
+	MMFileIOHandle *handle = NULL;
+	AVIOContext *pb = NULL;
+	AVFormatContext *ctx = NULL;
+	unsigned char *buffer = NULL;
+	int ret = -1;
+
+	*pFormatCtx = NULL;
+
+	if (mmfile_open (&handle, uri, MMFILE_RDONLY) == MMFILE_UTIL_FAIL) {
+		debug_error ("error: mmfile_open [%s]\n", uri);
+		return -1;
+	}
 
-#ifdef __MMFILE_FFMPEG_V085__ 
-		ffurl_register_protocol(&MMFileMEMProtocol, sizeof (URLProtocol));
+	buffer = av_malloc (_FFMPEG_AVIO_BUFFER_SIZE);
+	if (!buffer) {
+		debug_error ("error: av_malloc avio buffer\n");
+		goto exception;
+	}
+
+	pb = avio_alloc_context (buffer, _FFMPEG_AVIO_BUFFER_SIZE, 0, handle, _ffmpeg_avio_read, NULL, _ffmpeg_avio_seek);
+	if (!pb) {
+		debug_error ("error: avio_alloc_context\n");
+		goto exception;
+	}
+
+	ctx = avformat_alloc_context ();
+	if (!ctx) {
+		debug_error ("error: avformat_alloc_context\n");
+		goto exception;
+	}
+
+	ctx->pb = pb;
+	_ffmpeg_set_interrupt (ctx);
+
+	/* frees ctx on failure, the io context stays ours */
+	*pFormatCtx = ctx;
+	ret = avformat_open_input (pFormatCtx, name, fmt, NULL);
+	if (ret < 0) {
+		*pFormatCtx = NULL;
+		goto exception;
+	}
+
+	return ret;
+
+exception:
+	if (pb) {
+		av_free (pb->buffer);
+		av_free (pb);
+	} else if (buffer) {
+		av_free (buffer);
+	}
+
+	mmfile_close (handle);
+
+	return ret;
+}
+#endif
+
+/* also releases the io context of _ffmpeg_open_io */
+static void _ffmpeg_close_input (AVFormatContext *pFormatCtx)
+{
+#ifdef __MMFILE_FFMPEG_V085__
+	AVIOContext *pb = (pFormatCtx->flags & AVFMT_FLAG_CUSTOM_IO) ? pFormatCtx->pb : NULL;
+
+	av_close_input_file (pFormatCtx);
+
+	if (pb) {
+		mmfile_close ((MMFileIOHandle *)pb->opaque);
+		av_free (pb->buffer);
+		av_free (pb);
+	}
 #else
-		register_protocol (&MMFileMEMProtocol);
-#endif	
+	av_close_input_file (pFormatCtx);
+#endif
+}
+
+/**
+ * registers ffmpeg formats and protocols once per process.
+ */
+EXPORT_API
+void mmfile_format_init_ffmpeg (void)
+{
+	pthread_once (&g_ffmpeg_once, _ffmpeg_init);
+}
+
+
+
+EXPORT_API
+int mmfile_format_open_ffmpg (MMFileFormatContext *formatContext)
+{
+	AVFormatContext     *pFormatCtx = NULL;
+	AVInputFormat       *grab_iformat = NULL;
+	int ret = 0;
+	int i;
+	char ffmpegFormatName[MMFILE_FILE_FMT_MAX_LEN] = {0,};
+	char mimeType[MMFILE_MIMETYPE_MAX_LEN] = {0,};
+
+	formatContext->ReadStream   = mmfile_format_read_stream_ffmpg;
+	formatContext->ReadFrame    = mmfile_format_read_frame_ffmpg;
+	formatContext->ReadTag      = mmfile_format_read_tag_ffmpg;
+	formatContext->Close        = mmfile_format_close_ffmpg;
+
+	mmfile_format_init_ffmpeg ();
+
+	if (formatContext->filesrc->type  == MM_FILE_SRC_TYPE_MEMORY) {
+
 		if(getMimeType(formatContext->filesrc->memory.format,mimeType)< 0) {
 			debug_error ("error: Error in MIME Type finding\n");
 			return MMFILE_FORMAT_FAIL;
@@ -130,15 +316,32 @@ int mmfile_format_open_ffmpg (MMFileFormatContext *formatContext)
 		}
 
 #ifdef __MMFILE_FFMPEG_V085__
-		ret = avformat_open_input (&pFormatCtx, formatContext->uriFileName, grab_iformat, NULL);
+		/* the mem:// handle reads the caller buffer in place */
+		ret = _ffmpeg_open_io (&pFormatCtx, formatContext->uriFileName, "", grab_iformat);
+		if (ret < 0) {
+			debug_error("error: cannot open %s %d\n", formatContext->uriFileName, ret);
+			goto exception;
+		}
+		formatContext->privateFormatData = pFormatCtx;
 #else
-		ret = av_open_input_file (&pFormatCtx, formatContext->uriFileName, grab_iformat, 0, NULL);
+		debug_error ("error: memory source needs ffmpeg avio\n");
+		goto exception;
 #endif
+	}
+
+	if (formatContext->filesrc->type  == MM_FILE_SRC_TYPE_CALLBACK) {
+#ifdef __MMFILE_FFMPEG_V085__
+		/* no format hint, ffmpeg probes the content */
+		ret = _ffmpeg_open_io (&pFormatCtx, formatContext->uriFileName, "", NULL);
 		if (ret < 0) {
 			debug_error("error: cannot open %s %d\n", formatContext->uriFileName, ret);
 			goto exception;
 		}
 		formatContext->privateFormatData = pFormatCtx;
+#else
+		debug_error ("error: callback source needs ffmpeg avio\n");
+		goto exception;
+#endif
 	}
 	
 	if (formatContext->filesrc->type  == MM_FILE_SRC_TYPE_FILE) {
@@ -149,7 +352,7 @@ int mmfile_format_open_ffmpg (MMFileFormatContext *formatContext)
 		} else {
 HANDLING_DRM_DIVX:
 #ifdef __MMFILE_FFMPEG_V085__
-			ret = avformat_open_input(&pFormatCtx, formatContext->filesrc->file.path, NULL, NULL);
+			ret = _ffmpeg_open_io (&pFormatCtx, formatContext->uriFileName, formatContext->filesrc->file.path, NULL);
 #else
 			ret = av_open_input_file(&pFormatCtx, formatContext->filesrc->file.path, NULL, 0, NULL);
 #endif
@@ -206,9 +409,9 @@ HANDLING_DRM_DIVX:
 	#ifdef __MMFILE_TEST_MODE__
 	debug_msg ("format: %s (%s)\n", pFormatCtx->iformat->name, pFormatCtx->iformat->long_name);
 	#ifdef __MMFILE_FFMPEG_V085__
-	av_dump_format (pFormatCtx, 0, formatContext->filesrc->file.path, 0);
+	av_dump_format (pFormatCtx, 0, formatContext->uriFileName, 0);
 	#else
-	dump_format (pFormatCtx, 0, formatContext->filesrc->file.path, 0);
+	dump_format (pFormatCtx, 0, formatContext->uriFileName, 0);
 	#endif
 	#endif
 
@@ -242,13 +445,21 @@ int mmfile_format_read_stream_ffmpg (MMFileFormatContext * formatContext)
 	pFormatCtx = formatContext->privateFormatData;
 
 	/**
-	 *@important if data is corrupted, occur segment fault by av_find_stream_info().
-	 *			- fixed 2009-06-25.
+	 * av_find_stream_info() decodes packets of every stream.
+	 * skip it if the caller wants only the duration and the container header already has it.
 	 */
-	ret = av_find_stream_info (pFormatCtx);
-	if ( ret < 0 ) {
-		debug_warning ("failed to find stream info. errcode = %d\n", ret);
-		goto exception;
+	if ((formatContext->parseMask & ~MMFILE_PARSE_DURATION) || pFormatCtx->duration == AV_NOPTS_VALUE || pFormatCtx->duration <= 0) {
+		/**
+		 *@important if data is corrupted, occur segment fault by av_find_stream_info().
+		 *			- fixed 2009-06-25.
+		 */
+		ret = av_find_stream_info (pFormatCtx);
+		if ( ret < 0 ) {
+			debug_warning ("failed to find stream info. errcode = %d\n", ret);
+			/* interrupted by deadline, keep what the header gave */
+			if (mmfile_abort_check () != MMFILE_ABORT_EXPIRED)
+				goto exception;
+		}
 	}
 
 	#ifdef __MMFILE_TEST_MODE__
@@ -359,7 +570,7 @@ exception:
 	}
 
 	if (pFormatCtx) {
-		av_close_input_file (pFormatCtx);
+		_ffmpeg_close_input (pFormatCtx);
 		formatContext->privateFormatData = NULL;
 	}
 
@@ -546,7 +757,7 @@ int mmfile_format_read_frame_ffmpg  (MMFileFormatContext *formatContext, unsigne
 		/*set workaround bug flag*/
 		pVideoCodecCtx->workaround_bugs = FF_BUG_AUTODETECT;
 
-		ret = avcodec_open (pVideoCodecCtx, pVideoCodec);
+		ret = mmfile_format_codec_open_ffmpeg (pVideoCodecCtx, pVideoCodec);
 		if (ret < 0) {
 			debug_error ("error: avcodec_open fail.\n");
 			return MMFILE_FORMAT_FAIL;
@@ -609,7 +820,7 @@ int mmfile_format_read_frame_ffmpg  (MMFileFormatContext *formatContext, unsigne
 		}
 
 #ifdef __MMFILE_FFMPEG_V085__
-		static struct SwsContext *img_convert_ctx;
+		struct SwsContext *img_convert_ctx = NULL;
 
 		img_convert_ctx = sws_getContext (width, height, pVideoCodecCtx->pix_fmt,
 		                          width, height, PIX_FMT_RGB24, SWS_BICUBIC, NULL, NULL, NULL);
@@ -624,6 +835,7 @@ int mmfile_format_read_frame_ffmpg  (MMFileFormatContext *formatContext, unsigne
 		     0, height, pFrameRGB->data, pFrameRGB->linesize);
 		if ( ret < 0 ) {
 			debug_error ("failed to convet image\n");
+			sws_freeContext(img_convert_ctx);
 			ret = MMFILE_FORMAT_FAIL;
 			goto exception;
 		}
@@ -646,14 +858,14 @@ int mmfile_format_read_frame_ffmpg  (MMFileFormatContext *formatContext, unsigne
 		if (pFrame)			av_free (pFrame);
 		if (pFrameRGB)		av_free (pFrameRGB);
 
-		avcodec_close(pVideoCodecCtx);
+		mmfile_format_codec_close_ffmpeg (pVideoCodecCtx);
 
 		return MMFILE_FORMAT_SUCCESS;
 	}
 
 
 exception:
-	if (pVideoCodecCtx)		avcodec_close (pVideoCodecCtx);
+	if (pVideoCodecCtx)		mmfile_format_codec_close_ffmpeg (pVideoCodecCtx);
 	if (frame->frameData)	{ mmfile_free (frame->frameData); frame->frameData = NULL; }
 	if (pFrame)				av_free (pFrame);
 	if (pFrameRGB)			av_free (pFrameRGB);
@@ -668,7 +880,7 @@ int mmfile_format_close_ffmpg(MMFileFormatContext *formatContext)
 		AVFormatContext *pFormatCtx = formatContext->privateFormatData;
 
 		if (pFormatCtx) {
-			av_close_input_file (pFormatCtx);
+			_ffmpeg_close_input (pFormatCtx);
 			formatContext->privateFormatData = NULL;
 		}
 	}
@@ -965,6 +1177,12 @@ static int _get_first_good_video_frame (AVFormatContext *pFormatCtx, AVCodecCont
 			}
 		}
 		av_free_packet (&pkt);
+
+		if (mmfile_abort_check ()) {
+			debug_warning ("aborted while searching video frame\n");
+			found = 0;
+			break;
+		}
 	}
 
 	/*free pkt after loop breaking*/
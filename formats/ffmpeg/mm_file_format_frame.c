@@ -27,6 +27,7 @@
 #include "mm_file_formats.h"
 #include "mm_file_utils.h"
 #include "mm_file_format_frame.h"
+#include "mm_file_format_ffmpeg.h"
 
 #define MILLION 1000000
 
@@ -50,7 +51,7 @@ int mmfile_format_get_frame(const char* path, double timestamp, bool keyframe, u
 		return MMFILE_FORMAT_FAIL;
 	}
 
-	av_register_all();
+	mmfile_format_init_ffmpeg ();
 
 	/* Open video file */
 	if(avformat_open_input(&pFormatCtx, path, NULL, NULL) != 0) {
@@ -88,7 +89,7 @@ int mmfile_format_get_frame(const char* path, double timestamp, bool keyframe, u
 	}
 
 	/* Open codec */
-	if(avcodec_open(pVideoCodecCtx, pCodec) < 0) {
+	if(mmfile_format_codec_open_ffmpeg (pVideoCodecCtx, pCodec) < 0) {
 		debug_error("error : avcodec_open failed");
 		return MMFILE_FORMAT_FAIL; /*Could not open codec */
 	}
@@ -204,7 +205,7 @@ int mmfile_format_get_frame(const char* path, double timestamp, bool keyframe, u
 		}
 
 #ifdef __MMFILE_FFMPEG_V085__
-		static struct SwsContext *img_convert_ctx;
+		struct SwsContext *img_convert_ctx = NULL;
 
 		img_convert_ctx = sws_getContext (*width, *height, pVideoCodecCtx->pix_fmt,
 		                          *width, *height, PIX_FMT_RGB24, SWS_BICUBIC, NULL, NULL, NULL);
@@ -219,6 +220,7 @@ int mmfile_format_get_frame(const char* path, double timestamp, bool keyframe, u
 		     0, *height, pFrameRGB->data, pFrameRGB->linesize);
 		if ( ret < 0 ) {
 			debug_error ("failed to convet image\n");
+			sws_freeContext(img_convert_ctx);
 			ret = MMFILE_FORMAT_FAIL;
 			goto exception;
 		}
@@ -235,13 +237,13 @@ int mmfile_format_get_frame(const char* path, double timestamp, bool keyframe, u
 
 		if (pFrame)			av_free (pFrame);
 		if (pFrameRGB)		av_free (pFrameRGB);
-		if (pVideoCodecCtx)	avcodec_close(pVideoCodecCtx);
+		if (pVideoCodecCtx)	mmfile_format_codec_close_ffmpeg (pVideoCodecCtx);
 	}
 
 	return MMFILE_FORMAT_SUCCESS;
 
 exception:
-	if (pVideoCodecCtx)		avcodec_close (pVideoCodecCtx);
+	if (pVideoCodecCtx)		mmfile_format_codec_close_ffmpeg (pVideoCodecCtx);
 	if (*data)	{ mmfile_free (*data); *data = NULL; }
 	if (pFrame)				av_free (pFrame);
 	if (pFrameRGB)			av_free (pFrameRGB);
@@ -22,6 +22,7 @@
 #include <stdio.h>
 #include <string.h>	/*memcmp*/
 #include <stdlib.h>	/*malloc*/
+#include <pthread.h>
 
 #include "mm_debug.h"
 #include "mm_file_utils.h"
@@ -70,6 +71,9 @@ static	struct {
 	int duration_off;
 } noteData[AV_MIDI_NOTE_MAX];
 
+/*protects the converter tables above*/
+static pthread_mutex_t g_imy_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /*imelody key string (to validatation check)*/
 static const char *g_imy_key_str [] = {
 	"BEGIN:IMELODY",
@@ -81,12 +85,11 @@ static const char *g_imy_key_str [] = {
 
 
 static int				__is_good_imelody (unsigned char *src, unsigned int size);
-static unsigned char*	__get_load_memory (char *src, int *out_size);
 static unsigned char	__AvMIDISetVolume(char* pMelodyBuf);
 static int				__AvMIDISetBeat(char* pMelodyBuf);
 static char				__AvMIDISetStyle(char* pMelodyBuf);
 static unsigned char*	__AvConvertIMelody2MIDI(char* pMelodyBuf, unsigned int* pBufLen);
-static int				__get_imelody_tag (const char *uriname, tMMFileImelodyTagInfo *tags);
+static int				__get_imelody_tag (MMFileFormatContext *formatContext, tMMFileImelodyTagInfo *tags);
 
  
 /* interface functions */
@@ -99,16 +102,13 @@ int mmfile_format_close_imy       (MMFileFormatContext *formatContext);
 EXPORT_API
 int mmfile_format_open_imy (MMFileFormatContext *formatContext)
 {
-	int ret = 0;
-
 	if (!formatContext) {
 		debug_error("formatContext is NULL\n");
 		return MMFILE_FORMAT_FAIL;
 	}
 
 	if (formatContext->pre_checked == 0) {
-		ret = MMFileFormatIsValidIMY (formatContext->uriFileName);
-		if (ret == 0) {
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_IMELODY)) {
 			debug_error("It is not imelody file\n");
 			return MMFILE_FORMAT_FAIL;        
 		}
@@ -137,7 +137,6 @@ int mmfile_format_read_stream_imy (MMFileFormatContext *formatContext)
 	int				imy_size = 0;
 	unsigned char	*midi = NULL;
 	unsigned int	midi_size = 0;   
-    char			src2[MMFILE_URI_MAX_LEN];    
 
 	int ret = 0;
 
@@ -147,7 +146,7 @@ int mmfile_format_read_stream_imy (MMFileFormatContext *formatContext)
 	}
 
 	/*convert iMelody to Midi*/
-	imy = __get_load_memory (formatContext->uriFileName, &imy_size);
+	imy = mmfile_format_load_all (formatContext, &imy_size);
 	if (!imy) {
 		debug_error ("failed to load memory.\n");
 		goto exception;
@@ -157,18 +156,17 @@ int mmfile_format_read_stream_imy (MMFileFormatContext *formatContext)
 		debug_error ("it's broken file.\n");
 		goto exception;
 	}
+	/*converter works on static tables*/
+	pthread_mutex_lock (&g_imy_lock);
 	midi = __AvConvertIMelody2MIDI ((char *)imy, &midi_size);
+	pthread_mutex_unlock (&g_imy_lock);
 	if (!midi) {
 		debug_error ("failed to convert.");
 		goto exception;
 	}
 	
-	/*make uri*/
-	memset (src2, 0x00, MMFILE_URI_MAX_LEN);
-	sprintf (src2, "%s%u:%u", MMFILE_MEM_URI, (unsigned int)midi, midi_size);
-
 	/*get infomation*/
-	info = mmfile_format_get_midi_infomation (src2);
+	info = mmfile_format_get_midi_infomation_from_buffer (midi, midi_size);
 	if (!info) {
 		debug_error ("failed to get infomation");
 		goto exception;
@@ -235,7 +233,7 @@ int mmfile_format_read_tag_imy (MMFileFormatContext *formatContext)
 		return MMFILE_FORMAT_FAIL;
 	}
 
-	__get_imelody_tag (formatContext->uriFileName, &taginfo);    
+	__get_imelody_tag (formatContext, &taginfo);    
 
 	/**
 	 * UTF8 convert
@@ -314,20 +312,20 @@ int mmfile_format_close_imy (MMFileFormatContext *formatContext)
 	return MMFILE_FORMAT_SUCCESS;
 }
 
-static int __get_imelody_tag (const char *uriname, tMMFileImelodyTagInfo *tags)
+static int __get_imelody_tag (MMFileFormatContext *formatContext, tMMFileImelodyTagInfo *tags)
 {
 #define _MMFILE_IMY_TAG_BUFFER_LENGTH   512
 #define _MMFILE_IMY_HEADER_LENGTH       20
 #define _MMFILE_IMY_KEY_BUFFER_LENGTH   20
 #define _MMFILE_IMY_VALUE_BUFFER_LENGTH 128
 
-    MMFileIOHandle *fp = NULL;
     unsigned char buffer[_MMFILE_IMY_TAG_BUFFER_LENGTH] = {0,};
     int           readed = 0;
     long long     filesize = 0;
-    unsigned int  startoffset = 0;
-    unsigned int  endoffset = 0;
-    unsigned int  i = 0, j = 0;
+    long long     startoffset = 0;
+    long long     endoffset = 0;
+    long long     i = 0;
+    unsigned int  j = 0;
     char          imy_key_buffer[_MMFILE_IMY_KEY_BUFFER_LENGTH] = {0,};
     unsigned int  imy_key_buffer_index = 0;
     char          imy_value_buffer[_MMFILE_IMY_VALUE_BUFFER_LENGTH] = {0,};
@@ -337,28 +335,18 @@ static int __get_imelody_tag (const char *uriname, tMMFileImelodyTagInfo *tags)
    
     int ret = MMFILE_FORMAT_FAIL;
     
-    if (!uriname || !tags)
+    if (!formatContext || !tags)
     {
-        debug_error("uriname or tags is NULL\n");
+        debug_error("formatContext or tags is NULL\n");
         return MMFILE_FORMAT_FAIL;
     }
 
-    ret = mmfile_open (&fp, uriname, MMFILE_RDONLY);
-    if (ret == MMFILE_UTIL_FAIL) 
-    {
-        debug_error ( "open failed.\n");
-        return MMFILE_FORMAT_FAIL;
-    }
-
-    mmfile_seek (fp, 0, MMFILE_SEEK_END);
-    filesize = mmfile_tell (fp); 
-    mmfile_seek (fp, 0, MMFILE_SEEK_SET);
+    filesize = formatContext->fileSize;
     
     if (filesize < _MMFILE_IMY_HEADER_LENGTH)
     {
         debug_error ( "header is too small.\n");
-        ret = MMFILE_FORMAT_FAIL;
-        goto exit;
+        return MMFILE_FORMAT_FAIL;
     }
 
     /* set begin and end point at the file */
@@ -369,9 +357,8 @@ static int __get_imelody_tag (const char *uriname, tMMFileImelodyTagInfo *tags)
     isKeyBuffer = 1;
     while (i < endoffset)
     {
-        mmfile_seek (fp, i, MMFILE_SEEK_SET);
-        readed = mmfile_read (fp, buffer, _MMFILE_IMY_TAG_BUFFER_LENGTH);
-        if (readed < 0)
+        readed = mmfile_format_read_at (formatContext, i, buffer, _MMFILE_IMY_TAG_BUFFER_LENGTH);
+        if (readed <= 0)
         {
             debug_error ( "read error. size = %d. Maybe end of file.\n", readed);
             ret = 0;
@@ -442,61 +429,9 @@ static int __get_imelody_tag (const char *uriname, tMMFileImelodyTagInfo *tags)
         i = i + j;
     }
 
-exit:
-    mmfile_close (fp);
     return ret;    
 }
 
-static unsigned char *
-__get_load_memory (char *src, int *out_size)
-{
-	unsigned char			*buf = NULL;
-	MMFileIOHandle	*fp = NULL;
-	long long		src_size = 0L;
-	int				readed =0;
-	int				ret = 0;
-
-	/*open*/
-	ret = mmfile_open (&fp, src, MMFILE_RDONLY);
-	if (ret == MMFILE_UTIL_FAIL) {
-		debug_error ( "open failed.\n");
-		return NULL;
-	}
-
-	/*get file size*/
-	mmfile_seek (fp, 0L, MMFILE_SEEK_END);
-	src_size = mmfile_tell (fp);
-	mmfile_seek (fp, 0L, MMFILE_SEEK_SET);
-
-	if (src_size <= 0) {
-		debug_error ("failed to get file size.\n");
-		goto failed;
-	}
-
-	/*alloc read buffer*/
-	if ((buf = mmfile_malloc (src_size)) == NULL) {
-		debug_error ( "memory allocation failed.\n");
-		goto failed;
-	}
-
-	/*read data*/
-	if ((readed = mmfile_read (fp, buf, src_size) ) != src_size) {
-		debug_error ( "read error. size = %d\n", readed);
-		goto failed;
-	}
-
-	*out_size = (int)src_size;
-	mmfile_close (fp);
-
-	return buf;
-	
-failed:
-	if (buf) mmfile_free (buf);
-	if (fp) mmfile_close (fp);
-	return NULL;
-}
-
-
 static int
 __is_good_imelody (unsigned char *src, unsigned int size)
 {
@@ -22,6 +22,7 @@
 #include <string.h>	/*memcmp*/
 #include <stdio.h>
 #include <stdlib.h>	/*malloc*/
+#include <pthread.h>
 #include <mm_error.h>
 
 #include "mm_debug.h"
@@ -231,6 +232,7 @@ typedef	struct _tagMidGlobals
 /*---------------------------------------------------------------------------*/
 static PMIDGLOBAL			gpMidInfo;
 static PMIDINFO				gPi;
+static pthread_mutex_t		gMidLock = PTHREAD_MUTEX_INITIALIZER;	/*protects gpMidInfo, gPi*/
 
 
 static SINT32	__AvMidFile_Initialize		(void);
@@ -246,7 +248,7 @@ static SINT32	__AvMidGetLeastTimeTrack	(PMIDINFO pI);
 static SINT32	__AvGetSizeOfFileInfo		(PMIDINFO pI);
 static SINT32	__AvCheckSizeOfMidFile		(UINT8* fp, UINT32 dFsize);
 static int		__AvParseSkipXmf2Mid		(UINT8* pbFile, UINT32 dFSize);
-static int		__AvGetMidiDuration			(char* szFileName, MIDI_INFO_SIMPLE *info);
+static int		__AvGetMidiDuration			(UINT8 *pbFile, long long dFileSize, MIDI_INFO_SIMPLE *info);
 
 
 /* mm plugin interface */
@@ -258,16 +260,13 @@ int mmfile_format_close_mid       (MMFileFormatContext *formatContext);
 EXPORT_API
 int mmfile_format_open_mid (MMFileFormatContext *formatContext)
 {
-	int res = MMFILE_FORMAT_FAIL;
-
 	if (NULL == formatContext || NULL == formatContext->uriFileName) {
 		debug_error ("error: mmfile_format_open_mid\n");
 		return MMFILE_FORMAT_FAIL;
 	}
 
 	if (formatContext->pre_checked == 0) {
-		res = MMFileFormatIsValidMID (formatContext->uriFileName);
-		if ( res == 0 ) {
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_MID)) {
 			debug_error("It is not MIDI file\n");
 			return MMFILE_FORMAT_FAIL;
 		}
@@ -300,7 +299,7 @@ int mmfile_format_read_stream_mid (MMFileFormatContext *formatContext)
 	}
 
 	/*get infomation*/
-	info = mmfile_format_get_midi_infomation (formatContext->uriFileName);
+	info = mmfile_format_get_midi_infomation_from_context (formatContext);
 	if (!info) {
 		debug_error ("failed to get infomation");
 		goto exception;
@@ -359,7 +358,7 @@ int mmfile_format_read_tag_mid (MMFileFormatContext *formatContext)
 	}
 
 	/*get infomation*/
-	info = mmfile_format_get_midi_infomation (formatContext->uriFileName);
+	info = mmfile_format_get_midi_infomation_from_context (formatContext);
 	if (!info) {
 		debug_error ("failed to get infomation");
 		ret = MMFILE_FORMAT_FAIL;
@@ -467,17 +466,98 @@ static char * _lc_strdup (const char *str, unsigned int size)
 }
 
 MIDI_INFO_SIMPLE *
-mmfile_format_get_midi_infomation (char* szFileName)
+mmfile_format_get_midi_infomation_from_buffer (unsigned char *data, unsigned int size)
 {
 	int duration = -1;
 	MIDI_INFO_SIMPLE *info = NULL;
 
+	if (!data || size == 0)
+		return NULL;
+
 	info = mmfile_malloc (sizeof (MIDI_INFO_SIMPLE));
 	if (!info)
 		return NULL;
 
 	/*get infomation*/
-	duration = __AvGetMidiDuration (szFileName, info);
+	pthread_mutex_lock (&gMidLock);
+	duration = __AvGetMidiDuration (data, size, info);
+	pthread_mutex_unlock (&gMidLock);
+
+	return info;
+}
+
+MIDI_INFO_SIMPLE *
+mmfile_format_get_midi_infomation_from_context (MMFileFormatContext *formatContext)
+{
+	MIDI_INFO_SIMPLE *info = NULL;
+	const unsigned char *data = NULL;
+	int size = 0;
+
+	if (formatContext->fileSize <= 0 || formatContext->fileSize > 0x7FFFFFFF) {
+		debug_error ("invalid file size.\n");
+		return NULL;
+	}
+
+	/*the parser only reads, so the data is lent where possible*/
+	size = mmfile_format_peek (formatContext, 0, (int)formatContext->fileSize, &data);
+	if (size <= 0 || !data) {
+		debug_error ("failed to load midi data.\n");
+		return NULL;
+	}
+
+	info = mmfile_format_get_midi_infomation_from_buffer ((unsigned char *)data, size);
+
+	mmfile_format_peek_release (formatContext, data);
+
+	return info;
+}
+
+MIDI_INFO_SIMPLE *
+mmfile_format_get_midi_infomation (char* szFileName)
+{
+	MIDI_INFO_SIMPLE *info = NULL;
+	MMFileIOHandle *hFile = NULL;
+	UINT8 *pbFile = NULL;
+	long long dFileSize = 0;
+	int readed = 0;
+
+	if (szFileName == NULL)
+		return NULL;
+
+	/*open*/
+	if (mmfile_open (&hFile, szFileName, MMFILE_RDONLY) == MMFILE_UTIL_FAIL) {
+		debug_error ( "open failed.\n");
+		return NULL;
+	}
+
+	/*get file size*/
+	mmfile_seek (hFile, 0L, MMFILE_SEEK_END);
+	dFileSize = mmfile_tell (hFile);
+	mmfile_seek (hFile, 0L, MMFILE_SEEK_SET);
+
+	if (dFileSize <= 0 || dFileSize > 0x7FFFFFFF) {
+		debug_error ("failed to get file size or too large: %lld\n", dFileSize);
+		goto _RELEASE_RESOURCE;
+	}
+
+	/*alloc read buffer*/
+	pbFile = (UINT8 *) mmfile_malloc (sizeof(UINT8) * (dFileSize + 1));
+	if (!pbFile) {
+		debug_error ( "memory allocation failed.\n");
+		goto _RELEASE_RESOURCE;
+	}
+
+	/*read data*/
+	if ((readed = mmfile_read (hFile, pbFile, dFileSize) ) != dFileSize) {
+		debug_error ( "read error. size = %d\n", readed);
+		goto _RELEASE_RESOURCE;
+	}
+
+	info = mmfile_format_get_midi_infomation_from_buffer (pbFile, dFileSize);
+
+_RELEASE_RESOURCE:
+	mmfile_close (hFile);
+	mmfile_free (pbFile);
 
 	return info;
 }
@@ -500,7 +580,7 @@ mmfile_format_free_midi_infomation (MIDI_INFO_SIMPLE *info)
  */
 
 /****************************************************************************
- *	__AvGetMidiDuration(char* szFileName)
+ *	__AvGetMidiDuration(UINT8 *pbFile, long long dFileSize, MIDI_INFO_SIMPLE *info)
  *
  *	Desc.
  *		Load SMF data
@@ -514,55 +594,24 @@ mmfile_format_free_midi_infomation (MIDI_INFO_SIMPLE *info)
  *		>= 0 : FileID, < 0 : Error code
  ****************************************************************************/
 static int 
-__AvGetMidiDuration(char* szFileName, MIDI_INFO_SIMPLE *info)
+__AvGetMidiDuration(UINT8 *pbFile, long long dFileSize, MIDI_INFO_SIMPLE *info)
 {
 
 	int xmfheaderSkip=0;
-	MMFileIOHandle * hFile = NULL;
-	UINT8 * pbFile= NULL;
-	UINT8 * pIMYbuf= NULL;
-	SINT32 dFileSize;
 	int	sdCurrentTime = 0;
 	// void* pvExtArgs = "mid";
-	int readed =0;
-	int ret;
 	int codecType = AV_DEC_AUDIO_MIDI;
 	int is_xmf = 0;
 
-	if ( szFileName == NULL ||  info == NULL)
+	if ( pbFile == NULL || dFileSize < 8 ||  info == NULL)
 		return -1;
 
-	// printf ("URI: %s\n", szFileName);
-	/*open*/
-	ret = mmfile_open (&hFile, szFileName, MMFILE_RDONLY);
-	if (ret == MMFILE_UTIL_FAIL) {
-		debug_error ( "open failed.\n");
+	/*the SMF parser works with 32 bit offsets*/
+	if (dFileSize > 0x7FFFFFFF) {
+		debug_error ("too large midi data: %lld\n", dFileSize);
 		return -1;
 	}
 
-	/*get file size*/
-	mmfile_seek (hFile, 0L, MMFILE_SEEK_END);
-	dFileSize = mmfile_tell (hFile);
-	mmfile_seek (hFile, 0L, MMFILE_SEEK_SET);
-
-	if (dFileSize <= 0) {
-		debug_error ("failed to get file size.\n");
-		goto _RELEASE_RESOURCE;
-	}
-
-	/*alloc read buffer*/
-	pbFile = (UINT8 *) mmfile_malloc (sizeof(UINT8) * (dFileSize + 1));
-	if (!pbFile) {
-		debug_error ( "memory allocation failed.\n");
-		goto _RELEASE_RESOURCE;
-	}
-
-	/*read data*/
-	if ((readed = mmfile_read (hFile, pbFile, dFileSize) ) != dFileSize) {
-		debug_error ( "read error. size = %d\n", readed);
-		goto _RELEASE_RESOURCE;
-	}
-
 	/*init global workspace*/
 	if(__AvMidFile_Initialize())
 		goto _RELEASE_RESOURCE;
@@ -594,10 +643,10 @@ __AvGetMidiDuration(char* szFileName, MIDI_INFO_SIMPLE *info)
 		/*get duration. XMF/MIDI*/
 		if(codecType ==  AV_DEC_AUDIO_XMF) {
 			xmfheaderSkip = __AvParseSkipXmf2Mid(pbFile, dFileSize);
-			if(xmfheaderSkip == -1)
+			if(xmfheaderSkip == -1 || xmfheaderSkip >= dFileSize)
 				goto _RELEASE_RESOURCE;
 
-			sdCurrentTime = __AvCheckSizeOfMidFile(pbFile+xmfheaderSkip, dFileSize);
+			sdCurrentTime = __AvCheckSizeOfMidFile(pbFile+xmfheaderSkip, dFileSize - xmfheaderSkip);
 		} else {
 			sdCurrentTime = __AvCheckSizeOfMidFile(pbFile, dFileSize);
 		}
@@ -623,9 +672,6 @@ _RELEASE_RESOURCE:
 
 	/*resource release*/
 	__AvMidFile_Deinitialize ();
-	mmfile_close (hFile);
-	mmfile_free (pbFile);
-	mmfile_free (pIMYbuf);
 
 	return sdCurrentTime;
 }
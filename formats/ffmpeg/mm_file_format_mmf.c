@@ -21,6 +21,7 @@
 
 #include <string.h>	/*memcmp*/
 #include <stdlib.h>	/*malloc*/
+#include <pthread.h>
 
 #include "mm_debug.h"
 
@@ -564,6 +565,7 @@ typedef struct AvTagSmafInfo
 } SMAFINFO, *PSMAFINFO;
 
 static SMAFINFO g_sSmaf_Info;
+static pthread_mutex_t g_sSmaf_Lock = PTHREAD_MUTEX_INITIALIZER;	/*protects g_sSmaf_Info*/
 static const unsigned char g_abBitMaskTable1[8] = {0x01,	0x02,	0x04,	0x08,	0x10,	0x20,	0x40,	0x80};
 static const unsigned short g_awBitMaskTable2[8] = {0x00FF,	0x01FE, 0x03FC,	0x07F8,	0x0FF0,	0x1FE0,	0x3FC0,	0x7F80};
 static const unsigned char g_abTableA[16] = {0, 1, 1, 1, 1, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 15};
@@ -584,7 +586,7 @@ static const unsigned char g_abModulation2[16] = {0x80,0x00,0x08,0x10,0x18,0x20,
 
 
 /* internals */
-static int mmf_file_mmf_get_duration (char *src, int is_xmf);
+static int mmf_file_mmf_get_duration (MMFileFormatContext *formatContext, int is_xmf);
 
 
 
@@ -599,16 +601,13 @@ int mmfile_format_close_mmf       (MMFileFormatContext *formatContext);
 EXPORT_API
 int mmfile_format_open_mmf (MMFileFormatContext *formatContext)
 {   
-	int ret = 0;
-
 	if (NULL == formatContext) {
 		debug_error ("error: formatContext is NULL\n");
 		return MMFILE_FORMAT_FAIL;        
 	}
 
 	if (formatContext->pre_checked == 0) {
-		ret = MMFileFormatIsValidMMF (formatContext->uriFileName);
-		if (ret == 0) {
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_MMF)) {
 			debug_error ("error: it is not MMF file\n");
 			return MMFILE_FORMAT_FAIL;         
 		}
@@ -630,7 +629,9 @@ int mmfile_format_read_stream_mmf (MMFileFormatContext *formatContext)
 {
     int total = 0;
 
-    total = mmf_file_mmf_get_duration (formatContext->uriFileName, 0 /*not XMF*/);
+    pthread_mutex_lock (&g_sSmaf_Lock);
+    total = mmf_file_mmf_get_duration (formatContext, 0 /*not XMF*/);
+    pthread_mutex_unlock (&g_sSmaf_Lock);
     if ( total < 0 )
     {
         debug_error ("error: get duration\n");
@@ -2846,54 +2847,28 @@ _mmf_ParseSkipXmf2Mmf(unsigned char* pbFile, unsigned int dFSize)
 }
 
 static int
-mmf_file_mmf_get_duration (char *src, int is_xmf)
+mmf_file_mmf_get_duration (MMFileFormatContext *formatContext, int is_xmf)
 {
-	int				readed = 0;
 	int				xmf_skip_offset = 0;
-	MMFileIOHandle	*fp = NULL;
 	unsigned char	*buf = 0;
-	long long		src_size = 0L;
+	int				src_size = 0;
 
 	PLOADINFO		load_info;
 	unsigned char	*p_crc = NULL;
 	unsigned int		dCrc = 0;
-	int				ret = 0;
 
 	/*total time (millisecond)*/
 	int	ret_msec = 0;
 
 	debug_msg ( "\n");
 
-	/*open*/
-	ret = mmfile_open (&fp, src, MMFILE_RDONLY);
-	if (ret == MMFILE_UTIL_FAIL) 
-     {
-		debug_error ( "open failed.\n");
+	/*read data through the shared handle*/
+	buf = mmfile_format_load_all (formatContext, &src_size);
+	if (!buf) {
+		debug_error ( "failed to load data.\n");
 		return -1;
 	}
 
-	/*get file size*/
-	mmfile_seek (fp, 0L, MMFILE_SEEK_END);
-	src_size = mmfile_tell (fp);
-	mmfile_seek (fp, 0L, MMFILE_SEEK_SET);
-
-	if (src_size <= 0) {
-		debug_msg ( "failed to get file size.\n");
-		ret_msec = -1;
-		goto _RELEASE_RESOURCE;
-	}
-
-	/*alloc work buffer*/
-	buf = mmfile_malloc (src_size + 1);
-
-	/*read data*/
-	if ((readed = mmfile_read (fp, buf, src_size) ) <= 0 ) {
-		debug_error ( "read error. size = %d\n", readed);
-
-		ret_msec = -1;
-		goto _RELEASE_RESOURCE;
-	}
-
 	/*if XMF, get skip offset.*/
 	if (is_xmf) {
 		xmf_skip_offset = _mmf_ParseSkipXmf2Mmf (buf, src_size);
@@ -2925,8 +2900,6 @@ mmf_file_mmf_get_duration (char *src, int is_xmf)
 
 _RELEASE_RESOURCE:
 
-	mmfile_close (fp);
-
 	if (buf) mmfile_free (buf);
 
 	return ret_msec;
@@ -47,7 +47,6 @@
 
 
 static const unsigned char mp3FrameMasking[4] = {0xFF,0xFE,0x0C,0x00};
-static unsigned char mp3FrameDataValid[4];
 
 static const int mp3BitRateTable[2][3][16] = {
 	{	{0,32,64,96,128,160,192,224,256,288,320,352,384,416,448,},
@@ -65,11 +64,11 @@ static const int mp3SamRateTable[3][3] =
 	{11025, 12000, 8000} 
 };
 
-#define IS_VALID_FRAME_MP3(x) \
-  ((((x)[0] & mp3FrameMasking[0]) == mp3FrameDataValid[0]) && \
-   (((x)[1] & mp3FrameMasking[1]) == mp3FrameDataValid[1]) && \
-   (((x)[2] & mp3FrameMasking[2]) == mp3FrameDataValid[2]) && \
-   (((x)[3] & mp3FrameMasking[3]) == mp3FrameDataValid[3])) 
+#define IS_VALID_FRAME_MP3(info, x) \
+  ((((x)[0] & mp3FrameMasking[0]) == (info)->frameDataValid[0]) && \
+   (((x)[1] & mp3FrameMasking[1]) == (info)->frameDataValid[1]) && \
+   (((x)[2] & mp3FrameMasking[2]) == (info)->frameDataValid[2]) && \
+   (((x)[3] & mp3FrameMasking[3]) == (info)->frameDataValid[3])) 
 
 
 
@@ -80,7 +79,8 @@ int mmfile_format_read_tag_mp3    (MMFileFormatContext *formatContext);
 int mmfile_format_close_mp3       (MMFileFormatContext *formatContext);
 
 /* internal */
-static int mmf_file_mp3_get_infomation (char *src, AvFileContentInfo* pInfo );
+static int mmf_file_mp3_get_infomation (MMFileFormatContext *formatContext, AvFileContentInfo* pInfo );
+static int __AvReadTagV1 (MMFileFormatContext *formatContext, AvFileContentInfo* pInfo, unsigned char *tagBuff);
 
 EXPORT_API
 int mmfile_format_open_mp3 (MMFileFormatContext *formatContext)
@@ -97,8 +97,7 @@ int mmfile_format_open_mp3 (MMFileFormatContext *formatContext)
     }
 
 	if (formatContext->pre_checked == 0) {
-		ret = MMFileFormatIsValidMP3 (formatContext->uriFileName,5);
-		if ( ret == 0 )
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_MP3))
 		{
 			debug_error("It is not mp3 file\n");
 			return MMFILE_FORMAT_FAIL;        
@@ -123,7 +122,7 @@ int mmfile_format_open_mp3 (MMFileFormatContext *formatContext)
 
     formatContext->privateFormatData = privateData;
 
-    ret = mmf_file_mp3_get_infomation (formatContext->uriFileName, privateData);
+    ret = mmf_file_mp3_get_infomation (formatContext, privateData);
     if ( ret == -1 )
     {
         debug_error ("error: mmfile_format_read_stream_mp3\n");
@@ -196,6 +195,29 @@ int mmfile_format_read_tag_mp3    (MMFileFormatContext *formatContext)
 
     privateData = formatContext->privateFormatData;
 
+    /* frames are only indexed by the open, the tags are decoded once here */
+    if (!privateData->bTagDecoded)
+    {
+        unsigned char tagV1Buff[MP3TAGINFO_SIZE];
+        const unsigned char *tagV2Buff = NULL;
+
+        if (privateData->tagV2Info.frameNum > 0)
+        {
+            if (mmfile_format_peek (formatContext, 0, privateData->tagV2Info.indexedLen, &tagV2Buff) == (int)privateData->tagV2Info.indexedLen)
+                mm_file_id3tag_decode (privateData, tagV2Buff, AV_ID3V2_FRAME_ALL);
+            else
+                debug_error ("failed to read ID3v2 tag\n");
+
+            mmfile_format_peek_release (formatContext, tagV2Buff);
+        }
+
+        if (privateData->bV1tagFound && __AvReadTagV1 (formatContext, privateData, tagV1Buff) > 0)
+            mm_file_id3tag_parse_v110 (privateData, tagV1Buff);
+
+        mm_file_id3tag_restore_content_info (privateData);
+        privateData->bTagDecoded = true;
+    }
+
     if (privateData->pTitle)				formatContext->title = mmfile_strdup(privateData->pTitle);
     if (privateData->pArtist)				formatContext->artist = mmfile_strdup(privateData->pArtist);
     if (privateData->pAuthor)			formatContext->author = mmfile_strdup(privateData->pAuthor);
@@ -412,18 +434,18 @@ __AvIsValidHeader(AvFileContentInfo* pInfo, unsigned char *buf)
 
 	if (VALID_SYNC(buf))
 	{
-		mp3FrameDataValid[0] = (0xFF) & (mp3FrameMasking[0]);
-		mp3FrameDataValid[1] = (0xE0 | (buf[AV_MP3HDR_VERSION_OFS] & AV_MP3HDR_VERSION_M)
+		pInfo->frameDataValid[0] = (0xFF) & (mp3FrameMasking[0]);
+		pInfo->frameDataValid[1] = (0xE0 | (buf[AV_MP3HDR_VERSION_OFS] & AV_MP3HDR_VERSION_M)
 						| (buf[AV_MP3HDR_LAYER_OFS] & AV_MP3HDR_LAYER_M)) & (mp3FrameMasking[1]);
-		mp3FrameDataValid[2] = (buf[AV_MP3HDR_SAMPLERATE_OFS] & AV_MP3HDR_SAMPLERATE_M) &
+		pInfo->frameDataValid[2] = (buf[AV_MP3HDR_SAMPLERATE_OFS] & AV_MP3HDR_SAMPLERATE_M) &
 						(mp3FrameMasking[2]);
-		mp3FrameDataValid[3] = (buf[AV_MP3HDR_CHANNEL_OFS] & AV_MP3HDR_CHANNEL_M) &
+		pInfo->frameDataValid[3] = (buf[AV_MP3HDR_CHANNEL_OFS] & AV_MP3HDR_CHANNEL_M) &
 						(mp3FrameMasking[3]);
 
 		#ifdef __MMFILE_TEST_MODE__
 		debug_msg ("*** [%02x][%02x][%02x][%02x] : [%02x][%02x][%02x][%02x]",
 				buf[0], buf[1], buf[2],buf[3],
-				mp3FrameDataValid[0], mp3FrameDataValid[1], mp3FrameDataValid[2],mp3FrameDataValid[3]);
+				pInfo->frameDataValid[0], pInfo->frameDataValid[1], pInfo->frameDataValid[2],pInfo->frameDataValid[3]);
 		#endif
 
 		/*
@@ -775,6 +797,31 @@ __AvGetVBRIBitrate( AvFileContentInfo* pInfo )
 	return true;
 }
 
+/**
+ * Copies the ID3v1 tag found at the end of the file into @tagBuff.
+ * Returns 1 when found, 0 when there is none and -1 on read failure.
+ */
+static int __AvReadTagV1 (MMFileFormatContext *formatContext, AvFileContentInfo* pInfo, unsigned char *tagBuff)
+{
+	unsigned char	tailBuff[MP3TAGINFO_SIZE + TAGV1_SEEK_GAP];
+	unsigned char	TagV1ID[4] = { 0x54, 0x41, 0x47}; //TAG
+	int		tagHeaderPos = 0;
+
+	/*served from the cached tail*/
+	if (pInfo->fileLen < MP3TAGINFO_SIZE + TAGV1_SEEK_GAP)
+		return -1;
+
+	if (mmfile_format_read_at (formatContext, pInfo->fileLen - (MP3TAGINFO_SIZE + TAGV1_SEEK_GAP), tailBuff, MP3TAGINFO_SIZE + TAGV1_SEEK_GAP) <= 0)
+		return -1;
+
+	if ((tagHeaderPos = __AvMemstr(tailBuff, TagV1ID, 3, TAGV1_SEEK_GAP+5)) < 0)
+		return 0;
+
+	memcpy(tagBuff, (tailBuff + tagHeaderPos), MP3TAGINFO_SIZE);
+
+	return 1;
+}
+
 static int __AvGetLastID3offset (MMFileIOHandle *fp, unsigned int *offset)
 {
 #define _MMFILE_MP3_TAGV2_HEADER_LEN 10
@@ -790,11 +837,9 @@ static int __AvGetLastID3offset (MMFileIOHandle *fp, unsigned int *offset)
 	/*init offset*/
 	*offset = 0;
 
-	mmfile_seek(fp, 0, MMFILE_SEEK_SET);
-	
 _START_TAG_SEARCH:
 
-	readed = mmfile_read (fp, tagHeader, _MMFILE_MP3_TAGV2_HEADER_LEN);
+	readed = mmfile_pread (fp, tagHeader, _MMFILE_MP3_TAGV2_HEADER_LEN, acc_tagsize);
 	if (readed != _MMFILE_MP3_TAGV2_HEADER_LEN) {
 		debug_error ("read error occured.\n");
 		return 0;
@@ -842,7 +887,6 @@ _START_TAG_SEARCH:
 	debug_msg("tag size: %u, offset: %u\n", tagInfoSize, acc_tagsize);
 	#endif
 
-	mmfile_seek(fp, acc_tagsize, MMFILE_SEEK_SET);
 	*offset = acc_tagsize;
 	goto _START_TAG_SEARCH;
 
@@ -916,11 +960,7 @@ __AvFindStartOfMp3Header(MMFileIOHandle *hFile,  unsigned char *buf, AvFileConte
 
 		if(id3v2TagLen)
 		{
-			if (mmfile_seek (hFile, id3v2TagLen, SEEK_SET) < 0) {
-				debug_error ( "seek failed.\n");
-				return -1;
-			}
-			if ((readLen = mmfile_read (hFile, buf, bufLen)) <= 0) {
+			if ((readLen = mmfile_pread (hFile, buf, bufLen, id3v2TagLen)) <= 0) {
 				debug_error ( "seek failed.\n");
 				return -1;
 			}
@@ -1038,7 +1078,7 @@ __AvFindStartOfMp3Header(MMFileIOHandle *hFile,  unsigned char *buf, AvFileConte
 								{
 									if (VALID_SYNC(buf+nextFrameOff)) 
 									{
-										if(IS_VALID_FRAME_MP3(buf+nextFrameOff)) 
+										if(IS_VALID_FRAME_MP3(pInfo, buf+nextFrameOff)) 
 										{
 											bFoundSync = true;
 											break;
@@ -1078,10 +1118,6 @@ __AvFindStartOfMp3Header(MMFileIOHandle *hFile,  unsigned char *buf, AvFileConte
 
 	_FREE_EX (pHeader);
 
-	if (mmfile_seek(hFile, 0, SEEK_SET) < 0) {
-		debug_error ( "seek error!\n");
-		return -1;
-	}
 	if(index > (bufLen - minLen))
 	{
 		 debug_warning ( "Mp3 file sync is not found : index(%d) bufLen(%d), minLen(%d)\n", index, bufLen, minLen); 
@@ -1107,29 +1143,27 @@ __AvFindStartOfMp3Header(MMFileIOHandle *hFile,  unsigned char *buf, AvFileConte
 
 /*
  *	This function retrieves the mp3 information.
- *	Param	szFileName [in] Specifies a mp3 file path.
+ *	Param	formatContext [in] Specifies the format context holding the opened mp3 file.
  *	Param	_frame [out]	Specifies a struct pointer for mp3 information.
  *	This function returns true on success, or false on failure.
  */
-static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo )
+static int mmf_file_mp3_get_infomation (MMFileFormatContext *formatContext, AvFileContentInfo* pInfo )
 {
 	MMFileIOHandle	*hFile;
 	unsigned char	header[256];
-	unsigned long   numOfFrames=0;
+	unsigned long long	numOfFrames=0;
 	unsigned long   frameSamples=0;
 	unsigned char	*buf = NULL;	
 	unsigned char*	v2TagExistCheck = NULL;
 	unsigned int 		tempNumFrames = 0;
 	int 	readAmount = 0, readedDataLen = 0;
   	unsigned long long 	tempduration = 0;
-	unsigned char	TagBuff[MP3TAGINFO_SIZE + TAGV1_SEEK_GAP];
-	unsigned char		TagV1ID[4] = { 0x54, 0x41, 0x47}; //TAG
-	int		tagHeaderPos = 0;
+	unsigned char	TagBuff[MP3TAGINFO_SIZE];
 	int ret = 0;
 	unsigned int head_offset = 0;
 	debug_fenter();
 	
-	if (pInfo == NULL || filename == NULL)
+	if (pInfo == NULL || formatContext == NULL || formatContext->ioHandle == NULL)
 		return -1;
 
 	memset( pInfo, 0x00, sizeof(AvFileContentInfo) );
@@ -1138,22 +1172,14 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 	pInfo->headerPos = 0;
 	pInfo->genre = 148;
 
-	/*open*/
-	ret = mmfile_open (&hFile, filename, MMFILE_RDONLY);
-	if (ret == MMFILE_UTIL_FAIL) 
-	{
-		debug_error ( "open failed.\n");
-		return -1;
-	}
-
-	mmfile_seek (hFile, 0L, SEEK_END);
-	pInfo->fileLen = mmfile_tell (hFile);
+	/*opened and sized while probing*/
+	hFile = formatContext->ioHandle;
+	pInfo->fileLen = formatContext->fileSize;
 	if (pInfo->fileLen <= 0) 
 	{
 		debug_error ( "file is too small.\n");
 		goto EXCEPTION;
 	}
-	mmfile_seek (hFile, 0L, SEEK_SET);
 
 	v2TagExistCheck = mmfile_malloc (MP3_TAGv2_HEADER_LEN);
 	if (v2TagExistCheck == NULL) {
@@ -1161,7 +1187,7 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 		goto EXCEPTION;
 	}
 
-	if (mmfile_read (hFile, v2TagExistCheck, MP3_TAGv2_HEADER_LEN) > 0)
+	if (mmfile_format_read_at (formatContext, 0, v2TagExistCheck, MP3_TAGv2_HEADER_LEN) > 0)
 	{
 		if(IS_ID3V2_TAG(v2TagExistCheck))
 		{
@@ -1211,82 +1237,31 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 	if(!(pInfo->fileLen > pInfo->tagV2Info.tagLen ))
 		pInfo->tagV2Info.tagLen = 0;
 
-	if (mmfile_seek(hFile, 0L, SEEK_SET) < 0)
-		goto EXCEPTION;
-
 	#ifdef __MMFILE_TEST_MODE__
 	debug_msg ( "pInfo->fileLen(%lld)\n", pInfo->fileLen);
 	#endif
 
 	if(pInfo->fileLen > (_AV_MP3_HEADER_POSITION_MAX + pInfo->tagV2Info.tagLen))
-	{
 		readAmount = _AV_MP3_HEADER_POSITION_MAX + pInfo->tagV2Info.tagLen;
-		buf = mmfile_malloc (readAmount);
-		if (buf == NULL) {
-			debug_error ( "malloc failed.\n");
-			goto EXCEPTION;
-		}
-
-		while(readAmount > 0)
-		{
-			if(readAmount >= AV_MP3_HEADER_READ_MAX)
-			{
-				if ((readedDataLen <= _AV_MP3_HEADER_POSITION_MAX + pInfo->tagV2Info.tagLen)
-					&&(mmfile_read(hFile, buf+readedDataLen, AV_MP3_HEADER_READ_MAX) <= 0))
-				{
-					if(buf)
-						_FREE_EX(buf);
-					
-					goto EXCEPTION;
-				}
-				else
-				{
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "Reading buf readedDataLen(%d) readAmount (%d)\n", readedDataLen,readAmount);
-					#endif
-				}
-			}
-			else
-			{
-				if ((readedDataLen <= _AV_MP3_HEADER_POSITION_MAX + pInfo->tagV2Info.tagLen)
-					&&(mmfile_read(hFile, buf+readedDataLen, readAmount) <= 0))
-				{
-					if(buf)
-						_FREE_EX(buf);
-					
-					goto EXCEPTION;
-				}
-				else
-				{
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "The remained buf readed! readedDataLen(%d) readAmount (%d)\n", readedDataLen,readAmount);
-					#endif
-				}
-			}
-
-			readAmount -= AV_MP3_HEADER_READ_MAX;
-			readedDataLen += AV_MP3_HEADER_READ_MAX;
-			
-			if(readAmount <= 0)
-				break;
-		}
-	}
 	else
-	{
-		buf = mmfile_malloc (pInfo->fileLen);
-		if (buf == NULL)
-		{
-			 goto EXCEPTION;
-		}
+		readAmount = pInfo->fileLen;
 
-		if (mmfile_read(hFile, buf, pInfo->fileLen) <= 0)
-		{
-			if(buf)
-				_FREE_EX(buf);
-			goto EXCEPTION;
-		}
+	/*served from the cached head unless the ID3v2 tag is larger*/
+	buf = mmfile_malloc (readAmount);
+	if (buf == NULL) {
+		debug_error ( "malloc failed.\n");
+		goto EXCEPTION;
 	}
 
+	readedDataLen = mmfile_format_read_at (formatContext, 0, buf, readAmount);
+	if (readedDataLen <= 0)
+	{
+		_FREE_EX(buf);
+		goto EXCEPTION;
+	}
+	#ifdef __MMFILE_TEST_MODE__
+	debug_msg ( "Reading buf readedDataLen(%d) readAmount (%d)\n", readedDataLen,readAmount);
+	#endif
 	
 	if (__AvGetLastID3offset (hFile, &head_offset)) {
 		#ifdef __MMFILE_TEST_MODE__
@@ -1295,10 +1270,10 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 		pInfo->tagV2Info.tagLen = head_offset;
 	}
 	
-	pInfo->headerPos = (long) __AvFindStartOfMp3Header(hFile, buf, pInfo);
+	pInfo->headerPos = (long long) __AvFindStartOfMp3Header(hFile, buf, pInfo);
 
 	#ifdef __MMFILE_TEST_MODE__
-	debug_msg ( "Header Pos: %ld\n", pInfo->headerPos);
+	debug_msg ( "Header Pos: %lld\n", pInfo->headerPos);
 	#endif
 
 	if(buf)
@@ -1307,10 +1282,7 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 	if (pInfo->headerPos == -1)
 		goto EXCEPTION;
 
-	if (mmfile_seek(hFile, pInfo->headerPos, SEEK_SET) < 0)
-		goto EXCEPTION;
-
-	if (mmfile_read (hFile, header, 256) <= 0)
+	if (mmfile_format_read_at (formatContext, pInfo->headerPos, header, 256) <= 0)
 		goto EXCEPTION;
 
 	if ( __AvParseMp3Header( pInfo, header ) == false)
@@ -1329,34 +1301,26 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 		__AvGetMp3FrameSize( pInfo );
 		pInfo->datafileLen = pInfo->fileLen - pInfo->headerPos;
 		#ifdef __MMFILE_TEST_MODE__
-		debug_msg ( "Mp3 File FrameSize (%d) pInfo->headerPos(%d)\n", pInfo->frameSize,pInfo->headerPos);
+		debug_msg ( "Mp3 File FrameSize (%d) pInfo->headerPos(%lld)\n", pInfo->frameSize,pInfo->headerPos);
 		#endif
 	}
 
-	if (mmfile_seek (hFile, -(MP3TAGINFO_SIZE + TAGV1_SEEK_GAP), SEEK_END) < 0)
-		goto EXCEPTION;
-
-
 	pInfo ->bV1tagFound = false;
 
-	if (mmfile_read (hFile, TagBuff, MP3TAGINFO_SIZE + TAGV1_SEEK_GAP) <= 0)
+	/*only located here, it is parsed with the ID3v2 frames by the tag read*/
+	ret = __AvReadTagV1 (formatContext, pInfo, TagBuff);
+	if (ret < 0)
 		goto EXCEPTION;
 
-	if ((tagHeaderPos = __AvMemstr(TagBuff, TagV1ID, 3, TAGV1_SEEK_GAP+5)) >= 0)
+	if (ret > 0)
 	{
 		#ifdef __MMFILE_TEST_MODE__
 		debug_msg ( "Mp3 File Tag is existing\n");
 		#endif
 
 		pInfo ->bV1tagFound = true;
-		memcpy(TagBuff, (TagBuff + tagHeaderPos), MP3TAGINFO_SIZE);
-
-		if(!mm_file_id3tag_parse_v110(pInfo, TagBuff))
-			goto EXCEPTION;
 	}
 
-	mm_file_id3tag_restore_content_info (pInfo);
-
 	if(pInfo->bVbr) 
 		numOfFrames = pInfo->frameNum*10;
 	else
@@ -1401,8 +1365,6 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 		tempduration = (tempduration*frameSamples)/pInfo->sampleRate;
 
 	pInfo->duration = tempduration;
-
-	mmfile_close(hFile);
 	
 	/*debug print*/
 	#ifdef __MMFILE_TEST_MODE__
@@ -1444,6 +1406,5 @@ static int mmf_file_mp3_get_infomation (char *filename, AvFileContentInfo* pInfo
 
 EXCEPTION:
 	debug_error ("Error occured!\n");
-	mmfile_close(hFile);
 	return -1;
 }
@@ -179,7 +179,7 @@ typedef struct {
 
 
 /* internal */
-static unsigned char *mmf_file_wave_get_header (char *src);
+static unsigned char *mmf_file_wave_get_header (MMFileFormatContext *formatContext);
 static int mmf_file_wave_get_info (unsigned char *header, MM_FILE_WAVE_INFO *info);
 
 
@@ -193,16 +193,13 @@ int mmfile_format_close_wav       (MMFileFormatContext *formatContext);
 EXPORT_API
 int mmfile_format_open_wav (MMFileFormatContext *formatContext)
 {
-	int ret = 0;
-
 	if (NULL == formatContext) {
 		debug_error("formatContext is NULL\n");
 		return MMFILE_FORMAT_FAIL;
 	}
 
 	if (formatContext->pre_checked == 0) {
-		ret = MMFileFormatIsValidWAV (formatContext->uriFileName);
-		if ( ret == 0 )
+		if (!MMFILE_FORMAT_IS_PROBED (formatContext, MM_FILE_FORMAT_WAV))
 		{
 			debug_error("It is not wav file\n");
 			return MMFILE_FORMAT_FAIL;        
@@ -235,7 +232,7 @@ int mmfile_format_read_stream_wav (MMFileFormatContext *formatContext)
 		return MMFILE_FORMAT_FAIL;    
 	}
 
-	header = mmf_file_wave_get_header (formatContext->uriFileName);
+	header = mmf_file_wave_get_header (formatContext);
 	if (header == NULL) {
 		debug_error("error: mmf_file_wave_get_header\n");
 		goto exception;
@@ -349,39 +346,41 @@ _dump_codec_name (short codec)
 	return NULL;
 }
 
-static int _get_fmt_subchunk_offset (MMFileIOHandle *fp, long long limit, long long *offset)
+static int _get_fmt_subchunk_offset (MMFileFormatContext *formatContext, long long limit, long long *offset)
 {
-	long long fmt_offset;
+	long long fmt_offset = MMF_FILE_WAVE_CHUNK_LEN;
+	unsigned char *buf = NULL;
 	int readed;
 	int i;
-	unsigned char buf[4];
 
-	fmt_offset = mmfile_tell (fp);
-	if (fmt_offset < 0)
+	/*the whole search range is normally in the cached head*/
+	buf = mmfile_malloc (limit + 4);
+	if (!buf)
 		return 0;
 
-	for (i = 0; i < limit; i++) {
-		mmfile_seek (fp, fmt_offset + i, MMFILE_SEEK_SET);
-		readed = mmfile_read (fp, buf, 4);
-		if (readed != 4) {
-			debug_error ( "failed to read. size = %d\n", readed);
-			return 0;
-		}
-		
-		if (buf[0] == 'f' && buf[1] == 'm' && buf[2] == 't' && buf[3] == ' ') {
+	readed = mmfile_format_read_at (formatContext, fmt_offset, buf, limit + 4);
+	if (readed < 4) {
+		debug_error ( "failed to read. size = %d\n", readed);
+		mmfile_free (buf);
+		return 0;
+	}
+
+	for (i = 0; i + 4 <= readed; i++) {
+		if (buf[i] == 'f' && buf[i+1] == 'm' && buf[i+2] == 't' && buf[i+3] == ' ') {
 			*offset = fmt_offset + i;
+			mmfile_free (buf);
 			return 1;
 		}
 	}
-	
+
+	mmfile_free (buf);
 	return 0;
 }
 
 static unsigned char *
-mmf_file_wave_get_header (char *src)
+mmf_file_wave_get_header (MMFileFormatContext *formatContext)
 {
 	int				readed = 0;
-	MMFileIOHandle	*fp = NULL;
 	int				ret = 0;
 	long long		src_size = 0L;
 	unsigned char	*header = NULL;
@@ -392,18 +391,8 @@ mmf_file_wave_get_header (char *src)
 	if (!header)
 		return NULL;
 
-	/*open*/
-	ret = mmfile_open (&fp, src, MMFILE_RDONLY);
-	if (ret == MMFILE_UTIL_FAIL) {
-		debug_error ( "open failed.\n");
-		goto failed;
-	}
-
-
-	/*get file size*/
-	mmfile_seek (fp, 0L, MMFILE_SEEK_END);
-	src_size = mmfile_tell (fp);
-	mmfile_seek (fp, 0L, MMFILE_SEEK_SET);
+	/*opened and sized while probing*/
+	src_size = formatContext->fileSize;
 
 	if (src_size < MMF_FILE_WAVE_HEADER_LEN) {
 		debug_error ( "header is too small.\n");
@@ -411,7 +400,7 @@ mmf_file_wave_get_header (char *src)
 	}
 
 	/*read chunk data*/
-	readed = mmfile_read (fp, header, MMF_FILE_WAVE_CHUNK_LEN);
+	readed = mmfile_format_read_at (formatContext, 0, header, MMF_FILE_WAVE_CHUNK_LEN);
 	if (readed != MMF_FILE_WAVE_CHUNK_LEN) {
 		debug_error ( "read error. size = %d\n", readed);
 		goto failed;
@@ -419,7 +408,7 @@ mmf_file_wave_get_header (char *src)
 
 	/*seach 'fmt ' sub chunk*/
 	limit = (src_size - MMF_FILE_WAVE_HEADER_LEN > 10240 ? 10240 : src_size - MMF_FILE_WAVE_HEADER_LEN);
-	ret = _get_fmt_subchunk_offset (fp, limit, &offset);
+	ret = _get_fmt_subchunk_offset (formatContext, limit, &offset);
 	if (ret == 0) {
 		debug_error ( "failed to seach 'fmt ' chunk\n");
 		goto failed;
@@ -428,23 +417,18 @@ mmf_file_wave_get_header (char *src)
 	#ifdef __MMFILE_TEST_MODE__
 	debug_msg ("fmt offset: %lld\n", offset);
 	#endif
-	
-	mmfile_seek (fp, offset, MMFILE_SEEK_SET);
-	
+
 	/*read sub chunk data*/
-	readed = mmfile_read (fp, header + MMF_FILE_WAVE_CHUNK_LEN, MMF_FILE_WAVE_SUBCHUNK_LEN);
+	readed = mmfile_format_read_at (formatContext, offset, header + MMF_FILE_WAVE_CHUNK_LEN, MMF_FILE_WAVE_SUBCHUNK_LEN);
 	if (readed != MMF_FILE_WAVE_SUBCHUNK_LEN) {
 		debug_error ( "read error. size = %d\n", readed);
 		goto failed;
 	}
 
-	mmfile_close (fp);
-
 	return header;
 
 failed:
 	if (header) mmfile_free (header);
-	if (fp) mmfile_close (fp);
 
 	return NULL;
 }
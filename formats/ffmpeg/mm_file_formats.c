@@ -22,6 +22,9 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #ifdef DRM_SUPPORT
 #include <drm_client.h>
@@ -30,9 +33,11 @@
 
 #include "mm_debug.h"
 #include "mm_file_format_private.h"
+#include "mm_file_format_frame.h"
 #include "mm_file_utils.h"
 
 #define _MMF_FILE_FILEEXT_MAX 128
+#define ARRAY_SIZE(arr)		(sizeof(arr) / sizeof((arr)[0]))
 
 int (*MMFileOpenFunc[MM_FILE_FORMAT_NUM+1]) (MMFileFormatContext *fileContext) = {
 	mmfile_format_open_ffmpg,	/* 3GP */
@@ -62,6 +67,178 @@ int (*MMFileOpenFunc[MM_FILE_FORMAT_NUM+1]) (MMFileFormatContext *fileContext) =
 	NULL,
 };
 
+/**
+ * How each parser goes through the content, given to the source as a read
+ * ahead hint before the parser is opened. ffmpeg reads files on its own.
+ */
+static const int MMFileAccessPattern[MM_FILE_FORMAT_NUM+1] = {
+	MMFILE_ACCESS_NORMAL,		/* 3GP */
+	MMFILE_ACCESS_NORMAL,		/* ASF */
+	MMFILE_ACCESS_NORMAL,		/* AVI */
+	MMFILE_ACCESS_NORMAL,		/* MATROSAK */
+	MMFILE_ACCESS_NORMAL,		/* MP4 */
+	MMFILE_ACCESS_NORMAL,		/* OGG */
+	MMFILE_ACCESS_NORMAL,		/* NUT */
+	MMFILE_ACCESS_NORMAL,		/* QT */
+	MMFILE_ACCESS_NORMAL,		/* REAL */
+	MMFILE_ACCESS_SEQUENTIAL,	/* AMR, frame walk */
+	MMFILE_ACCESS_SEQUENTIAL,	/* AAC, frame walk */
+	MMFILE_ACCESS_SEQUENTIAL,	/* MP3, header search */
+	MMFILE_ACCESS_NORMAL,		/* AIFF */
+	MMFILE_ACCESS_NORMAL,		/* AU */
+	MMFILE_ACCESS_RANDOM,		/* WAV, chunk headers only */
+	MMFILE_ACCESS_SEQUENTIAL,	/* MID, whole file */
+	MMFILE_ACCESS_SEQUENTIAL,	/* MMF, whole file */
+	MMFILE_ACCESS_NORMAL,		/* DIVX */
+	MMFILE_ACCESS_NORMAL,		/* FLV */
+	MMFILE_ACCESS_NORMAL,		/* VOB */
+	MMFILE_ACCESS_SEQUENTIAL,	/* IMY, whole file */
+	MMFILE_ACCESS_NORMAL,		/* WMA */
+	MMFILE_ACCESS_NORMAL,		/* WMV */
+	MMFILE_ACCESS_NORMAL,		/* JPG */
+	MMFILE_ACCESS_NORMAL,
+};
+
+/**
+ * File extension hints. @probed is the probe result confirming the extension,
+ * a mismatch falls back to the probe with @format skipped.
+ * Memory sources give @format instead of a name, the first row of that format
+ * tells the probe result to check. @video marks containers which usually hold
+ * a video stream, see mmfile_format_is_video. New extensions only need a row here.
+ */
+typedef struct {
+	const char	*name;		/* lower case */
+	int			format;		/* MM_FILE_FORMAT_XXX reported for the file */
+	int			probed;		/* MM_FILE_FORMAT_XXX matched by the probe */
+	int			video;
+} MMFileExtEntry;
+
+static const MMFileExtEntry g_ext_table[] = {
+	{"mp4",		MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			1},
+	{"mpeg4",	MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			1},
+	{"m4a",		MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			0},
+	{"mpg",		MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			1},
+	{"mpg4",	MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			1},
+	{"m4v",		MM_FILE_FORMAT_MP4,			MM_FILE_FORMAT_3GP,			1},
+	{"3gp",		MM_FILE_FORMAT_3GP,			MM_FILE_FORMAT_3GP,			1},
+	{"3g2",		MM_FILE_FORMAT_3GP,			MM_FILE_FORMAT_3GP,			1},
+	{"k3g",		MM_FILE_FORMAT_3GP,			MM_FILE_FORMAT_3GP,			1},
+	{"skm",		MM_FILE_FORMAT_3GP,			MM_FILE_FORMAT_3GP,			1},
+	{"mov",		MM_FILE_FORMAT_QT,			MM_FILE_FORMAT_3GP,			1},
+	{"amr",		MM_FILE_FORMAT_AMR,			MM_FILE_FORMAT_AMR,			0},
+	{"awb",		MM_FILE_FORMAT_AMR,			MM_FILE_FORMAT_AMR,			0},
+	{"wav",		MM_FILE_FORMAT_WAV,			MM_FILE_FORMAT_WAV,			0},
+	{"mid",		MM_FILE_FORMAT_MID,			MM_FILE_FORMAT_MID,			0},
+	{"midi",	MM_FILE_FORMAT_MID,			MM_FILE_FORMAT_MID,			0},
+	{"spm",		MM_FILE_FORMAT_MID,			MM_FILE_FORMAT_MID,			0},
+	{"xmf",		MM_FILE_FORMAT_MID,			MM_FILE_FORMAT_MID,			0},
+	{"mxmf",	MM_FILE_FORMAT_MID,			MM_FILE_FORMAT_MID,			0},
+	{"mp3",		MM_FILE_FORMAT_MP3,			MM_FILE_FORMAT_MP3,			0},
+	{"aac",		MM_FILE_FORMAT_AAC,			MM_FILE_FORMAT_AAC,			0},
+	{"mmf",		MM_FILE_FORMAT_MMF,			MM_FILE_FORMAT_MMF,			0},
+	{"ma2",		MM_FILE_FORMAT_MMF,			MM_FILE_FORMAT_MMF,			0},
+	{"imy",		MM_FILE_FORMAT_IMELODY,		MM_FILE_FORMAT_IMELODY,		0},
+	{"avi",		MM_FILE_FORMAT_AVI,			MM_FILE_FORMAT_AVI,			1},
+	{"divx",	MM_FILE_FORMAT_DIVX,		MM_FILE_FORMAT_AVI,			1},
+	{"asf",		MM_FILE_FORMAT_ASF,			MM_FILE_FORMAT_ASF,			1},
+	{"asx",		MM_FILE_FORMAT_ASF,			MM_FILE_FORMAT_ASF,			0},
+	{"wma",		MM_FILE_FORMAT_WMA,			MM_FILE_FORMAT_ASF,			0},
+	{"wmv",		MM_FILE_FORMAT_WMV,			MM_FILE_FORMAT_ASF,			1},
+	{"ogg",		MM_FILE_FORMAT_OGG,			MM_FILE_FORMAT_OGG,			0},
+	{"opus",	MM_FILE_FORMAT_OGG,			MM_FILE_FORMAT_OGG,			0},
+	{"mkv",		MM_FILE_FORMAT_MATROSKA,	MM_FILE_FORMAT_MATROSKA,	1},
+	{"mka",		MM_FILE_FORMAT_MATROSKA,	MM_FILE_FORMAT_MATROSKA,	0},
+	{"webm",	MM_FILE_FORMAT_MATROSKA,	MM_FILE_FORMAT_MATROSKA,	1},
+};
+
+/**
+ * Perfect hash over g_ext_table. The seed is searched once so that every
+ * extension lands in its own slot, a lookup is then one hash and one compare.
+ */
+#define _MMF_EXT_HASH_SIZE		128		/*power of two*/
+#define _MMF_EXT_HASH_TRY_MAX	10000
+#define _MMF_EXT_HASH_EMPTY		0xFF
+
+static unsigned int g_ext_hash_seed = 0;
+static unsigned char g_ext_hash_slot[_MMF_EXT_HASH_SIZE];
+static int g_ext_hash_ready = 0;
+static pthread_once_t g_ext_hash_once = PTHREAD_ONCE_INIT;
+
+static unsigned int _HashExtension (const char *name, unsigned int seed)
+{
+	unsigned int hash = 2166136261U ^ seed;	/* FNV-1a */
+
+	while (*name) {
+		hash ^= (unsigned char) tolower ((unsigned char) *name++);
+		hash *= 16777619U;
+	}
+
+	return hash & (_MMF_EXT_HASH_SIZE - 1);
+}
+
+static void _BuildExtensionHash (void)
+{
+	unsigned int seed = 0;
+	unsigned int slot = 0;
+	unsigned int i = 0;
+
+	for (seed = 0; seed < _MMF_EXT_HASH_TRY_MAX; seed++) {
+		memset (g_ext_hash_slot, _MMF_EXT_HASH_EMPTY, sizeof (g_ext_hash_slot));
+
+		for (i = 0; i < ARRAY_SIZE (g_ext_table); i++) {
+			slot = _HashExtension (g_ext_table[i].name, seed);
+			if (g_ext_hash_slot[slot] != _MMF_EXT_HASH_EMPTY)
+				break;
+			g_ext_hash_slot[slot] = i;
+		}
+
+		if (i == ARRAY_SIZE (g_ext_table)) {
+			g_ext_hash_seed = seed;
+			g_ext_hash_ready = 1;
+			return;
+		}
+	}
+
+	debug_warning ("no perfect hash seed for the extension table, linear lookup\n");
+}
+
+static const MMFileExtEntry *_LookupExtension (const char *name)
+{
+	unsigned int slot = 0;
+	unsigned int i = 0;
+
+	if (!name || name[0] == '\0')
+		return NULL;
+
+	pthread_once (&g_ext_hash_once, _BuildExtensionHash);
+
+	if (g_ext_hash_ready) {
+		slot = g_ext_hash_slot[_HashExtension (name, g_ext_hash_seed)];
+		if (slot != _MMF_EXT_HASH_EMPTY && strcasecmp (name, g_ext_table[slot].name) == 0)
+			return &g_ext_table[slot];
+		return NULL;
+	}
+
+	for (i = 0; i < ARRAY_SIZE (g_ext_table); i++) {
+		if (strcasecmp (name, g_ext_table[i].name) == 0)
+			return &g_ext_table[i];
+	}
+
+	return NULL;
+}
+
+static const MMFileExtEntry *_LookupFormat (int format)
+{
+	unsigned int i = 0;
+
+	for (i = 0; i < ARRAY_SIZE (g_ext_table); i++) {
+		if (g_ext_table[i].format == format)
+			return &g_ext_table[i];
+	}
+
+	return NULL;
+}
+
 static int _CleanupFrameContext (MMFileFormatContext *formatContext)
 {
 	if (formatContext) {
@@ -129,14 +306,254 @@ static int _CleanupFrameContext (MMFileFormatContext *formatContext)
 	return MMFILE_FORMAT_SUCCESS;
 }
 
+/* formats sharing one header check */
+static int _GetFormatFamily (int format)
+{
+	switch (format) {
+		case MM_FILE_FORMAT_QT:
+		case MM_FILE_FORMAT_3GP:
+		case MM_FILE_FORMAT_MP4:
+			return MM_FILE_FORMAT_3GP;
+		case MM_FILE_FORMAT_ASF:
+		case MM_FILE_FORMAT_WMA:
+		case MM_FILE_FORMAT_WMV:
+			return MM_FILE_FORMAT_ASF;
+		case MM_FILE_FORMAT_DIVX:
+		case MM_FILE_FORMAT_AVI:
+			return MM_FILE_FORMAT_AVI;
+		default:
+			return format;
+	}
+}
+
+/**
+ * Opens the content once for the whole extraction, caches its head and tail
+ * and matches every known header against them. The handle and buffers are
+ * owned by the context and released by mmfile_format_close.
+ */
+static int _ProbeContent (MMFileFormatContext *formatContext, MMFileProbeResult *probe, int *count)
+{
+	int i = 0;
+
+	*count = 0;
+
+	if (mmfile_open (&formatContext->ioHandle, formatContext->uriFileName, MMFILE_RDONLY) == MMFILE_UTIL_FAIL) {
+		debug_error ("error: mmfile_open [%s]\n", formatContext->uriFileName);
+		formatContext->ioHandle = NULL;
+		return MMFILE_FORMAT_FAIL;
+	}
+
+	mmfile_seek (formatContext->ioHandle, 0L, MMFILE_SEEK_END);
+	formatContext->fileSize = mmfile_tell (formatContext->ioHandle);
+	mmfile_seek (formatContext->ioHandle, 0L, MMFILE_SEEK_SET);
+
+	if (formatContext->fileSize <= 0) {
+		debug_error ("error: empty content\n");
+		return MMFILE_FORMAT_FAIL;
+	}
+
+	/* no copy for mmap and memory sources */
+	formatContext->headSize = mmfile_peek (formatContext->ioHandle, 0, MMFILE_PROBE_HEAD_SIZE, &formatContext->headBuffer);
+	if (formatContext->headSize <= 0 || !formatContext->headBuffer) {
+		debug_error ("error: read head\n");
+		formatContext->headSize = 0;
+		return MMFILE_FORMAT_FAIL;
+	}
+
+	if (formatContext->fileSize > formatContext->headSize) {
+		formatContext->tailSize = (formatContext->fileSize - formatContext->headSize < MMFILE_PROBE_TAIL_SIZE) ?
+									(int)(formatContext->fileSize - formatContext->headSize) : MMFILE_PROBE_TAIL_SIZE;
+		formatContext->tailBuffer = mmfile_malloc (formatContext->tailSize);
+		if (formatContext->tailBuffer) {
+			mmfile_seek (formatContext->ioHandle, -formatContext->tailSize, MMFILE_SEEK_END);
+			formatContext->tailSize = mmfile_read (formatContext->ioHandle, formatContext->tailBuffer, formatContext->tailSize);
+		}
+		if (!formatContext->tailBuffer || formatContext->tailSize <= 0) {
+			mmfile_free (formatContext->tailBuffer);
+			formatContext->tailSize = 0;
+		}
+	}
+
+	*count = MMFileFormatProbeBuffer (formatContext->ioHandle, formatContext->fileSize,
+									formatContext->headBuffer, formatContext->headSize,
+									formatContext->tailBuffer, formatContext->tailSize,
+									probe, MMFILE_PROBE_RESULT_MAX);
+
+	formatContext->probedFormats = 0;
+	for (i = 0; i < *count; i++)
+		formatContext->probedFormats |= (1 << probe[i].format);
+
+	return MMFILE_FORMAT_SUCCESS;
+}
+
+static void _CloseContent (MMFileFormatContext *formatContext)
+{
+	if (formatContext->headBuffer) {
+		mmfile_peek_release (formatContext->ioHandle, formatContext->headBuffer);
+		formatContext->headBuffer = NULL;
+	}
+
+	if (formatContext->ioHandle) {
+		mmfile_close (formatContext->ioHandle);
+		formatContext->ioHandle = NULL;
+	}
+
+	if (formatContext->tailBuffer)	mmfile_free (formatContext->tailBuffer);
+
+	formatContext->headSize = 0;
+	formatContext->tailSize = 0;
+}
+
+/**
+ * Reads from the shared handle of the context, the cached head and tail
+ * are used when they hold the whole range.
+ */
+EXPORT_API
+int mmfile_format_read_at (MMFileFormatContext *formatContext, long long offset, unsigned char *buf, int size)
+{
+	long long tailOffset = 0;
+
+	if (!formatContext || !buf || size < 0 || offset < 0) {
+		debug_error ("error: invalid params\n");
+		return -1;
+	}
+
+	if (formatContext->headBuffer && offset + size <= formatContext->headSize) {
+		memcpy (buf, formatContext->headBuffer + offset, size);
+		return size;
+	}
+
+	tailOffset = formatContext->fileSize - formatContext->tailSize;
+	if (formatContext->tailBuffer && offset >= tailOffset && offset + size <= formatContext->fileSize) {
+		memcpy (buf, formatContext->tailBuffer + (offset - tailOffset), size);
+		return size;
+	}
+
+	if (!formatContext->ioHandle) {
+		debug_error ("error: no io handle\n");
+		return -1;
+	}
+
+	return mmfile_pread (formatContext->ioHandle, buf, size, offset);
+}
+
+/**
+ * Lends @size bytes at @offset from the cached head or a memory backed
+ * source, a copy is made otherwise. Returns the bytes available, the
+ * pointer goes back through mmfile_format_peek_release.
+ */
+EXPORT_API
+int mmfile_format_peek (MMFileFormatContext *formatContext, long long offset, int size, const unsigned char **ptr)
+{
+	if (!formatContext || !ptr || size < 0 || offset < 0) {
+		debug_error ("error: invalid params\n");
+		return -1;
+	}
+
+	*ptr = NULL;
+
+	if (formatContext->headBuffer && offset < formatContext->headSize &&
+		(offset + size <= formatContext->headSize || formatContext->headSize == formatContext->fileSize)) {
+		*ptr = formatContext->headBuffer + offset;
+		return (offset + size <= formatContext->headSize) ? size : (int)(formatContext->headSize - offset);
+	}
+
+	if (!formatContext->ioHandle) {
+		debug_error ("error: no io handle\n");
+		return -1;
+	}
+
+	return mmfile_peek (formatContext->ioHandle, offset, size, ptr);
+}
+
+EXPORT_API
+void mmfile_format_peek_release (MMFileFormatContext *formatContext, const unsigned char *ptr)
+{
+	if (!formatContext || !ptr)
+		return;
+
+	if (formatContext->headBuffer && ptr >= formatContext->headBuffer && ptr < formatContext->headBuffer + formatContext->headSize)
+		return;
+
+	mmfile_peek_release (formatContext->ioHandle, ptr);
+}
+
+/**
+ * Returns the whole content in a new buffer (one zeroed byte longer than
+ * @size), to be freed by the caller.
+ */
+EXPORT_API
+unsigned char *mmfile_format_load_all (MMFileFormatContext *formatContext, int *size)
+{
+	unsigned char *buf = NULL;
+	int readed = 0;
+
+	if (!formatContext || !size || formatContext->fileSize <= 0 || formatContext->fileSize > 0x7FFFFFFF) {
+		debug_error ("error: invalid params\n");
+		return NULL;
+	}
+
+	buf = mmfile_malloc (formatContext->fileSize + 1);
+	if (!buf) {
+		debug_error ("error: mmfile_malloc\n");
+		return NULL;
+	}
+
+	readed = mmfile_format_read_at (formatContext, 0, buf, (int)formatContext->fileSize);
+	if (readed != formatContext->fileSize) {
+		debug_error ("read error. size = %d\n", readed);
+		mmfile_free (buf);
+		return NULL;
+	}
+
+	*size = readed;
+
+	return buf;
+}
+
+/**
+ * Regular files are mapped, the parsers then peek into the mapping without
+ * copies. The mapping is windowed so the file size does not matter.
+ * Special files go through read().
+ */
+static const char *_SelectFileScheme (const char *fileName)
+{
+#ifdef __MMFILE_MMAP_MODE__
+	return MMFILE_MMAP_URI;
+#else
+	struct stat statbuf;
+
+	if (stat (fileName, &statbuf) < 0 || !S_ISREG (statbuf.st_mode))
+		return MMFILE_FILE_URI;
+
+	if (statbuf.st_size <= 0)
+		return MMFILE_FILE_URI;
+
+	return MMFILE_MMAP_URI;
+#endif
+}
+
+static void _AdviseAccess (MMFileFormatContext *formatContext, int format)
+{
+	if (!formatContext->ioHandle || format < 0 || format > MM_FILE_FORMAT_NUM)
+		return;
+
+	mmfile_advise (formatContext->ioHandle, MMFileAccessPattern[format]);
+}
+
 static int
-_PreprocessFile (MMFileSourceType *fileSrc, char **urifilename, int *formatEnum, int *isdrm)
+_PreprocessFile (MMFileFormatContext *formatContext, MMFileProbeResult *probe, int *count)
 {
+	MMFileSourceType *fileSrc = formatContext->filesrc;
+	char		**urifilename = &formatContext->uriFileName;
+	int			*formatEnum = &formatContext->formatType;
+	int			*isdrm = &formatContext->isdrm;
 	const char	*fileName = NULL;
 	char		extansion_name[_MMF_FILE_FILEEXT_MAX];
 	int			pos = 0;
 	int			filename_len = 0;
 	int			index = 0, skip_index = 0;
+	const MMFileExtEntry *ext = NULL;
 
 	if (fileSrc->type == MM_FILE_SRC_TYPE_FILE) {
 		fileName = (const char *)(fileSrc->file.path);
@@ -195,205 +612,51 @@ _PreprocessFile (MMFileSourceType *fileSrc, char **urifilename, int *formatEnum,
 		else 
 #endif // DRM_SUPPORT			
 		{
-			*isdrm = MM_FILE_DRM_NONE;
-#ifdef __MMFILE_MMAP_MODE__
-			*urifilename = mmfile_malloc (MMFILE_MMAP_URI_LEN + filename_len + 1);
-			if (!*urifilename) {
-				debug_error ("error: mmfile_malloc uriname\n");
-				return MMFILE_FORMAT_FAIL;
-			}
+			const char *scheme = _SelectFileScheme (fileName);
+			int scheme_len = strlen (scheme);
 
-			memset (*urifilename, 0x00, MMFILE_MMAP_URI_LEN + filename_len + 1);
-			strncpy (*urifilename, MMFILE_MMAP_URI, MMFILE_MMAP_URI_LEN);
-			strncat (*urifilename, fileName, filename_len);
-			(*urifilename)[MMFILE_MMAP_URI_LEN + filename_len] = '\0';
+			*isdrm = MM_FILE_DRM_NONE;
 
-#else
-			*urifilename = mmfile_malloc (MMFILE_FILE_URI_LEN + filename_len + 1);
+			*urifilename = mmfile_malloc (scheme_len + filename_len + 1);
 			if (!*urifilename) {
 				debug_error ("error: mmfile_malloc uriname\n");
 				return MMFILE_FORMAT_FAIL;
 			}
 
-			memset (*urifilename, 0x00, MMFILE_FILE_URI_LEN + filename_len + 1);
-			strncpy (*urifilename, MMFILE_FILE_URI, MMFILE_FILE_URI_LEN);
+			memset (*urifilename, 0x00, scheme_len + filename_len + 1);
+			strncpy (*urifilename, scheme, scheme_len);
 			strncat (*urifilename, fileName, filename_len);
-			(*urifilename)[MMFILE_FILE_URI_LEN + filename_len] = '\0';
-#endif
+			(*urifilename)[scheme_len + filename_len] = '\0';
 		}
 
 		///////////////////////////////////////////////////////////////////////
 		//                 Check File format                                 //
 		///////////////////////////////////////////////////////////////////////
 
+		if (MMFILE_FORMAT_SUCCESS != _ProbeContent (formatContext, probe, count)) {
+			return MMFILE_FORMAT_FAIL;
+		}
+
 		#ifdef __MMFILE_TEST_MODE__
 		debug_msg ("Get codec type of [%s].\n", extansion_name);
 		#endif
 
-		if (strcasecmp (extansion_name, "mp4") == 0   ||
-			strcasecmp (extansion_name, "mpeg4") == 0 ||
-			strcasecmp (extansion_name, "m4a") == 0   ||
-			strcasecmp (extansion_name, "mpg") == 0   ||
-			strcasecmp (extansion_name, "mpg4") == 0  ||
-			strcasecmp (extansion_name, "m4v") == 0 ) {
-
-			if (MMFileFormatIsValidMP4 (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_MP4;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MP4;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "3gp") == 0) {
-			if (MMFileFormatIsValidMP4 (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_3GP;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_3GP;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "amr") == 0 ||
-				   strcasecmp (extansion_name, "awb") == 0) {
-
-			if (MMFileFormatIsValidAMR (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_AMR;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_AMR;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "wav") == 0) {
-			if (MMFileFormatIsValidWAV (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_WAV;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_WAV;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "mid")  == 0 ||
-				   strcasecmp (extansion_name, "midi") == 0 ||
-				   strcasecmp (extansion_name, "spm")  == 0 ) {
-
-			if (MMFileFormatIsValidMID (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_MID;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MID;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "mp3") == 0) {
-			if (MMFileFormatIsValidMP3 (*urifilename,5)) {
-				*formatEnum = MM_FILE_FORMAT_MP3;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MP3;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "aac") == 0) {
-			if (MMFileFormatIsValidAAC (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_AAC;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_AAC;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "xmf") == 0 ||
-				 strcasecmp (extansion_name, "mxmf") == 0) {
-			if (MMFileFormatIsValidMID (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_MID;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MID;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (!strcasecmp (extansion_name, "mmf") ||
-				   !strcasecmp (extansion_name, "ma2")) {
-			if (MMFileFormatIsValidMMF (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_MMF;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MMF;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "imy") == 0) {
-			if (MMFileFormatIsValidIMY (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_IMELODY;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_IMELODY;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "avi") == 0) {
-			if (MMFileFormatIsValidAVI (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_AVI;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_AVI;
-			goto PROBE_PROPER_FILE_TYPE;
-		} else if (strcasecmp (extansion_name, "divx") == 0) {
-			if (MMFileFormatIsValidAVI (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_DIVX;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_DIVX;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "asf") == 0 ||
-				   strcasecmp (extansion_name, "asx") == 0 ) {
-			if (MMFileFormatIsValidASF (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_ASF;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_ASF;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "wma") == 0) {
-			if (MMFileFormatIsValidWMA (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_WMA;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_WMA;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "wmv") == 0) {
-			if (MMFileFormatIsValidWMV (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_WMV;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_WMV;
-			goto PROBE_PROPER_FILE_TYPE;
-
-		} else if (strcasecmp (extansion_name, "ogg") == 0) {
-			if (MMFileFormatIsValidOGG (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_OGG;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_OGG;
-			goto PROBE_PROPER_FILE_TYPE;
-		} else if (strcasecmp (extansion_name, "mkv") == 0 ||
-				   strcasecmp (extansion_name, "mka") == 0) {
-			if (MMFileFormatIsValidMatroska (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_MATROSKA;
-				return MMFILE_FORMAT_SUCCESS;
-			}
-			skip_index = MM_FILE_FORMAT_MATROSKA;
-			goto PROBE_PROPER_FILE_TYPE;
-		} else if (strcasecmp (extansion_name, "mov") == 0) {
-			if (MMFileFormatIsValidMP4 (*urifilename)) {
-				*formatEnum = MM_FILE_FORMAT_QT;
+		ext = _LookupExtension (extansion_name);
+		if (ext) {
+			if (MMFILE_FORMAT_IS_PROBED (formatContext, ext->probed)) {
+				*formatEnum = ext->format;
 				return MMFILE_FORMAT_SUCCESS;
 			}
-			skip_index = MM_FILE_FORMAT_QT;
-			goto PROBE_PROPER_FILE_TYPE;
+			skip_index = ext->format;
 		} else {
 			debug_warning ("probe file type=%s\n", fileName);
 			skip_index = -1;
-			goto PROBE_PROPER_FILE_TYPE;
 		}
+		goto PROBE_PROPER_FILE_TYPE;
 	} else if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) {
 		char tempURIBuffer[MMFILE_URI_MAX_LEN] = {0,};
 
-		sprintf (tempURIBuffer, "%s%u:%u", MMFILE_MEM_URI, (unsigned int)fileSrc->memory.ptr, fileSrc->memory.size);
+		snprintf (tempURIBuffer, MMFILE_URI_MAX_LEN, "%s%p:%u", MMFILE_MEM_URI, fileSrc->memory.ptr, fileSrc->memory.size);
 		*urifilename = mmfile_strdup (tempURIBuffer);
 		if (!*urifilename) {
 			debug_error ("error: uri is NULL\n");
@@ -404,319 +667,80 @@ _PreprocessFile (MMFileSourceType *fileSrc, char **urifilename, int *formatEnum,
 		debug_msg ("uri: %s\n", *urifilename);
 		#endif
 
-		switch (fileSrc->memory.format) {
-			case MM_FILE_FORMAT_3GP: {
-				if (MMFileFormatIsValidMP4 (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_3GP;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_3GP;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_MP4: {
-				if (MMFileFormatIsValidMP4 (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MP4;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_MP4;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_AMR: {
-				if (MMFileFormatIsValidAMR (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AMR;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_AMR;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_WAV: {
-				if (MMFileFormatIsValidWAV (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_WAV;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_WAV;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_MID: {
-				if (MMFileFormatIsValidMID (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MID;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_MID;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_MP3: {
-				if (MMFileFormatIsValidMP3 (*urifilename,5)) {
-					*formatEnum = MM_FILE_FORMAT_MP3;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_MP3;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_AAC: {
-				if (MMFileFormatIsValidAAC (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AAC;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_AAC;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_MMF: {
-				if (MMFileFormatIsValidMMF (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MMF;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_MMF;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_IMELODY: {
-				if (MMFileFormatIsValidIMY (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_IMELODY;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_IMELODY;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_AVI: {
-				if (MMFileFormatIsValidAVI (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AVI;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_AVI;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_DIVX: {
-				if (MMFileFormatIsValidAVI (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_DIVX;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_DIVX;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_ASF: {
-				if (MMFileFormatIsValidASF (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_ASF;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_ASF;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
-
-			case MM_FILE_FORMAT_WMA: {
-				if (MMFileFormatIsValidWMA (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_WMA;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_WMA;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
+		if (MMFILE_FORMAT_SUCCESS != _ProbeContent (formatContext, probe, count)) {
+			return MMFILE_FORMAT_FAIL;
+		}
 
-			case MM_FILE_FORMAT_WMV: {
-				if (MMFileFormatIsValidWMV (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_WMV;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_WMV;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
+		ext = _LookupFormat (fileSrc->memory.format);
+		if (ext) {
+			if (MMFILE_FORMAT_IS_PROBED (formatContext, ext->probed)) {
+				*formatEnum = ext->format;
+				return MMFILE_FORMAT_SUCCESS;
 			}
+			skip_index = ext->format;
+		} else {
+			debug_warning ("probe fileformat type=%d (%d: autoscan)\n", fileSrc->memory.format, MM_FILE_FORMAT_INVALID);
+			skip_index = -1;
+		}
+		goto PROBE_PROPER_FILE_TYPE;
+	} else if (fileSrc->type == MM_FILE_SRC_TYPE_CALLBACK) {
+		char tempURIBuffer[MMFILE_URI_MAX_LEN] = {0,};
 
-			case MM_FILE_FORMAT_OGG: {
-				if (MMFileFormatIsValidOGG (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_OGG;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				skip_index = MM_FILE_FORMAT_OGG;
-				goto PROBE_PROPER_FILE_TYPE;
-			}
+		/* the handler reads through the source itself */
+		snprintf (tempURIBuffer, MMFILE_URI_MAX_LEN, "%s%p", MMFILE_CALLBACK_URI, (void *)fileSrc);
+		*urifilename = mmfile_strdup (tempURIBuffer);
+		if (!*urifilename) {
+			debug_error ("error: uri is NULL\n");
+			return MMFILE_FORMAT_FAIL;
+		}
 
-			default: {
-				debug_warning ("probe fileformat type=%d (%d: autoscan)\n", fileSrc->memory.format, MM_FILE_FORMAT_INVALID);
-				skip_index = -1;
-				goto PROBE_PROPER_FILE_TYPE;
-				break;
-			}
+		if (MMFILE_FORMAT_SUCCESS != _ProbeContent (formatContext, probe, count)) {
+			return MMFILE_FORMAT_FAIL;
 		}
+
+		/* no name and no format hint, the content tells */
+		skip_index = -1;
+		goto PROBE_PROPER_FILE_TYPE;
 	} else {
-		debug_error ("error: invaild input type[memory|file]\n");
+		debug_error ("error: invaild input type[memory|file|callback]\n");
 		return MMFILE_FORMAT_FAIL;
 	}
 
 PROBE_PROPER_FILE_TYPE:
-	for (index = 0; index < MM_FILE_FORMAT_NUM; index++) {
-		if (index == skip_index)
-			continue;
-
-		debug_msg ("search index = [%d]\n", index);
-		switch (index) {
-		    case MM_FILE_FORMAT_QT:
-			case MM_FILE_FORMAT_3GP:
-			case MM_FILE_FORMAT_MP4: {
-				if (skip_index == MM_FILE_FORMAT_QT || skip_index == MM_FILE_FORMAT_3GP || skip_index == MM_FILE_FORMAT_MP4)
-					break;
-
-				if (MMFileFormatIsValidMP4 (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_3GP;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_3GP;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+	/* best match first */
+	for (index = 0; index < *count; index++) {
+		debug_msg ("probed format = [%d], score = [%d]\n", probe[index].format, probe[index].score);
 
-			case MM_FILE_FORMAT_ASF:
-			case MM_FILE_FORMAT_WMA:
-			case MM_FILE_FORMAT_WMV: {
-				if (skip_index == MM_FILE_FORMAT_ASF || skip_index == MM_FILE_FORMAT_WMA || skip_index == MM_FILE_FORMAT_WMV)
-					break;
-
-				if (MMFileFormatIsValidASF (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_ASF;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_ASF;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
-
-			case MM_FILE_FORMAT_DIVX:
-			case MM_FILE_FORMAT_AVI: {
-				if (skip_index == MM_FILE_FORMAT_DIVX || skip_index == MM_FILE_FORMAT_AVI)
-					break;
-
-				if (MMFileFormatIsValidAVI(*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AVI;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_AVI;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
-
-			case MM_FILE_FORMAT_OGG: {
-				if (MMFileFormatIsValidOGG (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_OGG;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_OGG;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
-
-			case MM_FILE_FORMAT_AMR: {
-				if (MMFileFormatIsValidAMR (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AMR;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_AMR;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
-
-			case MM_FILE_FORMAT_AAC: {
-				if (MMFileFormatIsValidAAC (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_AAC;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_AAC;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+		/* too weak without a matching extension */
+		if (probe[index].score <= MMFILE_PROBE_SCORE_WEAK)
+			continue;
 
-			case MM_FILE_FORMAT_MP3: {
-				if (MMFileFormatIsValidMP3 (*urifilename,50)) {
-					*formatEnum = MM_FILE_FORMAT_MP3;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_MP3;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+		/* already tried by the file extension */
+		if (skip_index >= 0 && _GetFormatFamily (probe[index].format) == _GetFormatFamily (skip_index))
+			continue;
 
-			case MM_FILE_FORMAT_WAV: {
-				if (MMFileFormatIsValidWAV (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_WAV;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_WAV;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+		*formatEnum = probe[index].format;
+		if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = probe[index].format;
+		return MMFILE_FORMAT_SUCCESS;
+	}
 
-			case MM_FILE_FORMAT_MID: {
-				if (MMFileFormatIsValidMID (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MID;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_MID;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+	debug_error("Can't probe file type\n");
 
-			case MM_FILE_FORMAT_MMF: {
-				if (MMFileFormatIsValidMMF (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MMF;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_MMF;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+	*formatEnum = -1;
+	return MMFILE_FORMAT_FAIL;
 
-			case MM_FILE_FORMAT_IMELODY: {
-				if (MMFileFormatIsValidIMY (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_IMELODY;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_IMELODY;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+}
 
-			case MM_FILE_FORMAT_MATROSKA: {
-				if (MMFileFormatIsValidMatroska (*urifilename)) {
-					*formatEnum = MM_FILE_FORMAT_MATROSKA;
-					if (fileSrc->type == MM_FILE_SRC_TYPE_MEMORY) fileSrc->memory.format = MM_FILE_FORMAT_MATROSKA;
-					return MMFILE_FORMAT_SUCCESS;
-				}
-				break;
-			}
+static int _IsHandlerTried (int (**tried) (MMFileFormatContext *), int count, int (*handler) (MMFileFormatContext *))
+{
+	int i = 0;
 
-			/* not supported file */
-			case MM_FILE_FORMAT_NUT:
-			case MM_FILE_FORMAT_REAL:
-			case MM_FILE_FORMAT_AIFF:
-			case MM_FILE_FORMAT_AU:
-			case MM_FILE_FORMAT_FLV:
-			case MM_FILE_FORMAT_VOB:
-			case MM_FILE_FORMAT_JPG:
-				break;
-			default: {
-				debug_error ("error: invaild format enum[%d]\n", index);
-				break;
-			}
-		}
+	for (i = 0; i < count; i++) {
+		if (tried[i] == handler)
+			return 1;
 	}
 
-	if (index == MM_FILE_FORMAT_NUM)
-		debug_error("Can't probe file type\n");
-
-	*formatEnum = -1;
-	return MMFILE_FORMAT_FAIL;
-
+	return 0;
 }
 
 static int _mmfile_format_close (MMFileFormatContext *formatContext)
@@ -736,6 +760,8 @@ static int _mmfile_format_close (MMFileFormatContext *formatContext)
 	if (formatContext->ReadTag)		formatContext->ReadTag		= NULL;
 	if (formatContext->Close)		formatContext->Close		= NULL;
 
+	_CloseContent (formatContext);
+
 	if (formatContext->uriFileName)		mmfile_free(formatContext->uriFileName);
 	if (formatContext->title)			mmfile_free(formatContext->title);
 	if (formatContext->artist)			mmfile_free(formatContext->artist);
@@ -785,6 +811,11 @@ int mmfile_format_open (MMFileFormatContext **formatContext, MMFileSourceType *f
 {
 	int index = 0;
 	int ret = 0;
+	int count = 0;
+	int format = 0;
+	int triedCount = 0;
+	MMFileProbeResult probe[MMFILE_PROBE_RESULT_MAX];
+	int (*tried[MMFILE_PROBE_RESULT_MAX+1]) (MMFileFormatContext *);
 	MMFileFormatContext *formatObject = NULL;
 
 	if (NULL == fileSrc) {
@@ -808,11 +839,12 @@ int mmfile_format_open (MMFileFormatContext **formatContext, MMFileSourceType *f
 	formatObject->filesrc = fileSrc;
 
 	formatObject->pre_checked = 0;	/*not yet format checked.*/
+	formatObject->parseMask = MMFILE_PARSE_ALL;
 
 	/**
 	 * Format detect and validation check.
 	 */
-	ret = _PreprocessFile (fileSrc, &formatObject->uriFileName,  &formatObject->formatType, &formatObject->isdrm);
+	ret = _PreprocessFile (formatObject, probe, &count);
 	if (MMFILE_FORMAT_SUCCESS != ret) {
 		debug_error ("error: _PreprocessFile fail\n");
 		ret = MMFILE_FORMAT_FAIL;
@@ -821,6 +853,12 @@ int mmfile_format_open (MMFileFormatContext **formatContext, MMFileSourceType *f
 
 	formatObject->pre_checked = 1;	/*already file format checked.*/
 
+	if (mmfile_abort_check ()) {
+		debug_warning ("aborted after probing\n");
+		ret = MMFILE_FORMAT_FAIL;
+		goto exception;
+	}
+
 	/**
 	 * Open format function.
 	 */
@@ -830,6 +868,8 @@ int mmfile_format_open (MMFileFormatContext **formatContext, MMFileSourceType *f
 		goto find_valid_handler;
 	}
 
+	_AdviseAccess (formatObject, formatObject->formatType);
+
 	ret = MMFileOpenFunc[formatObject->formatType] (formatObject);
 	if (MMFILE_FORMAT_FAIL == ret) {
 		debug_error ("error: Try other formats\n");
@@ -841,39 +881,70 @@ int mmfile_format_open (MMFileFormatContext **formatContext, MMFileSourceType *f
 	return MMFILE_FORMAT_SUCCESS;
 
 find_valid_handler:
+	/**
+	 * Walk the probe results by descending score, the probe already matched
+	 * their headers so each handler is opened at most once.
+	 */
+	tried[triedCount++] = MMFileOpenFunc[formatObject->formatType];
+
+	for (index = 0; index < count; index++) {
+		if (mmfile_abort_check ()) {
+			debug_warning ("aborted while finding format handler\n");
+			ret = MMFILE_FORMAT_FAIL;
+			goto exception;
+		}
+
+		format = probe[index].format;
+		if (NULL == MMFileOpenFunc[format] || _IsHandlerTried (tried, triedCount, MMFileOpenFunc[format]))
+			continue;
+
+		tried[triedCount++] = MMFileOpenFunc[format];
+
+		debug_msg ("try probed format = [%d], score = [%d]\n", format, probe[index].score);
+
+		formatObject->formatType = format;
+		_AdviseAccess (formatObject, format);
+		ret = MMFileOpenFunc[format] (formatObject);
+		if (MMFILE_FORMAT_FAIL == ret) {
+			_CleanupFrameContext (formatObject);
+			continue;
+		}
+
+		*formatContext = formatObject;
+		return MMFILE_FORMAT_SUCCESS;
+	}
+
+	/**
+	 * No known header, only handlers doing their own probing are left.
+	 * Native parsers fail at once on the probe mask here.
+	 */
 	formatObject->pre_checked = 0;	/*do check file format*/
 
 	for (index = 0; index < MM_FILE_FORMAT_NUM+1; index++) {
-		if (NULL == MMFileOpenFunc[index]) {
-			debug_error ("error: Not implemented \n");
+		if (mmfile_abort_check ()) {
+			debug_warning ("aborted while finding format handler\n");
 			ret = MMFILE_FORMAT_FAIL;
-			continue;
+			goto exception;
 		}
 
-		if (formatObject->formatType == index)
+		if (NULL == MMFileOpenFunc[index] || _IsHandlerTried (tried, triedCount, MMFileOpenFunc[index]))
 			continue;
 
+		_AdviseAccess (formatObject, index);
 		ret = MMFileOpenFunc[index] (formatObject);
 		if (MMFILE_FORMAT_FAIL == ret) {
 			_CleanupFrameContext (formatObject);
 			continue;
 		}
 
-		break;
-	}
-
-	formatObject->formatType = index;
+		formatObject->formatType = index;
+		*formatContext = formatObject;
 
-	if (index == MM_FILE_FORMAT_NUM + 1 && MMFILE_FORMAT_FAIL == ret) {
-		debug_error ("can't find file format handler\n");
-		ret = MMFILE_FORMAT_FAIL;
-		goto exception;
+		return MMFILE_FORMAT_SUCCESS;
 	}
 
-	formatObject->formatType = index;
-	*formatContext = formatObject;
-
-	return MMFILE_FORMAT_SUCCESS;
+	debug_error ("can't find file format handler\n");
+	ret = MMFILE_FORMAT_FAIL;
 
 exception:
 	_mmfile_format_close (formatObject);
@@ -934,6 +1005,8 @@ int mmfile_format_close (MMFileFormatContext *formatContext)
 	if (formatContext->ReadTag)		formatContext->ReadTag		= NULL;
 	if (formatContext->Close)		formatContext->Close		= NULL;
 
+	_CloseContent (formatContext);
+
 	if (formatContext->uriFileName)		mmfile_free(formatContext->uriFileName);
 
 	if (formatContext->title)			mmfile_free(formatContext->title);
@@ -979,3 +1052,35 @@ int mmfile_format_close (MMFileFormatContext *formatContext)
 	return MMFILE_FORMAT_SUCCESS;
 }
 
+/**
+ * Tells from the file name alone, without any I/O, if the file is a container
+ * which usually holds a video stream. Unknown extensions are not video.
+ */
+EXPORT_API
+int mmfile_format_is_video (const char *path)
+{
+	const MMFileExtEntry *ext = NULL;
+	const char *dot = NULL;
+
+	if (!path)
+		return 0;
+
+	dot = strrchr (path, '.');
+	if (!dot)
+		return 0;
+
+	ext = _LookupExtension (dot + 1);
+
+	return ext ? ext->video : 0;
+}
+
+EXPORT_API
+const MMFileFormatFuncs mmfile_format_funcs = {
+	mmfile_format_open,
+	mmfile_format_read_stream,
+	mmfile_format_read_frame,
+	mmfile_format_read_tag,
+	mmfile_format_close,
+	mmfile_format_get_frame,
+	mmfile_format_is_video,
+};
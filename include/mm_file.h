@@ -44,6 +44,14 @@
 	This part describes the APIs with respect to extract meta data or media
 	information directly from file.
 
+	@par
+	All functions can be called from several threads at the same time on different
+	files. Each call resolves its own reference to the format and codec libraries, so
+	no global dispatch state is shared between callers. An attribute handle or a session
+	handle must not be used by two threads at the same time.
+	Opening and closing of ffmpeg codecs is serialized inside this library; no ffmpeg lock
+	manager is registered, the one of the application, if any, is left in place.
+
 */
 
 #ifdef __cplusplus
@@ -69,6 +77,18 @@ extern "C" {
 #define MM_FILE_CONTENT_AUDIO_SAMPLERATE	"content-audio-samplerate" /**< Sampling rate of audio stream */
 #define MM_FILE_CONTENT_AUDIO_TRACK_INDEX	"content-audio-track-index"	/**< Current stream of audio */
 #define MM_FILE_CONTENT_AUDIO_TRACK_COUNT	"content-audio-track-count"/**< Number of audio streams */
+#define MM_FILE_CONTENT_INCOMPLETE			"content-incomplete"		/**< 1 if extraction stopped at the deadline */
+
+/**
+ * content attribute request mask, see mm_file_create_content_attrs_ex().
+ * Track counts are always filled.
+ */
+#define MM_FILE_WANT_DURATION			0x0001	/**< MM_FILE_CONTENT_DURATION */
+#define MM_FILE_WANT_VIDEO_CODEC		0x0002	/**< MM_FILE_CONTENT_VIDEO_CODEC, BITRATE and FPS */
+#define MM_FILE_WANT_VIDEO_SIZE			0x0004	/**< MM_FILE_CONTENT_VIDEO_WIDTH and HEIGHT */
+#define MM_FILE_WANT_AUDIO_CODEC		0x0008	/**< MM_FILE_CONTENT_AUDIO_CODEC, BITRATE, CHANNELS and SAMPLERATE */
+#define MM_FILE_WANT_THUMBNAIL			0x0010	/**< MM_FILE_CONTENT_VIDEO_THUMBNAIL */
+#define MM_FILE_WANT_ALL				0x001F	/**< Same as mm_file_create_content_attrs() */
 
 /**
  * tag attributes.
@@ -489,6 +509,44 @@ mm_file_destroy_content_attrs(content_attrs);
    */
 int mm_file_create_content_attrs_from_memory(MMHandleType *content_attrs, const void *data, unsigned int size, int format);
 
+/**
+ * I/O callbacks of media data kept by the caller, see mm_file_create_content_attrs_from_callbacks().
+ * The callbacks are called from the thread of the extraction, only while it runs.
+ */
+typedef struct {
+	int (*read) (void *user_data, unsigned char *buf, int size);			/**< Returns bytes read, 0 at end of data, negative on error */
+	long long (*seek) (void *user_data, long long offset, int whence);	/**< SEEK_SET, SEEK_CUR or SEEK_END. Returns the new position, negative on error */
+	long long (*size) (void *user_data);								/**< Returns the data size. Optional, seek to SEEK_END is used when NULL */
+} MMFileIOCallbacks;
+
+/**
+ * This function is to get the tag attributes from media data read through callbacks.<BR>
+ * This function acts same functionality as mm_file_create_tag_attrs() except media source format.
+ *
+ * @param	tag_attrs	[out]	tag attributes handle.
+ * @param	callbacks	[in]	I/O callbacks, read and seek are mandatory.
+ * @param	user_data	[in]	user data passed to callbacks.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The format is detected from the data.
+ * @see		mm_file_destroy_tag_attrs
+ */
+int mm_file_create_tag_attrs_from_callbacks(MMHandleType *tag_attrs, const MMFileIOCallbacks *callbacks, void *user_data);
+
+/**
+ * This function is to get the content attributes from media data read through callbacks.<BR>
+ * Large content such as an encrypted container or a blob store entry is parsed without being copied into memory.
+ *
+ * @param	content_attrs	[out]	content attributes handle.
+ * @param	callbacks	[in]	I/O callbacks, read and seek are mandatory.
+ * @param	user_data	[in]	user data passed to callbacks.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The format is detected from the data.
+ * @see		mm_file_destroy_content_attrs
+ */
+int mm_file_create_content_attrs_from_callbacks(MMHandleType *content_attrs, const MMFileIOCallbacks *callbacks, void *user_data);
+
 /**
  * This function is to get the count of audio/video stream from media file.<BR>
  * This function is useful for determining whether content is audio or video file.<BR>
@@ -550,10 +608,428 @@ mm_file_destroy_content_attrs(content_attrs);
    */
 int mm_file_create_content_attrs_simple(MMHandleType *content_attrs, const char *filename);
 
+/**
+ * This function is to create content attribute with only the attributes the caller asks for.<BR>
+ * Parsing stages which are not needed by mask are skipped, e.g. the thumbnail decode is done only
+ * when MM_FILE_WANT_THUMBNAIL is set. Attributes not covered by mask may be left unset.
+ *
+ * @param	content_attrs	[out]	content attribute handle.
+ * @param	filename	[in]	file path.
+ * @param	mask		[in]	bitwise OR of MM_FILE_WANT_XXX.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	Filename must be UTF-8 format.
+ * @pre		File should be exists.
+ * @post	Handle is ready to use.
+ * @see		mm_file_create_content_attrs, mm_file_destroy_content_attrs
+ * @par Example::
+ * @code
+#include <mm_file.h>
+
+// duration and codec only, no thumbnail decode
+mm_file_create_content_attrs_ex(&content_attrs, filename, MM_FILE_WANT_DURATION | MM_FILE_WANT_VIDEO_CODEC | MM_FILE_WANT_AUDIO_CODEC);
+
+mm_file_get_attrs(content_attrs,
+				NULL,
+				MM_FILE_CONTENT_DURATION, &ccontent.duration,
+				NULL);
+
+mm_file_destroy_content_attrs(content_attrs);
+ * @endcode
+ */
+int mm_file_create_content_attrs_ex(MMHandleType *content_attrs, const char *filename, int mask);
+
+/**
+ * This function is same as mm_file_create_content_attrs_ex() but bounds the parsing time.<BR>
+ * When the deadline expires, parsing stops at the next check point and the attributes parsed so far
+ * are returned with MM_FILE_CONTENT_INCOMPLETE set to 1. Stalls inside ffmpeg I/O are interrupted too.
+ *
+ * @param	content_attrs	[out]	content attribute handle.
+ * @param	filename	[in]	file path.
+ * @param	mask		[in]	bitwise OR of MM_FILE_WANT_XXX.
+ * @param	deadline	[in]	time budget in milliseconds, 0 for none.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ *		An expired deadline is not an error.
+ * @see		mm_file_create_content_attrs_ex, mm_file_destroy_content_attrs
+ */
+int mm_file_create_content_attrs_with_deadline(MMHandleType *content_attrs, const char *filename, int mask, int deadline);
+
+/**
+ * content information filled by mm_file_get_content_info().
+ * Fields have the meaning of the MM_FILE_CONTENT_XXX attributes of the same name.
+ */
+typedef struct {
+	int	duration;
+	int	video_codec;
+	int	video_bitrate;
+	int	video_fps;
+	int	video_width;
+	int	video_height;
+	int	video_track_count;
+	int	audio_codec;
+	int	audio_bitrate;
+	int	audio_channels;
+	int	audio_samplerate;
+	int	audio_track_count;
+	void	*thumbnail;		/**< Owned, released by mm_file_free_content_info() */
+	int	thumbnail_size;
+	int	incomplete;
+} MMFileContentInfo;
+
+/**
+ * tag information filled by mm_file_get_tag_info().
+ * Fields have the meaning of the MM_FILE_TAG_XXX attributes of the same name.
+ * Strings, artwork and synchronized lyrics are owned and released by mm_file_free_tag_info().
+ */
+typedef struct {
+	char	*artist;
+	char	*title;
+	char	*album;
+	char	*genre;
+	char	*author;
+	char	*copyright;
+	char	*date;
+	char	*description;
+	char	*track_num;
+	char	*classification;
+	char	*rating;
+	char	*conductor;
+	char	*recdate;
+	char	*unsynclyrics;
+	void	*artwork;
+	int	artwork_size;
+	char	*artwork_mime;
+	double	longitude;
+	double	latitude;
+	double	altitude;
+	int	synclyrics_num;
+	GList	*synclyrics;		/**< Read with mm_file_get_tag_info_synclyrics() */
+} MMFileTagInfo;
+
+/**
+ * This function is to get content information into a plain structure.<BR>
+ * It is the lightweight form of mm_file_create_content_attrs_ex() for bulk indexing:
+ * no attribute handle is created and no name lookup is done.
+ *
+ * @param	filename	[in]	file path.
+ * @param	mask		[in]	bitwise OR of MM_FILE_WANT_XXX.
+ * @param	info		[out]	content information.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	info should be released by mm_file_free_content_info().
+ * @see		mm_file_free_content_info
+ */
+int mm_file_get_content_info(const char *filename, int mask, MMFileContentInfo *info);
+
+/**
+ * This function is to release the buffers of MMFileContentInfo.
+ *
+ * @param	info		[in]	content information.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ */
+int mm_file_free_content_info(MMFileContentInfo *info);
+
+/**
+ * This function is to get tag information into a plain structure.<BR>
+ * It is the lightweight form of mm_file_create_tag_attrs().
+ *
+ * @param	filename	[in]	file path.
+ * @param	info		[out]	tag information.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	info should be released by mm_file_free_tag_info().
+ * @see		mm_file_free_tag_info
+ */
+int mm_file_get_tag_info(const char *filename, MMFileTagInfo *info);
+
+/**
+ * This function is to release the strings and buffers of MMFileTagInfo.
+ *
+ * @param	info		[in]	tag information.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ */
+int mm_file_free_tag_info(MMFileTagInfo *info);
+
+/**
+ * This function is to get one synchronized lyric of MMFileTagInfo.<BR>
+ * It is the MMFileTagInfo form of mm_file_get_synclyrics_info().
+ *
+ * @param	info		[in]	tag information filled by mm_file_get_tag_info().
+ * @param	index		[in]	lyric index, from 0 to synclyrics_num - 1.
+ * @param	time_info	[out]	time of the lyric in milliseconds.
+ * @param	lyrics		[out]	lyric string, owned by info.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ */
+int mm_file_get_tag_info_synclyrics(const MMFileTagInfo *info, int index, unsigned long *time_info, char **lyrics);
+
+/**
+ * This function is to enable the persistent metadata cache.<BR>
+ * Content and tag attributes extracted from files are stored in the index file at path,
+ * keyed by device, inode, size, and modification and status change times in nanoseconds
+ * of the media file, so a rewrite within the same second is seen. A later request
+ * for an unchanged file is answered from the index without parsing the file.
+ * Thumbnails, artwork and synchronized lyrics are not cached; requests which need them parse the file.
+ *
+ * @param	path		[in]	index file path, created if it does not exist.
+ * @param	max_entries	[in]	number of records kept, least recently used records are replaced.
+ *				An existing index keeps the size it was created with.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The index can be shared by several processes. An index of an incompatible
+ *		layout is not overwritten, MM_ERROR_FILE_INTERNAL is returned.
+ * @see		mm_file_disable_cache
+ */
+int mm_file_enable_cache(const char *path, int max_entries);
+
+/**
+ * This function is to disable the persistent metadata cache.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @see		mm_file_enable_cache
+ */
+int mm_file_disable_cache(void);
+
+/**
+ * stages reported by mm_file_async_cb.
+ */
+enum {
+	MM_FILE_ASYNC_STAGE_OPEN,		/**< File is probed and opened */
+	MM_FILE_ASYNC_STAGE_STREAM,		/**< Stream information is read */
+	MM_FILE_ASYNC_STAGE_THUMBNAIL,	/**< Thumbnail is decoded */
+	MM_FILE_ASYNC_STAGE_DONE,		/**< Request is finished */
+	MM_FILE_ASYNC_STAGE_CANCELLED,	/**< Request is cancelled */
+};
+
+/**
+ * Callback of mm_file_create_content_attrs_async().
+ * It is called for each stage reached, then once with MM_FILE_ASYNC_STAGE_DONE or MM_FILE_ASYNC_STAGE_CANCELLED.
+ *
+ * @param	id		[in]	request id.
+ * @param	stage		[in]	MM_FILE_ASYNC_STAGE_XXX.
+ * @param	result		[in]	with MM_FILE_ASYNC_STAGE_DONE, MM_ERROR_NONE on success, or negative value with error code.
+ * @param	content_attrs	[in]	with MM_FILE_ASYNC_STAGE_DONE, content attribute handle, or 0.
+ *					The callee owns it and should release it by mm_file_destroy_content_attrs().
+ * @param	user_data	[in]	user data given to the request.
+ */
+typedef void (*mm_file_async_cb)(int id, int stage, int result, MMHandleType content_attrs, void *user_data);
+
+/**
+ * This function is to request content attribute extraction in background.<BR>
+ * Requests are served in order by worker threads, one per CPU.
+ *
+ * @param	filename	[in]	file path.
+ * @param	mask		[in]	bitwise OR of MM_FILE_WANT_XXX, see mm_file_create_content_attrs_ex().
+ * @param	callback	[in]	called from a worker thread.
+ * @param	user_data	[in]	user data passed to callback.
+ *
+ * @return	This function returns positive request id on success, or negative value with error code.
+ *		MM_ERROR_FILE_INTERNAL is returned if no worker thread could be started.
+ * @remark	Call mm_file_unload_libraries() before exit to get every callback. Requests still
+ *		waiting when the process exits or the library is unloaded are dropped without a callback.
+ * @see		mm_file_cancel
+ */
+int mm_file_create_content_attrs_async(const char *filename, int mask, mm_file_async_cb callback, void *user_data);
+
+/**
+ * This function is to cancel a request of mm_file_create_content_attrs_async().<BR>
+ * A waiting request is dropped and MM_FILE_ASYNC_STAGE_CANCELLED is reported before this
+ * function returns, on the calling thread. A running request stops at the next stage boundary
+ * or inside long parsing loops such as the thumbnail frame search.
+ *
+ * @param	id		[in]	request id.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The callback may still report MM_FILE_ASYNC_STAGE_DONE if the request finished meanwhile.
+ *		MM_ERROR_INVALID_ARGUMENT is returned if the request is already finished.
+ */
+int mm_file_cancel(int id);
+
 int mm_file_get_synclyrics_info(MMHandleType tag_attrs, int index, unsigned long *time_info, char **lyrics);
 
 int mm_file_get_video_frame(const char* path, double timestamp, bool keyframe, unsigned char **data, int *size, int *width, int *height);
 
+/**
+ * This function is to unload the format and codec libraries.<BR>
+ * The libraries are loaded once at the first call of this module and kept resident,
+ * so that bulk extraction does not pay for dlopen()/dlclose() on every file.
+ * They are released automatically at process exit.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	Fails if another thread is using the libraries or a session is opened.
+ *		Requests of mm_file_create_content_attrs_async() are cancelled and its worker
+ *		threads are stopped first.
+ *		The libraries are loaded again on the next call.
+ */
+int mm_file_unload_libraries(void);
+
+/**
+ * This function is to open a media session on a file.<BR>
+ * The file is probed and opened only once, and the session serves stream, content, tag and thumbnail
+ * queries from the same parser context. It should be used instead of calling mm_file_get_stream_info(),
+ * mm_file_create_content_attrs() and mm_file_create_tag_attrs() one after another on the same file.
+ *
+ * @param	session		[out]	session handle.
+ * @param	filename	[in]	file path.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	Filename must be UTF-8 format.
+ * @pre		File should be exists.
+ * @post	Session is ready to use, and should be released by mm_file_close_session().
+ * @see		mm_file_close_session, mm_file_session_get_stream_info, mm_file_session_get_content_attrs,
+ *		mm_file_session_get_tag_attrs, mm_file_session_get_thumbnail
+ * @par Example::
+ * @code
+#include <mm_file.h>
+
+MMHandleType session = 0;
+MMHandleType content_attrs = 0;
+MMHandleType tag_attrs = 0;
+int audio_track_num = 0, video_track_num = 0;
+
+if (mm_file_open_session(&session, filename) == MM_ERROR_NONE) {
+	mm_file_session_get_stream_info(session, &audio_track_num, &video_track_num);
+	mm_file_session_get_content_attrs(session, &content_attrs);
+	mm_file_session_get_tag_attrs(session, &tag_attrs);
+
+	// attribute handles are owned by the session, do not destroy them
+	mm_file_close_session(session);
+}
+ * @endcode
+ */
+int mm_file_open_session(MMHandleType *session, const char *filename);
+
+/**
+ * This function is to get the count of audio/video stream from a session.
+ *
+ * @param	session			[in]	session handle.
+ * @param	audio_stream_num	[out]	number of audio stream of media file
+ * @param	video_stream_num	[out]	number of video stream of media file
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @see		mm_file_open_session, mm_file_get_stream_info
+ */
+int mm_file_session_get_stream_info(MMHandleType session, int *audio_stream_num, int *video_stream_num);
+
+/**
+ * This function is to get the content attributes, including thumbnail, from a session.
+ *
+ * @param	session		[in]	session handle.
+ * @param	content_attrs	[out]	content attribute handle.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The handle is owned by the session and valid until mm_file_close_session().
+ *		Do not call mm_file_destroy_content_attrs() on it.
+ * @see		mm_file_open_session, mm_file_create_content_attrs, mm_file_get_attrs
+ */
+int mm_file_session_get_content_attrs(MMHandleType session, MMHandleType *content_attrs);
+
+/**
+ * This function is to get the tag attributes from a session.
+ *
+ * @param	session		[in]	session handle.
+ * @param	tag_attrs	[out]	tag attribute handle.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The handle is owned by the session and valid until mm_file_close_session().
+ *		Do not call mm_file_destroy_tag_attrs() on it.
+ * @see		mm_file_open_session, mm_file_create_tag_attrs, mm_file_get_attrs
+ */
+int mm_file_session_get_tag_attrs(MMHandleType session, MMHandleType *tag_attrs);
+
+/**
+ * This function is to get the video thumbnail from a session.<BR>
+ * The thumbnail is extracted only once, and shared with mm_file_session_get_content_attrs().
+ *
+ * @param	session	[in]	session handle.
+ * @param	frame	[out]	thumbnail frame data.
+ * @param	size	[out]	size of frame data.
+ * @param	width	[out]	width of thumbnail.
+ * @param	height	[out]	height of thumbnail.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The frame data is owned by the session and valid until mm_file_close_session().
+ * @see		mm_file_open_session
+ */
+int mm_file_session_get_thumbnail(MMHandleType session, void **frame, int *size, int *width, int *height);
+
+/**
+ * This function is to close a media session.<BR>
+ * All attribute handles and thumbnail data taken from the session are released.
+ *
+ * @param	session	[in]	session handle.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @see		mm_file_open_session
+ */
+int mm_file_close_session(MMHandleType session);
+
+/**
+ * flags of mm_file_create_content_attrs_batch().
+ */
+#define MM_FILE_BATCH_NO_THUMBNAIL		0x0001	/**< Parse like mm_file_create_content_attrs_simple() */
+#define MM_FILE_BATCH_NO_PRIORITY		0x0002	/**< Keep the given order instead of audio files first */
+
+/**
+ * Callback of mm_file_create_content_attrs_batch().
+ *
+ * @param	filename	[in]	file path, as given to the batch.
+ * @param	result		[in]	MM_ERROR_NONE on success, or negative value with error code.
+ * @param	content_attrs	[in]	content attribute handle, or 0.
+ *					The callee owns it and should release it by mm_file_destroy_content_attrs().
+ * @param	user_data	[in]	user data given to the batch.
+ */
+typedef void (*mm_file_batch_cb)(const char *filename, int result, MMHandleType content_attrs, void *user_data);
+
+/**
+ * This function is to extract content attributes of many files in parallel.<BR>
+ * Files are spread over a work-stealing thread pool sized to the CPU count. Unless MM_FILE_BATCH_NO_PRIORITY
+ * is set, audio files are scheduled before video files which need a thumbnail decode. The kind is told
+ * from the file extension only, so the pool starts without touching the files.
+ *
+ * @param	filenames	[in]	array of file paths.
+ * @param	num		[in]	number of file paths.
+ * @param	flags		[in]	MM_FILE_BATCH_XXX flags.
+ * @param	callback	[in]	called once per file, as soon as the file is done.
+ * @param	user_data	[in]	user data passed to callback.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The callback is called from worker threads, possibly at the same time for different files.
+ *		This function returns after all callbacks are done.
+ * @see		mm_file_create_content_attrs, mm_file_destroy_content_attrs
+ */
+int mm_file_create_content_attrs_batch(const char **filenames, int num, int flags, mm_file_batch_cb callback, void *user_data);
+
+/**
+ * I/O done by an extraction, as seen by the source. Reads served from the internal read buffer are not counted.
+ * Containers parsed by ffmpeg are read through the same I/O layer and are counted too; the separate
+ * file opened by mm_file_get_video_frame() is not.
+ */
+typedef struct {
+	unsigned int		open_count;	/**< Number of times the source was opened */
+	unsigned int		read_count;	/**< Number of reads from the source */
+	unsigned long long	read_bytes;	/**< Bytes read from the source */
+	unsigned int		seek_count;	/**< Number of seeks of the source */
+	unsigned int		discontiguous_reads;	/**< Number of reads not starting where the previous read ended, a sequential scan counts one */
+} MMFileIOStats;
+
+/**
+ * This function is to get the I/O statistics of the last extraction done on the calling thread.<BR>
+ * An extraction is one mm_file_create_content_attrs(), mm_file_create_tag_attrs() or similar call.
+ * Batch and async callbacks run on the thread of their extraction, so they can call this function too.
+ *
+ * @param	stats	[out]	I/O statistics.
+ *
+ * @return	This function returns MM_ERROR_NONE on success, or negative value with error code.
+ * @remark	The counters are always on. A result served from the metadata cache reports no I/O.
+ *		Sessions are not covered.
+ * @see		mm_file_create_content_attrs, mm_file_create_tag_attrs
+ */
+int mm_file_get_last_io_stats(MMFileIOStats *stats);
+
 /**
 	@}
  */
@@ -63,10 +63,24 @@ struct _mmfilecodecctx
     int (*Close)      (MMFileCodecContext*);
 };
 
+/**
+ * function table exported by libmmfile_codecs.so,
+ * resolved once by the loader in mm_file.c.
+ */
+#define MMFILE_CODEC_FUNCS_SYMBOL	"mmfile_codec_funcs"
+
+typedef struct {
+    int (*open)   (MMFileCodecContext **codecContext, int codecType, int codecId, MMFileCodecFrame *input);
+    int (*decode) (MMFileCodecContext *codecContext, MMFileCodecFrame *output);
+    int (*close)  (MMFileCodecContext *codecContext);
+} MMFileCodecFuncs;
+
 #ifndef __MMFILE_DYN_LOADING__
 int mmfile_codec_open   (MMFileCodecContext **codecContext, int codecType, int codecId, MMFileCodecFrame *input);
 int mmfile_codec_decode (MMFileCodecContext *codecContext, MMFileCodecFrame *output);
 int mmfile_codec_close  (MMFileCodecContext *codecContext);
+
+extern const MMFileCodecFuncs mmfile_codec_funcs;
 #endif 
 
 #ifdef __cplusplus
@@ -34,6 +34,14 @@ extern "C" {
 #define MMFILE_FORMAT_SUCCESS   1
 #define MMFILE_FORMAT_FAIL      0
 
+/* parse stages wanted by caller, same bits as MM_FILE_WANT_XXX in mm_file.h */
+#define MMFILE_PARSE_DURATION		0x0001
+#define MMFILE_PARSE_VIDEO_CODEC	0x0002
+#define MMFILE_PARSE_VIDEO_SIZE		0x0004
+#define MMFILE_PARSE_AUDIO_CODEC	0x0008
+#define MMFILE_PARSE_THUMBNAIL		0x0010
+#define MMFILE_PARSE_ALL			0x001F
+
 
 #define MM_FILE_SET_MEDIA_FILE_SRC(Media,Filename)		do { \
 	(Media).type = MM_FILE_SRC_TYPE_FILE; \
@@ -47,11 +55,20 @@ extern "C" {
 	(Media).memory.format = (Format); \
 } while (0);
 
+#define MM_FILE_SET_MEDIA_CALLBACK_SRC(Media,Read,Seek,Size,UserData)		do { \
+	(Media).type = MM_FILE_SRC_TYPE_CALLBACK; \
+	(Media).callback.read = (Read); \
+	(Media).callback.seek = (Seek); \
+	(Media).callback.size = (Size); \
+	(Media).callback.user_data = (UserData); \
+} while (0);
+
 
 
 enum {
 	MM_FILE_SRC_TYPE_FILE,
 	MM_FILE_SRC_TYPE_MEMORY,
+	MM_FILE_SRC_TYPE_CALLBACK,
 };
 
 enum {
@@ -72,6 +89,13 @@ typedef struct _mm_file_source {
 			unsigned int size;
 			int format;     /* _mmfileformats */
 		} memory;
+		struct {
+			/* same as MMFileIOCallbacks of mm_file.h */
+			int (*read) (void *user_data, unsigned char *buf, int size);
+			long long (*seek) (void *user_data, long long offset, int whence);
+			long long (*size) (void *user_data);
+			void *user_data;
+		} callback;
 	};
 } MMFileSourceType;
 
@@ -108,10 +132,20 @@ struct _MMFileFormatContext {
 	int formatType;
 	int commandType;	/* TAG or CONTENTS */
 	int pre_checked;	/*filefomat already detected.*/
+	int parseMask;		/*MMFILE_PARSE_XXX, set before ReadStream*/
 
 	MMFileSourceType *filesrc;	/*ref only*/
 	char *uriFileName;
 
+	/* opened once while probing and shared by the format parsers */
+	struct MMFileIOHandle *ioHandle;
+	long long fileSize;
+	const unsigned char *headBuffer;	/*first bytes of the content, lent by the handle*/
+	int headSize;
+	unsigned char *tailBuffer;	/*last bytes of the content, NULL if within head*/
+	int tailSize;
+	unsigned int probedFormats;	/*(1 << MM_FILE_FORMAT_XXX) matched by probing*/
+
 	/* contents information */
 	int duration;	/* milliseconds */
 	int isseekable;
@@ -163,12 +197,31 @@ struct _MMFileFormatContext {
 	int (*Close)		(MMFileFormatContext*);
 };
 
+/**
+ * function table exported by libmmfile_formats.so,
+ * resolved once by the loader in mm_file.c.
+ */
+#define MMFILE_FORMAT_FUNCS_SYMBOL	"mmfile_format_funcs"
+
+typedef struct {
+	int (*open)			(MMFileFormatContext **formatContext, MMFileSourceType *fileSrc);
+	int (*read_stream)	(MMFileFormatContext *formatContext);
+	int (*read_frame)	(MMFileFormatContext *formatContext, unsigned int timestamp, MMFileFormatFrame *frame);
+	int (*read_tag)		(MMFileFormatContext *formatContext);
+	int (*close)		(MMFileFormatContext *formatContext);
+	int (*get_frame)	(const char* path, double timestamp, bool keyframe, unsigned char **data, int *size, int *width, int *height);
+	int (*is_video)		(const char *path);
+} MMFileFormatFuncs;
+
 #ifndef __MMFILE_DYN_LOADING__
 int mmfile_format_open			(MMFileFormatContext **formatContext, MMFileSourceType *fileSrc);
 int mmfile_format_read_stream	(MMFileFormatContext *formatContext);
 int mmfile_format_read_frame	(MMFileFormatContext *formatContext, unsigned int timestamp, MMFileFormatFrame *frame);
 int mmfile_format_read_tag		(MMFileFormatContext *formatContext);
 int mmfile_format_close			(MMFileFormatContext *formatContext);
+int mmfile_format_is_video		(const char *path);
+
+extern const MMFileFormatFuncs mmfile_format_funcs;
 #endif
 
 #ifdef __cplusplus
@@ -24,6 +24,9 @@
 #include <unistd.h>	/*for access*/
 #include <string.h>	/*for strXXX*/
 #include <dlfcn.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 /* exported MM header files */
 #include <mm_types.h>
@@ -74,23 +77,47 @@ enum {
 	MM_FILE_INVALID,
 };
 
-enum {
-	MM_FILE_PARSE_TYPE_SIMPLE,		/*parse audio/video track num only*/
-	MM_FILE_PARSE_TYPE_NORMAL,		/*parse infomation without thumbnail*/
-	MM_FILE_PARSE_TYPE_ALL,			/*parse all infomation*/
-};
+/* 0 parses audio/video track num only */
+#define MM_FILE_PARSE_MASK_SIMPLE	0
+#define MM_FILE_PARSE_MASK_NORMAL	(MM_FILE_WANT_ALL & ~MM_FILE_WANT_THUMBNAIL)	/*parse infomation without thumbnail*/
+#define MM_FILE_PARSE_MASK_ALL		MM_FILE_WANT_ALL								/*parse all infomation*/
+
+typedef struct {
+	int					id;
+	char				*filename;
+	int					mask;
+	mm_file_async_cb	callback;
+	void				*user_data;
+	int					running;
+	MMFileAbort			abort;
+	void				*next;
+} MMFILE_ASYNC_REQUEST;
 
 typedef struct {
-	int	type;
+	int	mask;		/*MM_FILE_WANT_XXX*/
+	MMFILE_ASYNC_REQUEST	*request;	/*NULL if synchronous*/
+	MMFileContentInfo		*content_info;	/*filled instead of attrs if set*/
+	int	incomplete;	/*stopped by deadline*/
 	int	audio_track_num;
 	int	video_track_num;
 } MMFILE_PARSE_INFO;
 
 typedef struct {
-	void *formatFuncHandle;
-	void *codecFuncHandle;
+	const MMFileFormatFuncs *formatFuncs;
+	const MMFileCodecFuncs *codecFuncs;
 } MMFILE_FUNC_HANDLE;
 
+typedef struct {
+	char					*filename;
+	MMFileSourceType		src;
+	MMFileFormatContext	*formatContext;
+	int					stream_read;		/*ReadStream is done*/
+	int					thumbnail_read;	/*ReadFrame is done*/
+	mmf_attrs_t			*content_attrs;
+	mmf_attrs_t			*tag_attrs;
+	MMFILE_FUNC_HANDLE	func_handle;
+} MMFILE_SESSION;
+
 
 
 /**
@@ -137,97 +164,126 @@ static mmf_attrs_construct_info_t g_content_attrs[] = {
 	{"content-audio-samplerate",	MMF_VALUE_TYPE_INT,		MM_ATTRS_FLAG_RW, (void *)0},
 	{"content-audio-track-index",	MMF_VALUE_TYPE_INT,		MM_ATTRS_FLAG_RW, (void *)0},
 	{"content-audio-track-count",	MMF_VALUE_TYPE_INT,		MM_ATTRS_FLAG_RW, (void *)0},
+	{"content-incomplete",			MMF_VALUE_TYPE_INT,		MM_ATTRS_FLAG_RW, (void *)0},
 };
 
 #ifdef __MMFILE_DYN_LOADING__
 #define MMFILE_FORMAT_SO_FILE_NAME  "libmmfile_formats.so"
 #define MMFILE_CODEC_SO_FILE_NAME   "libmmfile_codecs.so"
 
-int (*mmfile_format_open)			(MMFileFormatContext **formatContext, MMFileSourceType *fileSrc);
-int (*mmfile_format_read_stream)	(MMFileFormatContext *formatContext);
-int (*mmfile_format_read_frame)		(MMFileFormatContext *formatContext, unsigned int timestamp, MMFileFormatFrame *frame);
-int (*mmfile_format_read_tag)		(MMFileFormatContext *formatContext);
-int (*mmfile_format_close)			(MMFileFormatContext *formatContext);
-int (*mmfile_codec_open)				(MMFileCodecContext **codecContext, int codecType, int codecId, MMFileCodecFrame *input);
-int (*mmfile_codec_decode)			(MMFileCodecContext *codecContext, MMFileCodecFrame *output);
-int (*mmfile_codec_close)			(MMFileCodecContext *codecContext);
-int (*mmfile_format_get_frame)		(const char* path, double timestamp, bool keyframe, unsigned char **data, int *size, int *width, int *height);
+/**
+ * The format and codec libraries are opened once per process and kept resident.
+ * Each public call only takes a reference; the libraries are closed by
+ * mm_file_unload_libraries() when nobody uses them, or at exit.
+ */
+typedef struct {
+	void *formatFuncHandle;
+	void *codecFuncHandle;
+	const MMFileFormatFuncs *formatFuncs;
+	const MMFileCodecFuncs *codecFuncs;
+	int refcount;
+} MMFILE_LOADER;
+
+static pthread_once_t g_loader_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t g_loader_lock = PTHREAD_MUTEX_INITIALIZER;
+static MMFILE_LOADER g_loader = {0,};
+
 #endif
 
 #ifdef __MMFILE_DYN_LOADING__
-static int _load_dynamic_functions (MMFILE_FUNC_HANDLE* pHandle)
-{
-//	static int dll_func_initialized = 0; //disabled
+static void _async_stop_workers (void);
+static int _async_drop_workers (void);
 
-	int ret = 0;
+/* must be called with g_loader_lock held */
+static void _loader_close_libraries (void)
+{
+	g_loader.formatFuncs = NULL;
+	g_loader.codecFuncs = NULL;
 
-	/* Get from function argument */
-	void *formatFuncHandle = NULL;
-	void *codecFuncHandle = NULL;	
+	if (g_loader.formatFuncHandle) {
+		dlclose (g_loader.formatFuncHandle);
+		g_loader.formatFuncHandle = NULL;
+	}
+	if (g_loader.codecFuncHandle) {
+		dlclose (g_loader.codecFuncHandle);
+		g_loader.codecFuncHandle = NULL;
+	}
+}
 
-	/* disabled
-	if (dll_func_initialized) {
+/* must be called with g_loader_lock held */
+static int _loader_open_libraries (void)
+{
+	if (g_loader.formatFuncs && g_loader.codecFuncs)
 		return 1;
-	}
-	*/
 
-	formatFuncHandle = dlopen (MMFILE_FORMAT_SO_FILE_NAME, RTLD_LAZY);
-	if (!formatFuncHandle) {
+	g_loader.formatFuncHandle = dlopen (MMFILE_FORMAT_SO_FILE_NAME, RTLD_LAZY);
+	if (!g_loader.formatFuncHandle) {
 		debug_error ("error: %s\n", dlerror());
-		ret = 0;
 		goto exception;
 	}
 
-	mmfile_format_open			= dlsym (formatFuncHandle, "mmfile_format_open");
-	mmfile_format_read_stream	= dlsym (formatFuncHandle, "mmfile_format_read_stream");
-	mmfile_format_read_frame	= dlsym (formatFuncHandle, "mmfile_format_read_frame");
-	mmfile_format_read_tag		= dlsym (formatFuncHandle, "mmfile_format_read_tag");
-	mmfile_format_close			= dlsym (formatFuncHandle, "mmfile_format_close");
-
-	if ( !mmfile_format_open ||
-		 !mmfile_format_read_stream ||
-		 !mmfile_format_read_frame ||
-		 !mmfile_format_read_tag ||
-		 !mmfile_format_close) {
-
+	g_loader.formatFuncs = dlsym (g_loader.formatFuncHandle, MMFILE_FORMAT_FUNCS_SYMBOL);
+	if (!g_loader.formatFuncs) {
 		debug_error ("error: %s\n", dlerror());
-		ret = 0;
 		goto exception;
 	}
 
-	/*closed at app termination.*/
-	//dlclose (formatFuncHandle);
-
-	codecFuncHandle = dlopen (MMFILE_CODEC_SO_FILE_NAME, RTLD_LAZY | RTLD_GLOBAL);
-	if (!codecFuncHandle) {
+	g_loader.codecFuncHandle = dlopen (MMFILE_CODEC_SO_FILE_NAME, RTLD_LAZY | RTLD_GLOBAL);
+	if (!g_loader.codecFuncHandle) {
 		debug_error ("error: %s\n", dlerror());
-		ret = 0;
 		goto exception;
 	}
 
-	mmfile_codec_open		= dlsym (codecFuncHandle, "mmfile_codec_open");
-	mmfile_codec_decode	= dlsym (codecFuncHandle, "mmfile_codec_decode");
-	mmfile_codec_close		= dlsym (codecFuncHandle, "mmfile_codec_close");
-
-	if ( !mmfile_codec_open || !mmfile_codec_decode || !mmfile_codec_close) {
+	g_loader.codecFuncs = dlsym (g_loader.codecFuncHandle, MMFILE_CODEC_FUNCS_SYMBOL);
+	if (!g_loader.codecFuncs) {
 		debug_error ("error: %s\n", dlerror());
-		ret = 0;
 		goto exception;
 	}
 
-	/*closed at app termination.*/
-	//dlclose (codecFuncHandle);
+	return 1;
 
-//	dll_func_initialized = 1; // disabled
+exception:
+	_loader_close_libraries ();
 
-	pHandle->codecFuncHandle = codecFuncHandle;
-	pHandle->formatFuncHandle = formatFuncHandle;
+	return 0;
+}
 
-	return 1;
+static void _loader_init (void)
+{
+	pthread_mutex_lock (&g_loader_lock);
+	_loader_open_libraries ();
+	pthread_mutex_unlock (&g_loader_lock);
+}
 
-exception:
-	if (formatFuncHandle) dlclose (formatFuncHandle);
-	if (codecFuncHandle)  dlclose (codecFuncHandle);
+static void __attribute__((destructor)) _loader_fini (void)
+{
+	/* at exit, no thread is joined and no callback is called. a request still
+	   running may be inside the libraries, they are then left to the process teardown */
+	if (_async_drop_workers () > 0)
+		return;
+
+	pthread_mutex_lock (&g_loader_lock);
+	_loader_close_libraries ();
+	pthread_mutex_unlock (&g_loader_lock);
+}
+
+static int _load_dynamic_functions (MMFILE_FUNC_HANDLE* pHandle)
+{
+	int ret = 0;
+
+	pthread_once (&g_loader_once, _loader_init);
+
+	pthread_mutex_lock (&g_loader_lock);
+
+	/* reopen if unloaded by mm_file_unload_libraries() or the first try failed */
+	ret = _loader_open_libraries ();
+	if (ret) {
+		g_loader.refcount++;
+		pHandle->formatFuncs = g_loader.formatFuncs;
+		pHandle->codecFuncs = g_loader.codecFuncs;
+	}
+
+	pthread_mutex_unlock (&g_loader_lock);
 
 	return ret;
 }
@@ -236,19 +292,36 @@ static void _unload_dynamic_functions (MMFILE_FUNC_HANDLE* pHandle)
 {
 	debug_fenter ();	
 
-	if (pHandle->formatFuncHandle) 
-	{
-		dlclose (pHandle->formatFuncHandle);		
-	}
-	if (pHandle->codecFuncHandle)  
-	{
-		dlclose (pHandle->codecFuncHandle);		
+	pthread_mutex_lock (&g_loader_lock);
+
+	if (pHandle->formatFuncs) {
+		g_loader.refcount--;
+		pHandle->formatFuncs = NULL;
+		pHandle->codecFuncs = NULL;
 	}
-	
+
+	pthread_mutex_unlock (&g_loader_lock);
+
 	debug_fleave ();
 }
 
 
+#else	/* __MMFILE_DYN_LOADING__ */
+
+static int _load_dynamic_functions (MMFILE_FUNC_HANDLE* pHandle)
+{
+	pHandle->formatFuncs = &mmfile_format_funcs;
+	pHandle->codecFuncs = &mmfile_codec_funcs;
+
+	return 1;
+}
+
+static void _unload_dynamic_functions (MMFILE_FUNC_HANDLE* pHandle)
+{
+	pHandle->formatFuncs = NULL;
+	pHandle->codecFuncs = NULL;
+}
+
 #endif /* __MMFILE_DYN_LOADING__ */
 
 /**
@@ -302,12 +375,10 @@ _info_set_attr_media (mmf_attrs_t *attrs, MMFileFormatContext *formatContext)
 
 		if (formatContext->unsyncLyrics)		mm_attrs_set_string_by_name(hattrs, MM_FILE_TAG_UNSYNCLYRICS, formatContext->unsyncLyrics);
 		
+		/* artwork buffer is moved, mm_file_destroy_tag_attrs() frees it */
 		if (formatContext->artwork && formatContext->artworkSize > 0) {
-			void *artworkCopy = NULL;
-			artworkCopy = mmfile_malloc ((formatContext->artworkSize));
-			if ( NULL != artworkCopy ) {
-				memcpy (artworkCopy, formatContext->artwork, formatContext->artworkSize);
-				mm_attrs_set_data_by_name (hattrs, MM_FILE_TAG_ARTWORK,artworkCopy, formatContext->artworkSize);
+			if (mm_attrs_set_data_by_name (hattrs, MM_FILE_TAG_ARTWORK, formatContext->artwork, formatContext->artworkSize) == MM_ERROR_NONE) {
+				formatContext->artwork = NULL;
 				mm_attrs_set_int_by_name (hattrs, MM_FILE_TAG_ARTWORK_SIZE, formatContext->artworkSize);
 				if (formatContext->artworkMime)	mm_attrs_set_string_by_name(hattrs, MM_FILE_TAG_ARTWORK_MIME, formatContext->artworkMime);
 			}
@@ -332,13 +403,12 @@ _info_set_attr_media (mmf_attrs_t *attrs, MMFileFormatContext *formatContext)
 			mm_attrs_set_int_by_name (hattrs, MM_FILE_CONTENT_VIDEO_WIDTH, videoStream->width);
 			mm_attrs_set_int_by_name (hattrs, MM_FILE_CONTENT_VIDEO_HEIGHT, videoStream->height);
 
+			/* thumbnail buffer is moved, mm_file_destroy_content_attrs() frees it */
 			if (formatContext->thumbNail && formatContext->thumbNail->frameData) {
-				void *thumbNailCopy = NULL;
-				thumbNailCopy = mmfile_malloc (formatContext->thumbNail->frameSize);
+				MMFileFormatFrame *thumbNail = formatContext->thumbNail;
 
-				if (NULL != thumbNailCopy) {
-					memcpy (thumbNailCopy, formatContext->thumbNail->frameData, formatContext->thumbNail->frameSize);
-					mm_attrs_set_data_by_name (hattrs, MM_FILE_CONTENT_VIDEO_THUMBNAIL, thumbNailCopy, formatContext->thumbNail->frameSize);
+				if (mm_attrs_set_data_by_name (hattrs, MM_FILE_CONTENT_VIDEO_THUMBNAIL, thumbNail->frameData, thumbNail->frameSize) == MM_ERROR_NONE) {
+					thumbNail->frameData = NULL;
 					mm_attrs_set_int_by_name (hattrs, MM_FILE_CONTENT_VIDEO_WIDTH, formatContext->thumbNail->frameWidth);
 					mm_attrs_set_int_by_name (hattrs, MM_FILE_CONTENT_VIDEO_HEIGHT, formatContext->thumbNail->frameHeight);
 				}
@@ -368,235 +438,383 @@ _info_set_attr_media (mmf_attrs_t *attrs, MMFileFormatContext *formatContext)
 	return ret;
 }
 
+/* buffers are moved from formatContext, which frees only what is left */
+#define _INFO_MOVE(dst, src)	do { (dst) = (src); (src) = NULL; } while (0)
+
+static void
+_info_fill_content (MMFileContentInfo *info, MMFileFormatContext *formatContext)
+{
+	info->duration = formatContext->duration;
+	info->audio_track_count = formatContext->audioTotalTrackNum;
+	info->video_track_count = formatContext->videoTotalTrackNum;
+
+	if (formatContext->videoTotalTrackNum > 0 &&
+		formatContext->nbStreams > 0 &&
+		formatContext->streams[MMFILE_VIDEO_STREAM]) {
+
+		MMFileFormatStream *videoStream = formatContext->streams[MMFILE_VIDEO_STREAM];
+
+		info->video_codec = videoStream->codecId;
+		info->video_bitrate = videoStream->bitRate;
+		info->video_fps = videoStream->framePerSec;
+		info->video_width = videoStream->width;
+		info->video_height = videoStream->height;
+
+		if (formatContext->thumbNail && formatContext->thumbNail->frameData) {
+			info->thumbnail_size = formatContext->thumbNail->frameSize;
+			info->video_width = formatContext->thumbNail->frameWidth;
+			info->video_height = formatContext->thumbNail->frameHeight;
+			_INFO_MOVE (info->thumbnail, formatContext->thumbNail->frameData);
+		}
+	}
+
+	if (formatContext->audioTotalTrackNum > 0 &&
+		formatContext->nbStreams > 0 &&
+		formatContext->streams[MMFILE_AUDIO_STREAM]) {
+
+		MMFileFormatStream *audioStream = formatContext->streams[MMFILE_AUDIO_STREAM];
+
+		info->audio_codec = audioStream->codecId;
+		info->audio_channels = audioStream->nbChannel;
+		info->audio_bitrate = audioStream->bitRate;
+		info->audio_samplerate = audioStream->samplePerSec;
+	}
+}
+
+static void
+_info_fill_tag (MMFileTagInfo *info, MMFileFormatContext *formatContext)
+{
+	_INFO_MOVE (info->title, formatContext->title);
+	_INFO_MOVE (info->artist, formatContext->artist);
+	if (formatContext->author)
+		_INFO_MOVE (info->author, formatContext->author);
+	else
+		_INFO_MOVE (info->author, formatContext->composer);
+	_INFO_MOVE (info->album, formatContext->album);
+	_INFO_MOVE (info->copyright, formatContext->copyright);
+	_INFO_MOVE (info->description, formatContext->comment);
+	_INFO_MOVE (info->genre, formatContext->genre);
+	_INFO_MOVE (info->classification, formatContext->classification);
+	_INFO_MOVE (info->date, formatContext->year);
+	_INFO_MOVE (info->track_num, formatContext->tagTrackNum);
+	_INFO_MOVE (info->rating, formatContext->rating);
+	_INFO_MOVE (info->conductor, formatContext->conductor);
+	_INFO_MOVE (info->recdate, formatContext->recDate);
+	_INFO_MOVE (info->unsynclyrics, formatContext->unsyncLyrics);
+
+	info->longitude = formatContext->longitude;
+	info->latitude = formatContext->latitude;
+	info->altitude = formatContext->altitude;
+
+	if (formatContext->syncLyrics) {
+		info->synclyrics_num = formatContext->syncLyricsNum;
+		_INFO_MOVE (info->synclyrics, formatContext->syncLyrics);
+	}
+
+	if (formatContext->artwork && formatContext->artworkSize > 0) {
+		info->artwork_size = formatContext->artworkSize;
+		_INFO_MOVE (info->artwork, formatContext->artwork);
+		_INFO_MOVE (info->artwork_mime, formatContext->artworkMime);
+	}
+}
+
+/**
+ * Extracts the thumbnail of the first video stream and keeps it in formatContext->thumbNail.
+ * The frame data is owned by formatContext and released by mmfile_format_close().
+ */
 static int
-_get_contents_info (mmf_attrs_t *attrs, MMFileSourceType *src, MMFILE_PARSE_INFO *parse)
+_get_video_thumbnail (MMFILE_FUNC_HANDLE *funcs, MMFileFormatContext *formatContext)
 {
-	MMFileFormatContext *formatContext = NULL;
 	MMFileCodecContext  *codecContext = NULL;
 	MMFileFormatFrame    frameContext = {0,};
 	MMFileCodecFrame     codecFrame = {0,};
 	MMFileCodecFrame     decodedFrame = {0,};
+	MMFileFormatStream  *videoStream = NULL;
+	unsigned int timestamp = _SEEK_POINT_;
+	int ret = 0;
+
+	if (!formatContext || formatContext->thumbNail)
+		return MM_ERROR_NONE;
+
+	videoStream = formatContext->streams[MMFILE_VIDEO_STREAM];
+	if (formatContext->videoTotalTrackNum <= 0 || !videoStream)
+		return MM_ERROR_NONE;
+
+	ret = funcs->formatFuncs->read_frame (formatContext, timestamp, &frameContext);
+	if (MMFILE_FORMAT_FAIL == ret) {
+		debug_error ("error: mmfile_format_read_frame\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
+
+#ifdef __MMFILE_TEST_MODE__
+	mmfile_format_print_frame (&frameContext);
+#endif
+
+	formatContext->thumbNail = mmfile_malloc (sizeof(MMFileFormatFrame));
+	if (NULL == formatContext->thumbNail) {
+		debug_error ("error: mmfile_malloc\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
+
+	if (frameContext.bCompressed) {
+		codecFrame.frameDataSize = frameContext.frameSize;
+		codecFrame.width = frameContext.frameWidth;
+		codecFrame.height = frameContext.frameHeight;
+		codecFrame.frameData = frameContext.frameData;
+		codecFrame.configLen = frameContext.configLenth;
+		codecFrame.configData = frameContext.configData;
+		codecFrame.version = videoStream->version;
+
+		ret = funcs->codecFuncs->open (&codecContext, MMFILE_VIDEO_DECODE, videoStream->codecId, &codecFrame);
+		if (MMFILE_FORMAT_FAIL == ret) {
+			debug_error ("error: mmfile_codec_open\n");
+			ret = MM_ERROR_FILE_INTERNAL;
+			goto exception;
+		}
+
+		ret = funcs->codecFuncs->decode (codecContext, &decodedFrame);
+		if (MMFILE_FORMAT_FAIL == ret) {
+			debug_error ("error: mmfile_codec_decode\n");
+			ret = MM_ERROR_FILE_INTERNAL;
+			goto exception;
+		}
+
+		/* set video thumbnail */
+		formatContext->thumbNail->frameSize = decodedFrame.frameDataSize;
+		formatContext->thumbNail->frameWidth = decodedFrame.width;
+		formatContext->thumbNail->frameHeight = decodedFrame.height;
+		formatContext->thumbNail->frameData = decodedFrame.frameData;
+		formatContext->thumbNail->configLenth = 0;
+		formatContext->thumbNail->configData = NULL;
+
+		if (frameContext.frameData) mmfile_free (frameContext.frameData);
+		if (frameContext.configData) mmfile_free (frameContext.configData);
+		if (decodedFrame.configData) mmfile_free (decodedFrame.configData);
+
+		funcs->codecFuncs->close (codecContext);
+	} else {
+		formatContext->thumbNail->frameSize = frameContext.frameSize;
+		formatContext->thumbNail->frameWidth = frameContext.frameWidth;
+		formatContext->thumbNail->frameHeight = frameContext.frameHeight;
+		formatContext->thumbNail->frameData = frameContext.frameData;
+		formatContext->thumbNail->configLenth = 0;
+		formatContext->thumbNail->configData = NULL;
+
+		if (frameContext.configData) mmfile_free (frameContext.configData);
+	}
+
+	return MM_ERROR_NONE;
+
+exception:
+	if (frameContext.frameData) mmfile_free (frameContext.frameData);
+	if (frameContext.configData) mmfile_free (frameContext.configData);
+	if (decodedFrame.frameData) mmfile_free (decodedFrame.frameData);
+	if (decodedFrame.configData) mmfile_free (decodedFrame.configData);
+
+	if (formatContext->thumbNail) mmfile_free (formatContext->thumbNail);
+	if (codecContext) funcs->codecFuncs->close (codecContext);
+
+	return ret;
+}
+
+/* I/O of the last extraction finished on this thread, see mm_file_get_last_io_stats() */
+static __thread MMFileIOStats g_last_io_stats;
 
+static MMFileIOCounters *
+_io_stats_begin (MMFileIOCounters *counters)
+{
+	MMFileIOCounters *prev = mmfile_io_counters_get_current ();
+
+	memset (counters, 0x00, sizeof (MMFileIOCounters));
+	mmfile_io_counters_set_current (counters);
+
+	return prev;
+}
+
+static void
+_io_stats_end (MMFileIOCounters *counters, MMFileIOCounters *prev)
+{
+	mmfile_io_counters_set_current (prev);
+
+	g_last_io_stats.open_count = counters->opens;
+	g_last_io_stats.read_count = counters->reads;
+	g_last_io_stats.read_bytes = counters->bytes;
+	g_last_io_stats.seek_count = counters->seeks;
+	g_last_io_stats.discontiguous_reads = counters->jumps;
+}
+
+static void
+_async_notify (MMFILE_PARSE_INFO *parse, int stage)
+{
+	MMFILE_ASYNC_REQUEST *request = parse->request;
+
+	if (request)
+		request->callback (request->id, stage, MM_ERROR_NONE, 0, request->user_data);
+}
+
+static int
+_get_contents_info (mmf_attrs_t *attrs, MMFileSourceType *src, MMFILE_PARSE_INFO *parse)
+{
+	MMFILE_FUNC_HANDLE   funcs = {0,};
+	MMFileFormatContext *formatContext = NULL;
+	MMFileIOCounters io_counters;
+	MMFileIOCounters *prev_counters = NULL;
+	int abort = MMFILE_ABORT_NONE;
 	int ret = 0;
 	
 	if (!src || !parse)
 		return MM_ERROR_FILE_INTERNAL;
 
-	ret = mmfile_format_open (&formatContext, src);
+	ret = _load_dynamic_functions (&funcs);
+	if (ret == 0) {
+		debug_error ("load library error\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	/* the handles of the extraction are all closed by formatFuncs->close */
+	prev_counters = _io_stats_begin (&io_counters);
+
+	/* the abort state is polled between stages and inside the long parser loops */
+	ret = funcs.formatFuncs->open (&formatContext, src);
 	if (MMFILE_FORMAT_FAIL == ret || formatContext == NULL) {
+		abort = mmfile_abort_check ();
+		if (abort)
+			goto aborted;
+
 		debug_error ("error: mmfile_format_open\n");
 		ret = MM_ERROR_FILE_INTERNAL;
 		goto exception;
 	}
 
+	_async_notify (parse, MM_FILE_ASYNC_STAGE_OPEN);
+
 	/**
-	 * if MM_FILE_PARSE_TYPE_SIMPLE, just get number of each stream.
+	 * if no attribute is wanted, just get number of each stream.
 	 */
 	parse->audio_track_num = formatContext->audioTotalTrackNum;
 	parse->video_track_num = formatContext->videoTotalTrackNum;
 
-	if (parse->type >= MM_FILE_PARSE_TYPE_NORMAL) {
-		ret = mmfile_format_read_stream (formatContext);
+	if (parse->mask) {
+		formatContext->parseMask = parse->mask;
+
+		abort = mmfile_abort_check ();
+		if (abort)
+			goto aborted;
+
+		ret = funcs.formatFuncs->read_stream (formatContext);
 		if (MMFILE_FORMAT_FAIL == ret) {
+			abort = mmfile_abort_check ();
+			if (abort)
+				goto aborted;
+
 			debug_error ("error: mmfile_format_read_stream\n");
 			ret = MM_ERROR_FILE_INTERNAL;
 			goto exception;
 		}
 
-		if (parse->type >= MM_FILE_PARSE_TYPE_ALL) {
-			if (formatContext->videoTotalTrackNum > 0) {
-				MMFileFormatStream *videoStream = formatContext->streams[MMFILE_VIDEO_STREAM];
-				unsigned int timestamp = _SEEK_POINT_;
-				
-				ret = mmfile_format_read_frame (formatContext, timestamp, &frameContext);
-				if (MMFILE_FORMAT_FAIL == ret) {
-					debug_error ("error: mmfile_format_read_frame\n");
-					ret = MM_ERROR_FILE_INTERNAL;
-					goto warning;
-				}
+		_async_notify (parse, MM_FILE_ASYNC_STAGE_STREAM);
 
-				if (frameContext.bCompressed) {
-					codecFrame.frameDataSize = frameContext.frameSize;
-					codecFrame.width = frameContext.frameWidth;
-					codecFrame.height = frameContext.frameHeight;
-					codecFrame.frameData = frameContext.frameData;
-					codecFrame.configLen = frameContext.configLenth;
-					codecFrame.configData = frameContext.configData;
-					codecFrame.version = videoStream->version;
-
-					ret = mmfile_codec_open (&codecContext, MMFILE_VIDEO_DECODE, videoStream->codecId, &codecFrame);
-					if (MMFILE_FORMAT_FAIL == ret) {
-						debug_error ("error: mmfile_codec_open\n");
-						ret = MM_ERROR_FILE_INTERNAL;
-						goto warning;
-					}
-
-					ret = mmfile_codec_decode (codecContext, &decodedFrame);
-					if (MMFILE_FORMAT_FAIL == ret) {
-						debug_error ("error: mmfile_codec_decode\n");
-						ret = MM_ERROR_FILE_INTERNAL;
-						goto warning;
-					}
-					
-					/* set video thumbnail */
-					formatContext->thumbNail = mmfile_malloc (sizeof(MMFileFormatFrame));
-					if (NULL == formatContext->thumbNail) {
-						debug_error ("error: mmfile_malloc\n");
-						ret = MM_ERROR_FILE_INTERNAL;
-						goto warning;
-					}
-
-					formatContext->thumbNail->frameSize = decodedFrame.frameDataSize;
-					formatContext->thumbNail->frameWidth = decodedFrame.width;
-					formatContext->thumbNail->frameHeight = decodedFrame.height;
-					formatContext->thumbNail->frameData = decodedFrame.frameData;
-					formatContext->thumbNail->configLenth = 0;
-					formatContext->thumbNail->configData = NULL;
-				} else {
-					formatContext->thumbNail = mmfile_malloc (sizeof(MMFileFormatFrame));
-					if (NULL == formatContext->thumbNail) {
-						debug_error ("error: mmfile_format_read_frame\n");
-						ret = MM_ERROR_FILE_INTERNAL;
-						goto warning;
-					}
-
-					formatContext->thumbNail->frameSize = frameContext.frameSize;
-					formatContext->thumbNail->frameWidth = frameContext.frameWidth;
-					formatContext->thumbNail->frameHeight = frameContext.frameHeight;
-					formatContext->thumbNail->frameData = frameContext.frameData;
-					formatContext->thumbNail->configLenth = 0;
-					formatContext->thumbNail->configData = NULL;
-				}
+		if (parse->mask & MM_FILE_WANT_THUMBNAIL) {
+			abort = mmfile_abort_check ();
+			if (abort)
+				goto aborted;
+
+			/* missing thumbnail is not an error, the other attributes are still valid */
+			ret = _get_video_thumbnail (&funcs, formatContext);
+			if (ret != MM_ERROR_NONE) {
+				debug_error ("error: _get_video_thumbnail\n");
 			}
+
+			abort = mmfile_abort_check ();
+			if (abort)
+				goto aborted;
+
+			_async_notify (parse, MM_FILE_ASYNC_STAGE_THUMBNAIL);
 		}
 	}
 
-#ifdef __MMFILE_TEST_MODE__
-	mmfile_format_print_frame (&frameContext);
-#endif
-
 	formatContext->commandType = MM_FILE_CONTENTS;
 
-	if (parse->type >= MM_FILE_PARSE_TYPE_NORMAL)
+	if (parse->content_info)
+		_info_fill_content (parse->content_info, formatContext);
+	else if (parse->mask)
 		_info_set_attr_media (attrs, formatContext);
 
-	if (frameContext.bCompressed) {
-		if (frameContext.frameData) mmfile_free (frameContext.frameData); 
-		if (frameContext.configData) mmfile_free (frameContext.configData);
-
-		if (decodedFrame.frameData) {
-			mmfile_free (decodedFrame.frameData);
-			formatContext->thumbNail->frameData = NULL;
-		}
-		if (decodedFrame.configData) {
-			mmfile_free (decodedFrame.configData);
-			formatContext->thumbNail->configData = NULL;
-		}
-	} else {
-		if (frameContext.frameData) {
-			mmfile_free (frameContext.frameData); 
-			formatContext->thumbNail->frameData = NULL;
-		}
-		if (frameContext.configData) {
-			mmfile_free (frameContext.configData);
-			formatContext->thumbNail->configData = NULL;
-		}
-	}
-
-	if (formatContext)  { mmfile_format_close (formatContext); }
-	if (codecContext)   { mmfile_codec_close (codecContext); }
+	if (formatContext)  { funcs.formatFuncs->close (formatContext); }
+	_io_stats_end (&io_counters, prev_counters);
+	_unload_dynamic_functions (&funcs);
 
 	return MM_ERROR_NONE;
 
-warning:
-	formatContext->commandType = MM_FILE_CONTENTS;
+aborted:
+	/* a cancelled request drops everything, a deadline keeps what is parsed so far */
+	if (abort != MMFILE_ABORT_EXPIRED) {
+		debug_warning ("extraction is cancelled\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
 
-	if (frameContext.bCompressed) {
-		if (frameContext.frameData)
-			mmfile_free (frameContext.frameData); 
+	debug_warning ("deadline expired, attributes are incomplete\n");
+	parse->incomplete = 1;
 
-		if (frameContext.configData) 
-			mmfile_free (frameContext.configData);
+	if (parse->content_info) {
+		parse->content_info->incomplete = 1;
 
-		if (decodedFrame.frameData) {
-			mmfile_free (decodedFrame.frameData);
-			formatContext->thumbNail->frameData = NULL;
-		}
+		if (formatContext)
+			_info_fill_content (parse->content_info, formatContext);
+	} else if (attrs) {
+		mm_attrs_set_int_by_name (CAST_MM_HANDLE (attrs), MM_FILE_CONTENT_INCOMPLETE, 1);
 
-		if (decodedFrame.configData) {
-			mmfile_free (decodedFrame.configData);
-			formatContext->thumbNail->configData = NULL;
-		}
-	} else {
-		if (frameContext.frameData) {
-			mmfile_free (frameContext.frameData); 
-			formatContext->thumbNail->frameData = NULL;
-		}
-		
-		if (frameContext.configData) {
-			mmfile_free (frameContext.configData);
-			formatContext->thumbNail->configData = NULL;
+		if (formatContext) {
+			formatContext->commandType = MM_FILE_CONTENTS;
+			_info_set_attr_media (attrs, formatContext);
+		} else {
+			mmf_attrs_commit (CAST_MM_HANDLE (attrs));
 		}
 	}
 
-	if (parse->type >= MM_FILE_PARSE_TYPE_NORMAL)
-		_info_set_attr_media (attrs, formatContext);
+	if (formatContext)  { funcs.formatFuncs->close (formatContext); }
+	_io_stats_end (&io_counters, prev_counters);
+	_unload_dynamic_functions (&funcs);
 
-	if (formatContext)  { mmfile_format_close (formatContext); }
-	if (codecContext)   { mmfile_codec_close (codecContext); }
 	return MM_ERROR_NONE;
 
-
 exception:
-	if (frameContext.bCompressed) {
-		if (frameContext.frameData)
-			mmfile_free (frameContext.frameData); 
-
-		if (frameContext.configData) 
-			mmfile_free (frameContext.configData);
-
-		if (decodedFrame.frameData) {
-			mmfile_free (decodedFrame.frameData);
-			formatContext->thumbNail->frameData = NULL;
-		}
-
-		if (decodedFrame.configData) {
-			mmfile_free (decodedFrame.configData);
-			formatContext->thumbNail->configData = NULL;
-		}
-	} else {
-		if (frameContext.frameData) {
-			mmfile_free (frameContext.frameData); 
-			formatContext->thumbNail->frameData = NULL;
-		}
-		
-		if (frameContext.configData) {
-			mmfile_free (frameContext.configData);
-			formatContext->thumbNail->configData = NULL;
-		}
-	}
-
-	if (formatContext)  { mmfile_format_close (formatContext); }
-	// if (codecContext)   { mmfile_codec_close (codecContext); }	/*dead code*/
+	if (formatContext)  { funcs.formatFuncs->close (formatContext); }
+	_io_stats_end (&io_counters, prev_counters);
+	_unload_dynamic_functions (&funcs);
 
 	return ret;
 }
 
 
 static int
-_get_tag_info (mmf_attrs_t *attrs, MMFileSourceType *src)
+_get_tag_info (mmf_attrs_t *attrs, MMFileSourceType *src, MMFileTagInfo *tag_info)
 {
+	MMFILE_FUNC_HANDLE   funcs = {0,};
 	MMFileFormatContext *formatContext = NULL;
+	MMFileIOCounters io_counters;
+	MMFileIOCounters *prev_counters = NULL;
 	int ret = 0;
 
-	ret = mmfile_format_open (&formatContext, src);
+	ret = _load_dynamic_functions (&funcs);
+	if (ret == 0) {
+		debug_error ("load library error\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	prev_counters = _io_stats_begin (&io_counters);
+
+	ret = funcs.formatFuncs->open (&formatContext, src);
 	if (MMFILE_FORMAT_FAIL == ret || formatContext == NULL) {
 		debug_error ("error: mmfile_format_open\n");
 		ret = MM_ERROR_FILE_INTERNAL;
 		goto exception;
 	}
 
-	ret = mmfile_format_read_tag (formatContext);
+	ret = funcs.formatFuncs->read_tag (formatContext);
 	if (MMFILE_FORMAT_FAIL == ret) {
 		debug_warning ("reading tag is fail\n");
 		ret = MM_ERROR_FILE_INTERNAL;
@@ -605,19 +823,229 @@ _get_tag_info (mmf_attrs_t *attrs, MMFileSourceType *src)
 
 	formatContext->commandType = MM_FILE_TAG;
 
-	_info_set_attr_media (attrs, formatContext);
+	if (tag_info)
+		_info_fill_tag (tag_info, formatContext);
+	else
+		_info_set_attr_media (attrs, formatContext);
 
-	if (formatContext)  { mmfile_format_close (formatContext); }
+	if (formatContext)  { funcs.formatFuncs->close (formatContext); }
+	_io_stats_end (&io_counters, prev_counters);
+	_unload_dynamic_functions (&funcs);
 
 	return MM_ERROR_NONE;
 
 
 exception:
-	if (formatContext)  { mmfile_format_close (formatContext); }
+	if (formatContext)  { funcs.formatFuncs->close (formatContext); }
+	_io_stats_end (&io_counters, prev_counters);
+	_unload_dynamic_functions (&funcs);
 
 	return MM_ERROR_FILE_INTERNAL;
 }
 
+/**
+ * metadata cache.
+ * a record is a list of attribute index and value, in the order of g_xxx_attrs.
+ * int and double are stored as is, string as length (with nul) and bytes.
+ * unset (default) values are not stored.
+ */
+enum {
+	MM_FILE_CACHE_CONTENT = 1,
+	MM_FILE_CACHE_TAG,
+};
+
+/* extraction takes the read lock, enable/disable replace the cache under the write lock */
+static MMFileCache *g_cache = NULL;
+static pthread_rwlock_t g_cache_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static int
+_cache_pack_attrs (MMHandleType hattrs, mmf_attrs_construct_info_t *info, int num, int skip_data, unsigned char *buf, unsigned int *size)
+{
+	unsigned int pos = 0;
+	unsigned int len = 0;
+	int i = 0;
+
+	for (i = 0; i < num; i++) {
+		int ival = 0;
+		double dval = 0;
+		char *sval = NULL;
+		void *data = NULL;
+
+		switch (info[i].value_type) {
+		case MMF_VALUE_TYPE_INT:
+			mm_attrs_get_int_by_name (hattrs, info[i].name, &ival);
+			if (ival == 0)
+				continue;
+			if (pos + 1 + sizeof (int) > MMFILE_CACHE_DATA_MAX)
+				return -1;
+			buf[pos++] = i;
+			memcpy (buf + pos, &ival, sizeof (int));
+			pos += sizeof (int);
+			break;
+
+		case MM_ATTRS_TYPE_DOUBLE:
+			mm_attrs_get_double_by_name (hattrs, info[i].name, &dval);
+			if (dval == 0)
+				continue;
+			if (pos + 1 + sizeof (double) > MMFILE_CACHE_DATA_MAX)
+				return -1;
+			buf[pos++] = i;
+			memcpy (buf + pos, &dval, sizeof (double));
+			pos += sizeof (double);
+			break;
+
+		case MMF_VALUE_TYPE_STRING:
+			mm_attrs_get_string_by_name (hattrs, info[i].name, &sval);
+			if (sval == NULL)
+				continue;
+			len = strlen (sval) + 1;
+			if (pos + 1 + sizeof (int) + len > MMFILE_CACHE_DATA_MAX)
+				return -1;
+			buf[pos++] = i;
+			memcpy (buf + pos, &len, sizeof (int));
+			pos += sizeof (int);
+			memcpy (buf + pos, sval, len);
+			pos += len;
+			break;
+
+		default:
+			/* buffers like artwork are not cached, a record without them would be wrong */
+			mm_attrs_get_data_by_name (hattrs, info[i].name, &data);
+			if (data && !skip_data)
+				return -1;
+			break;
+		}
+	}
+
+	*size = pos;
+
+	return 0;
+}
+
+/**
+ * with apply 0 the record is only checked, so a broken record leaves attrs untouched.
+ */
+static int
+_cache_unpack_attrs (MMHandleType hattrs, mmf_attrs_construct_info_t *info, int num, const unsigned char *buf, unsigned int size, int apply)
+{
+	unsigned int pos = 0;
+	unsigned int len = 0;
+	int ival = 0;
+	double dval = 0;
+	int i = 0;
+
+	while (pos < size) {
+		i = buf[pos++];
+		if (i >= num)
+			return -1;
+
+		switch (info[i].value_type) {
+		case MMF_VALUE_TYPE_INT:
+			if (pos + sizeof (int) > size)
+				return -1;
+			memcpy (&ival, buf + pos, sizeof (int));
+			pos += sizeof (int);
+			if (apply)
+				mm_attrs_set_int_by_name (hattrs, info[i].name, ival);
+			break;
+
+		case MM_ATTRS_TYPE_DOUBLE:
+			if (pos + sizeof (double) > size)
+				return -1;
+			memcpy (&dval, buf + pos, sizeof (double));
+			pos += sizeof (double);
+			if (apply)
+				mm_attrs_set_double_by_name (hattrs, info[i].name, dval);
+			break;
+
+		case MMF_VALUE_TYPE_STRING:
+			if (pos + sizeof (int) > size)
+				return -1;
+			memcpy (&len, buf + pos, sizeof (int));
+			pos += sizeof (int);
+			if (len == 0 || pos + len > size || buf[pos + len - 1] != '\0')
+				return -1;
+			if (apply)
+				mm_attrs_set_string_by_name (hattrs, info[i].name, (const char *)(buf + pos));
+			pos += len;
+			break;
+
+		default:
+			return -1;
+		}
+	}
+
+	return apply ? mmf_attrs_commit (hattrs) : 0;
+}
+
+/**
+ * fills attrs from the cache if the file is unchanged and the record covers mask.
+ * key is set for _cache_store_attrs() in any case.
+ */
+static int
+_cache_load_attrs (mmf_attrs_t *attrs, const char *path, unsigned int kind, unsigned int mask, MMFileCacheKey *key)
+{
+	mmf_attrs_construct_info_t *info = (kind == MM_FILE_CACHE_CONTENT) ? g_content_attrs : g_tag_attrs;
+	int num = (kind == MM_FILE_CACHE_CONTENT) ? ARRAY_SIZE (g_content_attrs) : ARRAY_SIZE (g_tag_attrs);
+	unsigned char buf[MMFILE_CACHE_DATA_MAX];
+	unsigned int cached_mask = 0;
+	unsigned int size = 0;
+	int found = 0;
+
+	memset (key, 0x00, sizeof (MMFileCacheKey));
+
+	pthread_rwlock_rdlock (&g_cache_lock);
+
+	if (g_cache && mmfile_cache_make_key (path, key) == MMFILE_UTIL_SUCCESS)
+		found = (mmfile_cache_lookup (g_cache, key, kind, &cached_mask, buf, &size) == MMFILE_UTIL_SUCCESS);
+
+	pthread_rwlock_unlock (&g_cache_lock);
+
+	if (!found || (cached_mask & mask) != mask)
+		return 0;
+
+	/* a broken record is left to the parser, attrs are only written once it checked out */
+	if (_cache_unpack_attrs (CAST_MM_HANDLE (attrs), info, num, buf, size, 0) != 0)
+		return 0;
+
+	/* served without reading the file */
+	memset (&g_last_io_stats, 0x00, sizeof (MMFileIOStats));
+
+	return _cache_unpack_attrs (CAST_MM_HANDLE (attrs), info, num, buf, size, 1) == 0;
+}
+
+static void
+_cache_store_attrs (mmf_attrs_t *attrs, unsigned int kind, unsigned int mask, const MMFileCacheKey *key)
+{
+	MMHandleType hattrs = CAST_MM_HANDLE (attrs);
+	unsigned char buf[MMFILE_CACHE_DATA_MAX];
+	unsigned int size = 0;
+	void *thumbnail = NULL;
+	int ret = 0;
+
+	if (key->ino == 0)
+		return;
+
+	if (kind == MM_FILE_CACHE_CONTENT) {
+		/* the thumbnail itself is not cached, so the record does not cover it */
+		mm_attrs_get_data_by_name (hattrs, MM_FILE_CONTENT_VIDEO_THUMBNAIL, &thumbnail);
+		if (thumbnail)
+			mask &= ~MM_FILE_WANT_THUMBNAIL;
+
+		ret = _cache_pack_attrs (hattrs, g_content_attrs, ARRAY_SIZE (g_content_attrs), 1, buf, &size);
+	} else {
+		ret = _cache_pack_attrs (hattrs, g_tag_attrs, ARRAY_SIZE (g_tag_attrs), 0, buf, &size);
+	}
+
+	if (ret != 0)
+		return;
+
+	pthread_rwlock_rdlock (&g_cache_lock);
+	if (g_cache)
+		mmfile_cache_store (g_cache, key, kind, mask, buf, size);
+	pthread_rwlock_unlock (&g_cache_lock);
+}
+
 
 /**
  * global functions.
@@ -706,6 +1134,7 @@ int mm_file_create_tag_attrs(MMHandleType *tag_attrs, const char *filename)
 	int ret = MM_ERROR_NONE;
 	mmf_attrs_t *attrs = NULL;
 	MMFileSourceType src;
+	MMFileCacheKey key;
 
 	debug_fenter ();
 
@@ -724,16 +1153,6 @@ int mm_file_create_tag_attrs(MMHandleType *tag_attrs, const char *filename)
 	}
 
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
-	
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-#endif
-
 	/*set source file infomation*/
 	MM_FILE_SET_MEDIA_FILE_SRC (src, filename);
 
@@ -748,7 +1167,12 @@ int mm_file_create_tag_attrs(MMHandleType *tag_attrs, const char *filename)
 		return MM_ERROR_FILE_INTERNAL;
 	}
 
-	ret = _get_tag_info (attrs, &src);
+	if (_cache_load_attrs (attrs, src.file.path, MM_FILE_CACHE_TAG, 0, &key)) {
+		*tag_attrs = (MMHandleType)attrs;
+		return MM_ERROR_NONE;
+	}
+
+	ret = _get_tag_info (attrs, &src, NULL);
 
 #ifdef __MMFILE_TEST_MODE__
 	if (ret != MM_ERROR_NONE) {
@@ -756,11 +1180,10 @@ int mm_file_create_tag_attrs(MMHandleType *tag_attrs, const char *filename)
 	}
 #endif
 
-	*tag_attrs = (MMHandleType)attrs;
+	if (ret == MM_ERROR_NONE)
+		_cache_store_attrs (attrs, MM_FILE_CACHE_TAG, 0, &key);
 
-#ifdef __MMFILE_DYN_LOADING__
-	_unload_dynamic_functions (&func_handle);
-#endif
+	*tag_attrs = (MMHandleType)attrs;
 
 	debug_fleave ();
 
@@ -800,12 +1223,15 @@ int mm_file_destroy_tag_attrs(MMHandleType tag_attrs)
 	return ret;
 }
 
-EXPORT_API
-int mm_file_create_content_attrs (MMHandleType *contents_attrs, const char *filename)
+static int
+_create_content_attrs (MMHandleType *contents_attrs, const char *filename, int mask, int deadline, MMFILE_ASYNC_REQUEST *request)
 {
 	mmf_attrs_t *attrs = NULL;
 	MMFileSourceType src = {0,};
 	MMFILE_PARSE_INFO parse = {0,};
+	MMFileCacheKey key;
+	MMFileAbort abort = {0,};
+	MMFileAbort *prev_abort = NULL;
 	int ret = 0;
 
 	debug_fenter ();
@@ -825,26 +1251,6 @@ int mm_file_create_content_attrs (MMHandleType *contents_attrs, const char *file
 	}
 
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
-
-	#ifdef CHECK_TIME
-	 int64_t ti;
-	ti = gettime();
-	#endif 
-	
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-
-	#ifdef CHECK_TIME
-	printf ("%s, %d, _load_dynamic_functions() = %lld\n", __func__, __LINE__, gettime() - ti);
-       #endif
-	 
-#endif
-
 	/*set source file infomation*/
 	MM_FILE_SET_MEDIA_FILE_SRC (src, filename);
 
@@ -860,32 +1266,90 @@ int mm_file_create_content_attrs (MMHandleType *contents_attrs, const char *file
 	}
 	
 
-	parse.type = MM_FILE_PARSE_TYPE_ALL;
+	parse.mask = mask & MM_FILE_WANT_ALL;
+	parse.request = request;
+
+	if (_cache_load_attrs (attrs, src.file.path, MM_FILE_CACHE_CONTENT, parse.mask, &key)) {
+		*contents_attrs = (MMHandleType) attrs;
+		return MM_ERROR_NONE;
+	}
+
+	if (deadline > 0) {
+		prev_abort = mmfile_abort_get_current ();
+		if (prev_abort)
+			abort.cancelled = mmfile_abort_is_cancelled (prev_abort);
+		abort.deadline = mmfile_abort_get_time () + deadline;
+		mmfile_abort_set_current (&abort);
+	}
+
 	ret = _get_contents_info (attrs, &src, &parse);
 
+	if (deadline > 0)
+		mmfile_abort_set_current (prev_abort);
+
 #ifdef __MMFILE_TEST_MODE__
 	if (ret != MM_ERROR_NONE) {
 		debug_error ("failed to get contents: %s\n", filename);
 	}
 #endif
 
+	if (ret == MM_ERROR_NONE && !parse.incomplete)
+		_cache_store_attrs (attrs, MM_FILE_CACHE_CONTENT, parse.mask, &key);
+
 	*contents_attrs = (MMHandleType) attrs;
 
 
-#ifdef __MMFILE_DYN_LOADING__
+	debug_fleave ();
 
-	#ifdef CHECK_TIME 
-	ti = gettime();
-	#endif
+	return ret;
+}
 
-	_unload_dynamic_functions (&func_handle);
+EXPORT_API
+int mm_file_create_content_attrs_ex (MMHandleType *contents_attrs, const char *filename, int mask)
+{
+	return _create_content_attrs (contents_attrs, filename, mask, 0, NULL);
+}
 
-	#ifdef CHECK_TIME
-	printf ("%s, %d, _unload_dynamic_functions() = %lld\n", __func__, __LINE__, gettime() - ti);
-	#endif
+EXPORT_API
+int mm_file_create_content_attrs_with_deadline (MMHandleType *contents_attrs, const char *filename, int mask, int deadline)
+{
+	return _create_content_attrs (contents_attrs, filename, mask, deadline, NULL);
+}
 
-#endif
+EXPORT_API
+int mm_file_create_content_attrs (MMHandleType *contents_attrs, const char *filename)
+{
+	return mm_file_create_content_attrs_ex (contents_attrs, filename, MM_FILE_PARSE_MASK_ALL);
+}
+
+
+EXPORT_API
+int mm_file_create_tag_attrs_from_memory (MMHandleType *tag_attrs, const void *data, unsigned int size, int format)
+{
+	mmf_attrs_t *attrs = NULL;
+	MMFileSourceType src;
+	int ret = 0;
+
+	debug_fenter ();
+
+	/* Check argument here */
+	if (tag_attrs == NULL || data == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	MM_FILE_SET_MEDIA_MEM_SRC (src, data, size, format);
+
+	/*set attrs*/
+	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("tag", g_tag_attrs, ARRAY_SIZE (g_tag_attrs), NULL, NULL);
+	if (!attrs) {
+		debug_error ("attribute internal error.\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	ret = _get_tag_info (attrs, &src, NULL);
 
+	*tag_attrs = (MMHandleType)attrs;
 
 	debug_fleave ();
 
@@ -894,7 +1358,7 @@ int mm_file_create_content_attrs (MMHandleType *contents_attrs, const char *file
 
 
 EXPORT_API
-int mm_file_create_tag_attrs_from_memory (MMHandleType *tag_attrs, const void *data, unsigned int size, int format)
+int mm_file_create_content_attrs_from_memory (MMHandleType *contents_attrs, const void *data, unsigned int size, int format)
 {
 	mmf_attrs_t *attrs = NULL;
 	MMFileSourceType src;
@@ -904,22 +1368,47 @@ int mm_file_create_tag_attrs_from_memory (MMHandleType *tag_attrs, const void *d
 	debug_fenter ();
 
 	/* Check argument here */
-	if (tag_attrs == NULL || data == NULL) {
+	if (contents_attrs == NULL || data == NULL) {
 		debug_error ("Invalid arguments\n");
 		return MM_ERROR_INVALID_ARGUMENT;
 	}
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
+	MM_FILE_SET_MEDIA_MEM_SRC (src, data, size, format);
 
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
+	/*set attrs*/
+	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("content", g_content_attrs, ARRAY_SIZE (g_content_attrs), NULL, NULL);
+	if (!attrs) {
+		debug_error ("attribute internal error.\n");
 		return MM_ERROR_FILE_INTERNAL;
 	}
-#endif
 
-	MM_FILE_SET_MEDIA_MEM_SRC (src, data, size, format);
+	parse.mask = MM_FILE_PARSE_MASK_ALL;
+	ret = _get_contents_info (attrs, &src, &parse);
+
+	*contents_attrs = (MMHandleType)attrs;
+
+	debug_fleave ();
+
+	return ret;
+}
+
+
+EXPORT_API
+int mm_file_create_tag_attrs_from_callbacks (MMHandleType *tag_attrs, const MMFileIOCallbacks *callbacks, void *user_data)
+{
+	mmf_attrs_t *attrs = NULL;
+	MMFileSourceType src;
+	int ret = 0;
+
+	debug_fenter ();
+
+	/* Check argument here */
+	if (tag_attrs == NULL || callbacks == NULL || callbacks->read == NULL || callbacks->seek == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	MM_FILE_SET_MEDIA_CALLBACK_SRC (src, callbacks->read, callbacks->seek, callbacks->size, user_data);
 
 	/*set attrs*/
 	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("tag", g_tag_attrs, ARRAY_SIZE (g_tag_attrs), NULL, NULL);
@@ -928,15 +1417,10 @@ int mm_file_create_tag_attrs_from_memory (MMHandleType *tag_attrs, const void *d
 		return MM_ERROR_FILE_INTERNAL;
 	}
 
-	parse.type = MM_FILE_PARSE_TYPE_ALL;
-	ret = _get_tag_info (attrs, &src);
+	ret = _get_tag_info (attrs, &src, NULL);
 
 	*tag_attrs = (MMHandleType)attrs;
 
-#ifdef __MMFILE_DYN_LOADING__
-	_unload_dynamic_functions (&func_handle);
-#endif
-
 	debug_fleave ();
 
 	return ret;
@@ -944,7 +1428,7 @@ int mm_file_create_tag_attrs_from_memory (MMHandleType *tag_attrs, const void *d
 
 
 EXPORT_API
-int mm_file_create_content_attrs_from_memory (MMHandleType *contents_attrs, const void *data, unsigned int size, int format)
+int mm_file_create_content_attrs_from_callbacks (MMHandleType *contents_attrs, const MMFileIOCallbacks *callbacks, void *user_data)
 {
 	mmf_attrs_t *attrs = NULL;
 	MMFileSourceType src;
@@ -954,22 +1438,12 @@ int mm_file_create_content_attrs_from_memory (MMHandleType *contents_attrs, cons
 	debug_fenter ();
 
 	/* Check argument here */
-	if (contents_attrs == NULL || data == NULL) {
+	if (contents_attrs == NULL || callbacks == NULL || callbacks->read == NULL || callbacks->seek == NULL) {
 		debug_error ("Invalid arguments\n");
 		return MM_ERROR_INVALID_ARGUMENT;
 	}
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
-	
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-#endif
-
-	MM_FILE_SET_MEDIA_MEM_SRC (src, data, size, format);
+	MM_FILE_SET_MEDIA_CALLBACK_SRC (src, callbacks->read, callbacks->seek, callbacks->size, user_data);
 
 	/*set attrs*/
 	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("content", g_content_attrs, ARRAY_SIZE (g_content_attrs), NULL, NULL);
@@ -978,15 +1452,11 @@ int mm_file_create_content_attrs_from_memory (MMHandleType *contents_attrs, cons
 		return MM_ERROR_FILE_INTERNAL;
 	}
 
-	parse.type = MM_FILE_PARSE_TYPE_ALL;
+	parse.mask = MM_FILE_PARSE_MASK_ALL;
 	ret = _get_contents_info (attrs, &src, &parse);
 
 	*contents_attrs = (MMHandleType)attrs;
 
-#ifdef __MMFILE_DYN_LOADING__
-	_unload_dynamic_functions (&func_handle);
-#endif
-
 	debug_fleave ();
 
 	return ret;
@@ -1033,16 +1503,6 @@ int mm_file_get_stream_info(const char* filename, int *audio_stream_num, int *vi
 		return MM_ERROR_INVALID_ARGUMENT;
 	}
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
-
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-#endif
-
 	/*set source file infomation*/
 	MM_FILE_SET_MEDIA_FILE_SRC (src, filename);
 
@@ -1050,7 +1510,7 @@ int mm_file_get_stream_info(const char* filename, int *audio_stream_num, int *vi
 	if (!ret)
 		return MM_ERROR_FILE_NOT_FOUND;
 
-	parse.type = MM_FILE_PARSE_TYPE_SIMPLE;
+	parse.mask = MM_FILE_PARSE_MASK_SIMPLE;
 	ret = _get_contents_info (NULL, &src, &parse);
 #ifdef __MMFILE_TEST_MODE__
 	if (ret != MM_ERROR_NONE) {
@@ -1062,10 +1522,6 @@ int mm_file_get_stream_info(const char* filename, int *audio_stream_num, int *vi
 	*audio_stream_num = parse.audio_track_num;
 	*video_stream_num = parse.video_track_num;
 
-#ifdef __MMFILE_DYN_LOADING__
-	_unload_dynamic_functions (&func_handle);
-#endif
-
 	debug_fleave ();
 
 	return ret;
@@ -1074,29 +1530,25 @@ int mm_file_get_stream_info(const char* filename, int *audio_stream_num, int *vi
 EXPORT_API
 int mm_file_create_content_attrs_simple(MMHandleType *contents_attrs, const char *filename)
 {
-	mmf_attrs_t *attrs = NULL;
+	return mm_file_create_content_attrs_ex (contents_attrs, filename, MM_FILE_PARSE_MASK_NORMAL);
+}
+
+EXPORT_API
+int mm_file_get_content_info (const char *filename, int mask, MMFileContentInfo *info)
+{
 	MMFileSourceType src = {0,};
 	MMFILE_PARSE_INFO parse = {0,};
 	int ret = 0;
 
 	debug_fenter ();
 
-#ifdef __MMFILE_DYN_LOADING__
-	MMFILE_FUNC_HANDLE func_handle;
-	
-	ret = _load_dynamic_functions (&func_handle);
-	if (ret == 0) {
-		debug_error ("load library error\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-#endif
-	if (filename == NULL) { 
+	if (filename == NULL || strlen (filename) == 0 || info == NULL) {
+		debug_error ("Invalid arguments\n");
 		return MM_ERROR_INVALID_ARGUMENT;
-	} else {
-		if (strlen (filename) == 0)
-			return MM_ERROR_INVALID_ARGUMENT;
 	}
 
+	memset (info, 0x00, sizeof (MMFileContentInfo));
+
 	/*set source file infomation*/
 	MM_FILE_SET_MEDIA_FILE_SRC (src, filename);
 
@@ -1104,65 +1556,947 @@ int mm_file_create_content_attrs_simple(MMHandleType *contents_attrs, const char
 	if (!ret)
 		return MM_ERROR_FILE_NOT_FOUND;
 
-	/*set attrs*/
-	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("content", g_content_attrs, ARRAY_SIZE (g_content_attrs), NULL, NULL);
-	if (!attrs) {
-		debug_error ("attribute internal error.\n");
-		return MM_ERROR_FILE_INTERNAL;
-	}
-
-	parse.type = MM_FILE_PARSE_TYPE_NORMAL;
-	ret = _get_contents_info (attrs, &src, &parse);
+	parse.mask = mask & MM_FILE_WANT_ALL;
+	parse.content_info = info;
 
-#ifdef __MMFILE_TEST_MODE__
+	ret = _get_contents_info (NULL, &src, &parse);
 	if (ret != MM_ERROR_NONE) {
 		debug_error ("failed to get contents: %s\n", filename);
+		mm_file_free_content_info (info);
 	}
-#endif
 
-	*contents_attrs = (MMHandleType) attrs;
+	debug_fleave ();
 
-#ifdef __MMFILE_DYN_LOADING__
-	_unload_dynamic_functions (&func_handle);
-#endif
+	return ret;
+}
+
+EXPORT_API
+int mm_file_free_content_info (MMFileContentInfo *info)
+{
+	if (info == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+
+	if (info->thumbnail) mmfile_free (info->thumbnail);
+	info->thumbnail_size = 0;
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_get_tag_info (const char *filename, MMFileTagInfo *info)
+{
+	MMFileSourceType src = {0,};
+	int ret = 0;
+
+	debug_fenter ();
+
+	if (filename == NULL || strlen (filename) == 0 || info == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	memset (info, 0x00, sizeof (MMFileTagInfo));
+
+	/*set source file infomation*/
+	MM_FILE_SET_MEDIA_FILE_SRC (src, filename);
+
+	ret = _is_file_exist (filename);
+	if (!ret)
+		return MM_ERROR_FILE_NOT_FOUND;
+
+	ret = _get_tag_info (NULL, &src, info);
+	if (ret != MM_ERROR_NONE) {
+		debug_error ("failed to get tag: %s\n", filename);
+		mm_file_free_tag_info (info);
+	}
 
 	debug_fleave ();
 
 	return ret;
 }
 
+EXPORT_API
+int mm_file_free_tag_info (MMFileTagInfo *info)
+{
+	if (info == NULL)
+		return MM_ERROR_INVALID_ARGUMENT;
+
+	if (info->title)			mmfile_free (info->title);
+	if (info->artist)			mmfile_free (info->artist);
+	if (info->author)			mmfile_free (info->author);
+	if (info->album)			mmfile_free (info->album);
+	if (info->copyright)		mmfile_free (info->copyright);
+	if (info->description)		mmfile_free (info->description);
+	if (info->genre)			mmfile_free (info->genre);
+	if (info->classification)	mmfile_free (info->classification);
+	if (info->date)				mmfile_free (info->date);
+	if (info->track_num)		mmfile_free (info->track_num);
+	if (info->rating)			mmfile_free (info->rating);
+	if (info->conductor)		mmfile_free (info->conductor);
+	if (info->recdate)			mmfile_free (info->recdate);
+	if (info->unsynclyrics)		mmfile_free (info->unsynclyrics);
+	if (info->artwork)			mmfile_free (info->artwork);
+	if (info->artwork_mime)		mmfile_free (info->artwork_mime);
+	info->artwork_size = 0;
+
+	if (info->synclyrics) {
+		mm_file_free_synclyrics_list (info->synclyrics);
+		info->synclyrics = NULL;
+	}
+	info->synclyrics_num = 0;
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_get_tag_info_synclyrics (const MMFileTagInfo *info, int index, unsigned long *time_info, char **lyrics)
+{
+	AvSynclyricsInfo *sync_lyric_item = NULL;
+
+	if (info == NULL || time_info == NULL || lyrics == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	sync_lyric_item = (AvSynclyricsInfo *) g_list_nth_data (info->synclyrics, index);
+	if (sync_lyric_item == NULL)
+		return MM_ERROR_COMMON_ATTR_NOT_EXIST;
+
+	*time_info = sync_lyric_item->time_info;
+	*lyrics = sync_lyric_item->lyric_info;
+
+	return MM_ERROR_NONE;
+}
+
 EXPORT_API
 int mm_file_get_video_frame(const char* path, double timestamp, bool keyframe, unsigned char **data, int *size, int *width, int *height)
 {
 	int ret = 0;
-	void *formatFuncHandle = NULL;
-#ifdef __MMFILE_DYN_LOADING__
-	/* Get from function argument */
-	formatFuncHandle = dlopen (MMFILE_FORMAT_SO_FILE_NAME, RTLD_LAZY);
-	if (!formatFuncHandle) {
-		debug_error ("error : dlopen");
-		goto exception;
-	}
+	MMFILE_FUNC_HANDLE func_handle = {0,};
 
-	mmfile_format_get_frame = dlsym (formatFuncHandle, "mmfile_format_get_frame");
-	if ( !mmfile_format_get_frame ) {
+	ret = _load_dynamic_functions (&func_handle);
+	if (ret == 0) {
 		debug_error ("error : load library");
-		goto exception;
+		return MM_ERROR_FILE_INTERNAL;
 	}
-#endif
-	ret = mmfile_format_get_frame(path, timestamp, keyframe, data, size, width, height);
+
+	ret = func_handle.formatFuncs->get_frame (path, timestamp, keyframe, data, size, width, height);
 	if (ret  == MMFILE_FORMAT_FAIL) {
 		debug_error ("error : get frame");
 		goto exception;
 	}
 
-	if (formatFuncHandle) dlclose (formatFuncHandle);
+	_unload_dynamic_functions (&func_handle);
 
 	return MM_ERROR_NONE;
 
 exception:
-	if (formatFuncHandle) dlclose (formatFuncHandle);
+	_unload_dynamic_functions (&func_handle);
 
 	return MM_ERROR_FILE_INTERNAL;
+}
+
+EXPORT_API
+int mm_file_unload_libraries (void)
+{
+#ifdef __MMFILE_DYN_LOADING__
+	int ret = MM_ERROR_NONE;
+
+	/* async requests are cancelled, the workers come back with the next request */
+	_async_stop_workers ();
+
+	pthread_mutex_lock (&g_loader_lock);
 
-}
\ No newline at end of file
+	if (g_loader.refcount > 0) {
+		debug_error ("libraries are in use [%d]\n", g_loader.refcount);
+		ret = MM_ERROR_FILE_INTERNAL;
+	} else {
+		_loader_close_libraries ();
+	}
+
+	pthread_mutex_unlock (&g_loader_lock);
+
+	return ret;
+#else
+	return MM_ERROR_NONE;
+#endif
+}
+
+EXPORT_API
+int mm_file_enable_cache (const char *path, int max_entries)
+{
+	MMFileCache *cache = NULL;
+
+	debug_fenter ();
+
+	if (path == NULL || max_entries <= 0) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (mmfile_cache_open (&cache, path, max_entries) != MMFILE_UTIL_SUCCESS) {
+		debug_error ("failed to open cache: %s\n", path);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	pthread_rwlock_wrlock (&g_cache_lock);
+
+	if (g_cache)
+		mmfile_cache_close (g_cache);
+
+	g_cache = cache;
+
+	pthread_rwlock_unlock (&g_cache_lock);
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_disable_cache (void)
+{
+	pthread_rwlock_wrlock (&g_cache_lock);
+
+	if (g_cache) {
+		mmfile_cache_close (g_cache);
+		g_cache = NULL;
+	}
+
+	pthread_rwlock_unlock (&g_cache_lock);
+
+	return MM_ERROR_NONE;
+}
+
+
+/**
+ * session functions.
+ * A session keeps one format context opened, so the file is probed and parsed only once
+ * and the same context serves stream, content, tag and thumbnail queries.
+ */
+static int
+_session_read_stream (MMFILE_SESSION *session)
+{
+	int ret = 0;
+
+	if (session->stream_read)
+		return MM_ERROR_NONE;
+
+	ret = session->func_handle.formatFuncs->read_stream (session->formatContext);
+	if (MMFILE_FORMAT_FAIL == ret) {
+		debug_error ("error: mmfile_format_read_stream\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	session->stream_read = 1;
+
+	return MM_ERROR_NONE;
+}
+
+static int
+_session_read_thumbnail (MMFILE_SESSION *session)
+{
+	int ret = 0;
+
+	ret = _session_read_stream (session);
+	if (ret != MM_ERROR_NONE)
+		return ret;
+
+	if (session->thumbnail_read)
+		return MM_ERROR_NONE;
+
+	/* try only once, a failure means there is no thumbnail for this file */
+	session->thumbnail_read = 1;
+
+	return _get_video_thumbnail (&session->func_handle, session->formatContext);
+}
+
+EXPORT_API
+int mm_file_open_session (MMHandleType *session, const char *filename)
+{
+	MMFILE_SESSION *handle = NULL;
+	int ret = 0;
+
+	debug_fenter ();
+
+	/* Check argument here */
+	if (session == NULL) {
+		debug_error ("Invalid arguments [session null]\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+	if (filename == NULL || strlen (filename) == 0) {
+		debug_error ("Invalid arguments [filename]\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	ret = _is_file_exist (filename);
+	if (!ret)
+		return MM_ERROR_FILE_NOT_FOUND;
+
+	handle = mmfile_malloc (sizeof (MMFILE_SESSION));
+	if (!handle) {
+		debug_error ("error: mmfile_malloc\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	handle->filename = mmfile_strdup (filename);
+	if (!handle->filename) {
+		debug_error ("error: mmfile_strdup\n");
+		mmfile_free (handle);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	ret = _load_dynamic_functions (&handle->func_handle);
+	if (ret == 0) {
+		debug_error ("load library error\n");
+		mmfile_free (handle->filename);
+		mmfile_free (handle);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	/*set source file infomation*/
+	MM_FILE_SET_MEDIA_FILE_SRC (handle->src, handle->filename);
+
+	ret = handle->func_handle.formatFuncs->open (&handle->formatContext, &handle->src);
+	if (MMFILE_FORMAT_FAIL == ret || handle->formatContext == NULL) {
+		debug_error ("error: mmfile_format_open\n");
+		_unload_dynamic_functions (&handle->func_handle);
+		mmfile_free (handle->filename);
+		mmfile_free (handle);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	*session = (MMHandleType) handle;
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_session_get_stream_info (MMHandleType session, int *audio_stream_num, int *video_stream_num)
+{
+	MMFILE_SESSION *handle = (MMFILE_SESSION *) session;
+
+	if (handle == NULL || audio_stream_num == NULL || video_stream_num == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	/* track numbers are known right after mmfile_format_open() */
+	*audio_stream_num = handle->formatContext->audioTotalTrackNum;
+	*video_stream_num = handle->formatContext->videoTotalTrackNum;
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_session_get_content_attrs (MMHandleType session, MMHandleType *contents_attrs)
+{
+	MMFILE_SESSION *handle = (MMFILE_SESSION *) session;
+	mmf_attrs_t *attrs = NULL;
+	int ret = 0;
+
+	debug_fenter ();
+
+	if (handle == NULL || contents_attrs == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (handle->content_attrs) {
+		*contents_attrs = (MMHandleType) handle->content_attrs;
+		return MM_ERROR_NONE;
+	}
+
+	ret = _session_read_stream (handle);
+	if (ret != MM_ERROR_NONE)
+		return ret;
+
+	ret = _session_read_thumbnail (handle);
+	if (ret != MM_ERROR_NONE) {
+		debug_error ("failed to get thumbnail: %s\n", handle->filename);
+	}
+
+	/*set attrs*/
+	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("content", g_content_attrs, ARRAY_SIZE (g_content_attrs), NULL, NULL);
+	if (!attrs) {
+		debug_error ("attribute internal error.\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	handle->formatContext->commandType = MM_FILE_CONTENTS;
+	_info_set_attr_media (attrs, handle->formatContext);
+
+	handle->content_attrs = attrs;
+	*contents_attrs = (MMHandleType) attrs;
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_session_get_tag_attrs (MMHandleType session, MMHandleType *tag_attrs)
+{
+	MMFILE_SESSION *handle = (MMFILE_SESSION *) session;
+	mmf_attrs_t *attrs = NULL;
+	int ret = 0;
+
+	debug_fenter ();
+
+	if (handle == NULL || tag_attrs == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (handle->tag_attrs) {
+		*tag_attrs = (MMHandleType) handle->tag_attrs;
+		return MM_ERROR_NONE;
+	}
+
+	ret = handle->func_handle.formatFuncs->read_tag (handle->formatContext);
+	if (MMFILE_FORMAT_FAIL == ret) {
+		debug_warning ("reading tag is fail\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	/*set attrs*/
+	attrs = (mmf_attrs_t *) mmf_attrs_new_from_data ("tag", g_tag_attrs, ARRAY_SIZE (g_tag_attrs), NULL, NULL);
+	if (!attrs) {
+		debug_error ("attribute internal error.\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	handle->formatContext->commandType = MM_FILE_TAG;
+	_info_set_attr_media (attrs, handle->formatContext);
+
+	handle->tag_attrs = attrs;
+	*tag_attrs = (MMHandleType) attrs;
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_session_get_thumbnail (MMHandleType session, void **frame, int *size, int *width, int *height)
+{
+	MMFILE_SESSION *handle = (MMFILE_SESSION *) session;
+	MMFileFormatFrame *thumbNail = NULL;
+	int ret = 0;
+
+	debug_fenter ();
+
+	if (handle == NULL || frame == NULL || size == NULL || width == NULL || height == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	ret = _session_read_thumbnail (handle);
+	if (ret != MM_ERROR_NONE)
+		return ret;
+
+	thumbNail = handle->formatContext->thumbNail;
+	if (thumbNail == NULL) {
+		debug_error ("no thumbnail: %s\n", handle->filename);
+		return MM_ERROR_COMMON_ATTR_NOT_EXIST;
+	}
+
+	/* frame data is moved to the content attrs once they are created */
+	*frame = thumbNail->frameData;
+	if (*frame == NULL && handle->content_attrs)
+		mm_attrs_get_data_by_name ((MMHandleType) handle->content_attrs, MM_FILE_CONTENT_VIDEO_THUMBNAIL, frame);
+
+	if (*frame == NULL) {
+		debug_error ("no thumbnail: %s\n", handle->filename);
+		return MM_ERROR_COMMON_ATTR_NOT_EXIST;
+	}
+
+	*size = thumbNail->frameSize;
+	*width = thumbNail->frameWidth;
+	*height = thumbNail->frameHeight;
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+EXPORT_API
+int mm_file_close_session (MMHandleType session)
+{
+	MMFILE_SESSION *handle = (MMFILE_SESSION *) session;
+
+	debug_fenter ();
+
+	if (handle == NULL) {
+		debug_error ("invalid handle.\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (handle->content_attrs)
+		mm_file_destroy_content_attrs ((MMHandleType) handle->content_attrs);
+
+	if (handle->tag_attrs)
+		mm_file_destroy_tag_attrs ((MMHandleType) handle->tag_attrs);
+
+	if (handle->formatContext)
+		handle->func_handle.formatFuncs->close (handle->formatContext);
+
+	_unload_dynamic_functions (&handle->func_handle);
+
+	mmfile_free (handle->filename);
+	mmfile_free (handle);
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+}
+
+
+/**
+ * batch functions.
+ */
+typedef struct {
+	const char	*filename;
+	int			is_video;
+	int			index;
+} MMFILE_BATCH_TASK;
+
+typedef struct {
+	int					flags;
+	mm_file_batch_cb	callback;
+	void				*user_data;
+} MMFILE_BATCH_INFO;
+
+/* audio before video, otherwise the given order */
+static int
+_batch_compare_task (const void *a, const void *b)
+{
+	const MMFILE_BATCH_TASK *ta = *(const MMFILE_BATCH_TASK **)a;
+	const MMFILE_BATCH_TASK *tb = *(const MMFILE_BATCH_TASK **)b;
+
+	if (ta->is_video != tb->is_video)
+		return ta->is_video - tb->is_video;
+
+	return ta->index - tb->index;
+}
+
+static void
+_batch_run_task (void *task, void *user_data)
+{
+	MMFILE_BATCH_TASK *batch_task = (MMFILE_BATCH_TASK *) task;
+	MMFILE_BATCH_INFO *info = (MMFILE_BATCH_INFO *) user_data;
+	MMHandleType contents_attrs = 0;
+	int ret = 0;
+
+	if (info->flags & MM_FILE_BATCH_NO_THUMBNAIL)
+		ret = mm_file_create_content_attrs_simple (&contents_attrs, batch_task->filename);
+	else
+		ret = mm_file_create_content_attrs (&contents_attrs, batch_task->filename);
+
+	info->callback (batch_task->filename, ret, contents_attrs, info->user_data);
+}
+
+EXPORT_API
+int mm_file_create_content_attrs_batch (const char **filenames, int num, int flags, mm_file_batch_cb callback, void *user_data)
+{
+	MMFILE_BATCH_TASK *tasks = NULL;
+	MMFILE_BATCH_TASK **task_list = NULL;
+	MMFILE_BATCH_INFO info = {0,};
+	MMFILE_FUNC_HANDLE func_handle = {0,};
+	int ret = 0;
+	int i = 0;
+
+	debug_fenter ();
+
+	if (filenames == NULL || num < 0 || callback == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (num == 0)
+		return MM_ERROR_NONE;
+
+	tasks = mmfile_malloc (sizeof (MMFILE_BATCH_TASK) * num);
+	task_list = mmfile_malloc (sizeof (MMFILE_BATCH_TASK *) * num);
+	if (!tasks || !task_list) {
+		debug_error ("error: mmfile_malloc\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
+
+	/* the priority only looks at the name, the files are first touched by the workers */
+	if (!(flags & MM_FILE_BATCH_NO_PRIORITY) && !_load_dynamic_functions (&func_handle)) {
+		debug_error ("load library error\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
+
+	for (i = 0; i < num; i++) {
+		tasks[i].filename = filenames[i];
+		tasks[i].index = i;
+		if (func_handle.formatFuncs)
+			tasks[i].is_video = func_handle.formatFuncs->is_video (filenames[i]);
+		task_list[i] = &tasks[i];
+	}
+
+	if (func_handle.formatFuncs) {
+		_unload_dynamic_functions (&func_handle);
+		qsort (task_list, num, sizeof (MMFILE_BATCH_TASK *), _batch_compare_task);
+	}
+
+	info.flags = flags;
+	info.callback = callback;
+	info.user_data = user_data;
+
+	ret = mmfile_pool_run ((void **)task_list, num, mmfile_pool_get_cpu_count (), _batch_run_task, &info);
+	if (ret != MMFILE_UTIL_SUCCESS) {
+		debug_error ("error: mmfile_pool_run\n");
+		ret = MM_ERROR_FILE_INTERNAL;
+		goto exception;
+	}
+
+	mmfile_free (task_list);
+	mmfile_free (tasks);
+
+	debug_fleave ();
+
+	return MM_ERROR_NONE;
+
+exception:
+	if (task_list) mmfile_free (task_list);
+	if (tasks) mmfile_free (tasks);
+
+	return ret;
+}
+
+
+/**
+ * asynchronous functions.
+ * requests are kept in one list in arrival order and served by a fixed set of
+ * worker threads. The workers are started with the first request and joined
+ * by _async_stop_workers() when mm_file_unload_libraries() is called.
+ */
+static pthread_mutex_t g_async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_async_cond = PTHREAD_COND_INITIALIZER;
+static MMFILE_ASYNC_REQUEST *g_async_requests = NULL;
+static int g_async_last_id = 0;
+static pthread_t *g_async_workers = NULL;
+static int g_async_worker_num = 0;
+static int g_async_generation = 0;	/* bumped by a stop, older workers exit */
+
+/* called with g_async_lock */
+static void
+_async_remove_request (MMFILE_ASYNC_REQUEST *request)
+{
+	MMFILE_ASYNC_REQUEST **pos = &g_async_requests;
+
+	while (*pos) {
+		if (*pos == request) {
+			*pos = request->next;
+			return;
+		}
+		pos = (MMFILE_ASYNC_REQUEST **) &(*pos)->next;
+	}
+}
+
+/* called with g_async_lock */
+static MMFILE_ASYNC_REQUEST *
+_async_next_request (void)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+
+	for (request = g_async_requests; request; request = request->next) {
+		if (!request->running)
+			return request;
+	}
+
+	return NULL;
+}
+
+static void
+_async_run_request (MMFILE_ASYNC_REQUEST *request)
+{
+	MMHandleType contents_attrs = 0;
+	int ret = MM_ERROR_FILE_INTERNAL;
+
+	mmfile_abort_set_current (&request->abort);
+
+	if (!mmfile_abort_is_cancelled (&request->abort))
+		ret = _create_content_attrs (&contents_attrs, request->filename, request->mask, 0, request);
+
+	mmfile_abort_set_current (NULL);
+
+	if (mmfile_abort_is_cancelled (&request->abort)) {
+		if (contents_attrs)
+			mm_file_destroy_content_attrs (contents_attrs);
+
+		request->callback (request->id, MM_FILE_ASYNC_STAGE_CANCELLED, MM_ERROR_FILE_INTERNAL, 0, request->user_data);
+	} else {
+		request->callback (request->id, MM_FILE_ASYNC_STAGE_DONE, ret, contents_attrs, request->user_data);
+	}
+}
+
+static void *
+_async_worker (void *data)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+	int generation = (int)(intptr_t) data;
+
+	for (;;) {
+		pthread_mutex_lock (&g_async_lock);
+		while (generation == g_async_generation && (request = _async_next_request ()) == NULL)
+			pthread_cond_wait (&g_async_cond, &g_async_lock);
+		if (generation != g_async_generation) {
+			pthread_mutex_unlock (&g_async_lock);
+			break;
+		}
+		request->running = 1;
+		pthread_mutex_unlock (&g_async_lock);
+
+		_async_run_request (request);
+
+		pthread_mutex_lock (&g_async_lock);
+		_async_remove_request (request);
+		pthread_mutex_unlock (&g_async_lock);
+
+		mmfile_free (request->filename);
+		mmfile_free (request);
+	}
+
+	return NULL;
+}
+
+/* called with g_async_lock, returns the number of workers running */
+static int
+_async_start_workers (void)
+{
+	int num = mmfile_pool_get_cpu_count ();
+	int i = 0;
+
+	if (g_async_worker_num > 0)
+		return g_async_worker_num;
+
+	g_async_workers = mmfile_malloc (sizeof (pthread_t) * num);
+	if (!g_async_workers) {
+		debug_error ("error: mmfile_malloc\n");
+		return 0;
+	}
+
+	for (i = 0; i < num; i++) {
+		if (pthread_create (&g_async_workers[i], NULL, _async_worker, (void *)(intptr_t) g_async_generation) != 0) {
+			debug_error ("failed to create async worker [%d]\n", i);
+			break;
+		}
+	}
+
+	g_async_worker_num = i;
+	if (g_async_worker_num == 0)
+		mmfile_free (g_async_workers);
+
+	return g_async_worker_num;
+}
+
+#ifdef __MMFILE_DYN_LOADING__
+/**
+ * cancels the running requests, drops the waiting ones with MM_FILE_ASYNC_STAGE_CANCELLED
+ * and joins the workers. A worker calling this from its callback is left to exit by itself.
+ */
+static void
+_async_stop_workers (void)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+	MMFILE_ASYNC_REQUEST *waiting = NULL;
+	MMFILE_ASYNC_REQUEST **pos = NULL;
+	pthread_t *workers = NULL;
+	int num = 0;
+	int i = 0;
+
+	pthread_mutex_lock (&g_async_lock);
+
+	workers = g_async_workers;
+	num = g_async_worker_num;
+	g_async_workers = NULL;
+	g_async_worker_num = 0;
+	g_async_generation++;
+
+	pos = &g_async_requests;
+	while ((request = *pos) != NULL) {
+		if (request->running) {
+			mmfile_abort_cancel (&request->abort);
+			pos = (MMFILE_ASYNC_REQUEST **) &request->next;
+		} else {
+			*pos = request->next;
+			request->next = waiting;
+			waiting = request;
+		}
+	}
+
+	pthread_cond_broadcast (&g_async_cond);
+	pthread_mutex_unlock (&g_async_lock);
+
+	for (i = 0; i < num; i++) {
+		if (pthread_equal (workers[i], pthread_self ()))
+			pthread_detach (workers[i]);
+		else
+			pthread_join (workers[i], NULL);
+	}
+
+	if (workers)
+		mmfile_free (workers);
+
+	while ((request = waiting) != NULL) {
+		waiting = request->next;
+		request->callback (request->id, MM_FILE_ASYNC_STAGE_CANCELLED, MM_ERROR_FILE_INTERNAL, 0, request->user_data);
+		mmfile_free (request->filename);
+		mmfile_free (request);
+	}
+}
+
+/**
+ * exit time form of _async_stop_workers(): the waiting requests are freed without
+ * a callback, the running ones are cancelled and the workers are detached, not joined.
+ * returns the number of requests still running.
+ */
+static int
+_async_drop_workers (void)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+	MMFILE_ASYNC_REQUEST **pos = NULL;
+	int running = 0;
+	int i = 0;
+
+	pthread_mutex_lock (&g_async_lock);
+
+	for (i = 0; i < g_async_worker_num; i++)
+		pthread_detach (g_async_workers[i]);
+	if (g_async_workers)
+		mmfile_free (g_async_workers);
+	g_async_worker_num = 0;
+	g_async_generation++;
+
+	pos = &g_async_requests;
+	while ((request = *pos) != NULL) {
+		if (request->running) {
+			mmfile_abort_cancel (&request->abort);
+			pos = (MMFILE_ASYNC_REQUEST **) &request->next;
+			running++;
+		} else {
+			*pos = request->next;
+			mmfile_free (request->filename);
+			mmfile_free (request);
+		}
+	}
+
+	pthread_cond_broadcast (&g_async_cond);
+	pthread_mutex_unlock (&g_async_lock);
+
+	return running;
+}
+#endif
+
+EXPORT_API
+int mm_file_create_content_attrs_async (const char *filename, int mask, mm_file_async_cb callback, void *user_data)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+	MMFILE_ASYNC_REQUEST **pos = NULL;
+	int id = 0;
+
+	debug_fenter ();
+
+	if (filename == NULL || strlen (filename) == 0 || callback == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	request = mmfile_malloc (sizeof (MMFILE_ASYNC_REQUEST));
+	if (!request) {
+		debug_error ("error: mmfile_malloc\n");
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	request->filename = mmfile_strdup (filename);
+	if (!request->filename) {
+		debug_error ("error: mmfile_strdup\n");
+		mmfile_free (request);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	request->mask = mask;
+	request->callback = callback;
+	request->user_data = user_data;
+
+	pthread_mutex_lock (&g_async_lock);
+
+	if (_async_start_workers () == 0) {
+		pthread_mutex_unlock (&g_async_lock);
+		debug_error ("no async worker\n");
+		mmfile_free (request->filename);
+		mmfile_free (request);
+		return MM_ERROR_FILE_INTERNAL;
+	}
+
+	if (++g_async_last_id <= 0)
+		g_async_last_id = 1;
+	id = request->id = g_async_last_id;
+
+	for (pos = &g_async_requests; *pos; pos = (MMFILE_ASYNC_REQUEST **) &(*pos)->next)
+		;
+	*pos = request;
+
+	pthread_cond_signal (&g_async_cond);
+	pthread_mutex_unlock (&g_async_lock);
+
+	debug_fleave ();
+
+	return id;
+}
+
+EXPORT_API
+int mm_file_cancel (int id)
+{
+	MMFILE_ASYNC_REQUEST *request = NULL;
+	MMFILE_ASYNC_REQUEST *dropped = NULL;
+	int ret = MM_ERROR_INVALID_ARGUMENT;
+
+	pthread_mutex_lock (&g_async_lock);
+
+	for (request = g_async_requests; request; request = request->next) {
+		if (request->id == id) {
+			if (request->running) {
+				/* stops at the next check, the worker reports it */
+				mmfile_abort_cancel (&request->abort);
+			} else {
+				_async_remove_request (request);
+				dropped = request;
+			}
+			ret = MM_ERROR_NONE;
+			break;
+		}
+	}
+
+	pthread_mutex_unlock (&g_async_lock);
+
+	/* never started, reported here */
+	if (dropped) {
+		dropped->callback (dropped->id, MM_FILE_ASYNC_STAGE_CANCELLED, MM_ERROR_FILE_INTERNAL, 0, dropped->user_data);
+		mmfile_free (dropped->filename);
+		mmfile_free (dropped);
+	}
+
+	return ret;
+}
+
+EXPORT_API
+int mm_file_get_last_io_stats (MMFileIOStats *stats)
+{
+	if (stats == NULL) {
+		debug_error ("Invalid arguments\n");
+		return MM_ERROR_INVALID_ARGUMENT;
+	}
+
+	*stats = g_last_io_stats;
+
+	return MM_ERROR_NONE;
+}
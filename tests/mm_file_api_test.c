@@ -0,0 +1,958 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#include <mm_error.h>
+#include "mm_file.h"
+
+/**
+ * checks of the public API on small media files generated in a temporary directory, run by make check.
+ * each check returns 0 on success and prints what went wrong otherwise.
+ */
+typedef int (*MMFileCheckFunc) (void);
+
+typedef struct {
+	const char		*name;
+	MMFileCheckFunc	func;
+} MMFileCheck;
+
+#define _FIXTURE_PATH_MAX	128
+
+typedef struct {
+	char	dir[_FIXTURE_PATH_MAX];
+	char	wav[_FIXTURE_PATH_MAX];
+	char	mp3[_FIXTURE_PATH_MAX];
+	char	amr[_FIXTURE_PATH_MAX];
+} MMFileFixture;
+
+static MMFileFixture g_fixture;
+
+/* one second of 16 bit mono silence at 8 kHz */
+#define _WAV_SAMPLERATE		8000
+#define _WAV_DATA_SIZE		(_WAV_SAMPLERATE * 2)
+
+/* MPEG-1 layer III, 128 kbps, 44.1 kHz, no padding */
+#define _MP3_FRAME_SIZE		417
+#define _MP3_FRAME_NUM		64
+#define _MP3_TITLE			"mmfile title"
+#define _MP3_ARTIST			"mmfile artist"
+
+/* AMR-NB NO_DATA frames are one byte each, so a few MB take the parser well over a millisecond */
+#define _AMR_HEADER			"#!AMR\n"
+#define _AMR_NO_DATA_FRAME	0x7C
+#define _AMR_FRAME_NUM		(8 * 1024 * 1024)
+#define _AMR_FRAME_DURATION	20
+
+#define _TAG_VALUE_MAX		64
+
+typedef struct {
+	int	duration;
+	int	audio_channels;
+	int	audio_samplerate;
+	int	audio_track_num;
+	int	video_track_num;
+} MMFileCheckContent;
+
+typedef struct {
+	char	title[_TAG_VALUE_MAX];
+	char	artist[_TAG_VALUE_MAX];
+} MMFileCheckTag;
+
+static void
+_put_le16 (unsigned char *p, unsigned int value)
+{
+	p[0] = value & 0xFF;
+	p[1] = (value >> 8) & 0xFF;
+}
+
+static void
+_put_le32 (unsigned char *p, unsigned int value)
+{
+	_put_le16 (p, value & 0xFFFF);
+	_put_le16 (p + 2, value >> 16);
+}
+
+static int
+_write_fill (FILE *fp, int value, long size)
+{
+	unsigned char buf[4096];
+	long len = 0;
+
+	memset (buf, value, sizeof (buf));
+
+	for (; size > 0; size -= len) {
+		len = size < (long) sizeof (buf) ? size : (long) sizeof (buf);
+		if (fwrite (buf, 1, len, fp) != (size_t) len)
+			return -1;
+	}
+
+	return 0;
+}
+
+static int
+_write_wav (const char *path)
+{
+	unsigned char header[44];
+	FILE *fp = NULL;
+	int ret = -1;
+
+	memcpy (header, "RIFF", 4);
+	_put_le32 (header + 4, 36 + _WAV_DATA_SIZE);
+	memcpy (header + 8, "WAVEfmt ", 8);
+	_put_le32 (header + 16, 16);
+	_put_le16 (header + 20, 1);						/* PCM */
+	_put_le16 (header + 22, 1);						/* channels */
+	_put_le32 (header + 24, _WAV_SAMPLERATE);
+	_put_le32 (header + 28, _WAV_SAMPLERATE * 2);	/* byte rate */
+	_put_le16 (header + 32, 2);						/* block align */
+	_put_le16 (header + 34, 16);					/* bits per sample */
+	memcpy (header + 36, "data", 4);
+	_put_le32 (header + 40, _WAV_DATA_SIZE);
+
+	fp = fopen (path, "wb");
+	if (!fp)
+		return -1;
+
+	if (fwrite (header, 1, sizeof (header), fp) == sizeof (header) && _write_fill (fp, 0x00, _WAV_DATA_SIZE) == 0)
+		ret = 0;
+
+	if (fclose (fp) != 0)
+		ret = -1;
+
+	return ret;
+}
+
+/* silent frames followed by an ID3v1 tag */
+static int
+_write_mp3 (const char *path)
+{
+	const unsigned char frame_header[4] = {0xFF, 0xFB, 0x90, 0x00};
+	unsigned char tag[128];
+	FILE *fp = NULL;
+	int ret = 0;
+	int i = 0;
+
+	memset (tag, 0x00, sizeof (tag));
+	memcpy (tag, "TAG", 3);
+	memcpy (tag + 3, _MP3_TITLE, strlen (_MP3_TITLE));
+	memcpy (tag + 33, _MP3_ARTIST, strlen (_MP3_ARTIST));
+	tag[127] = 0xFF;	/* no genre */
+
+	fp = fopen (path, "wb");
+	if (!fp)
+		return -1;
+
+	for (i = 0; i < _MP3_FRAME_NUM && ret == 0; i++) {
+		if (fwrite (frame_header, 1, sizeof (frame_header), fp) != sizeof (frame_header) ||
+			_write_fill (fp, 0x00, _MP3_FRAME_SIZE - sizeof (frame_header)) != 0)
+			ret = -1;
+	}
+
+	if (ret == 0 && fwrite (tag, 1, sizeof (tag), fp) != sizeof (tag))
+		ret = -1;
+
+	if (fclose (fp) != 0)
+		ret = -1;
+
+	return ret;
+}
+
+static int
+_write_amr (const char *path)
+{
+	FILE *fp = NULL;
+	int ret = -1;
+
+	fp = fopen (path, "wb");
+	if (!fp)
+		return -1;
+
+	if (fwrite (_AMR_HEADER, 1, strlen (_AMR_HEADER), fp) == strlen (_AMR_HEADER) &&
+		_write_fill (fp, _AMR_NO_DATA_FRAME, _AMR_FRAME_NUM) == 0)
+		ret = 0;
+
+	if (fclose (fp) != 0)
+		ret = -1;
+
+	return ret;
+}
+
+static int
+_fixture_create (void)
+{
+	snprintf (g_fixture.dir, sizeof (g_fixture.dir), "/tmp/mmfile_api_XXXXXX");
+	if (!mkdtemp (g_fixture.dir)) {
+		printf ("fixture: failed to create a temporary directory\n");
+		return -1;
+	}
+
+	snprintf (g_fixture.wav, sizeof (g_fixture.wav), "%s/silence.wav", g_fixture.dir);
+	snprintf (g_fixture.mp3, sizeof (g_fixture.mp3), "%s/silence.mp3", g_fixture.dir);
+	snprintf (g_fixture.amr, sizeof (g_fixture.amr), "%s/no_data.amr", g_fixture.dir);
+
+	if (_write_wav (g_fixture.wav) != 0 || _write_mp3 (g_fixture.mp3) != 0 || _write_amr (g_fixture.amr) != 0) {
+		printf ("fixture: failed to write the media files\n");
+		return -1;
+	}
+
+	return 0;
+}
+
+static void
+_fixture_remove (void)
+{
+	unlink (g_fixture.wav);
+	unlink (g_fixture.mp3);
+	unlink (g_fixture.amr);
+	rmdir (g_fixture.dir);
+}
+
+static int
+_get_content (MMHandleType attrs, MMFileCheckContent *content)
+{
+	memset (content, 0x00, sizeof (MMFileCheckContent));
+
+	return mm_file_get_attrs (attrs, NULL,
+							MM_FILE_CONTENT_DURATION, &content->duration,
+							MM_FILE_CONTENT_AUDIO_CHANNELS, &content->audio_channels,
+							MM_FILE_CONTENT_AUDIO_SAMPLERATE, &content->audio_samplerate,
+							MM_FILE_CONTENT_AUDIO_TRACK_COUNT, &content->audio_track_num,
+							MM_FILE_CONTENT_VIDEO_TRACK_COUNT, &content->video_track_num,
+							NULL);
+}
+
+static int
+_get_tag (MMHandleType attrs, MMFileCheckTag *tag)
+{
+	char *title = NULL;
+	char *artist = NULL;
+	int title_len = 0;
+	int artist_len = 0;
+	int ret = 0;
+
+	memset (tag, 0x00, sizeof (MMFileCheckTag));
+
+	ret = mm_file_get_attrs (attrs, NULL,
+							MM_FILE_TAG_TITLE, &title, &title_len,
+							MM_FILE_TAG_ARTIST, &artist, &artist_len,
+							NULL);
+	if (ret != MM_ERROR_NONE)
+		return ret;
+
+	/* the strings belong to attrs */
+	if (title)
+		snprintf (tag->title, sizeof (tag->title), "%s", title);
+	if (artist)
+		snprintf (tag->artist, sizeof (tag->artist), "%s", artist);
+
+	return MM_ERROR_NONE;
+}
+
+static int
+_expect_same_content (const char *what, const MMFileCheckContent *got, const MMFileCheckContent *expected)
+{
+	if (memcmp (got, expected, sizeof (MMFileCheckContent)) != 0) {
+		printf ("%s: duration %d, channels %d, samplerate %d, tracks %d/%d; expected %d, %d, %d, %d/%d\n", what,
+				got->duration, got->audio_channels, got->audio_samplerate, got->audio_track_num, got->video_track_num,
+				expected->duration, expected->audio_channels, expected->audio_samplerate, expected->audio_track_num, expected->video_track_num);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+_expect_same_tag (const char *what, const MMFileCheckTag *got, const MMFileCheckTag *expected)
+{
+	if (strcmp (got->title, expected->title) != 0 || strcmp (got->artist, expected->artist) != 0) {
+		printf ("%s: title \"%s\", artist \"%s\"; expected \"%s\", \"%s\"\n", what,
+				got->title, got->artist, expected->title, expected->artist);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* the attributes of a file as given by the one-shot calls, checked against what the fixture holds */
+static int
+_get_reference (const char *path, MMFileCheckContent *content, MMFileCheckTag *tag)
+{
+	MMHandleType content_attrs = 0;
+	MMHandleType tag_attrs = 0;
+	int ret = 0;
+
+	ret = mm_file_create_content_attrs (&content_attrs, path);
+	if (ret != MM_ERROR_NONE) {
+		printf ("%s: mm_file_create_content_attrs() error=[%x]\n", path, ret);
+		return -1;
+	}
+	ret = _get_content (content_attrs, content);
+	mm_file_destroy_content_attrs (content_attrs);
+	if (ret != MM_ERROR_NONE || content->duration <= 0 || content->audio_track_num != 1) {
+		printf ("%s: duration %d, audio tracks %d\n", path, content->duration, content->audio_track_num);
+		return -1;
+	}
+
+	if (!tag)
+		return 0;
+
+	ret = mm_file_create_tag_attrs (&tag_attrs, path);
+	if (ret != MM_ERROR_NONE) {
+		printf ("%s: mm_file_create_tag_attrs() error=[%x]\n", path, ret);
+		return -1;
+	}
+	ret = _get_tag (tag_attrs, tag);
+	mm_file_destroy_tag_attrs (tag_attrs);
+
+	return ret == MM_ERROR_NONE ? 0 : -1;
+}
+
+/* a session serves the same attributes as the one-shot calls */
+static int
+mmfile_check_session (void)
+{
+	const char *paths[] = {g_fixture.wav, g_fixture.mp3};
+	MMFileCheckContent expected_content;
+	MMFileCheckContent content;
+	MMFileCheckTag expected_tag;
+	MMFileCheckTag tag;
+	MMHandleType session = 0;
+	MMHandleType attrs = 0;
+	int audio_num = 0;
+	int video_num = 0;
+	unsigned int i = 0;
+	int ret = 0;
+
+	for (i = 0; i < sizeof (paths) / sizeof (paths[0]); i++) {
+		if (_get_reference (paths[i], &expected_content, &expected_tag) != 0)
+			return -1;
+
+		ret = mm_file_open_session (&session, paths[i]);
+		if (ret != MM_ERROR_NONE) {
+			printf ("session: %s, mm_file_open_session() error=[%x]\n", paths[i], ret);
+			return -1;
+		}
+
+		ret = -1;
+
+		if (mm_file_session_get_stream_info (session, &audio_num, &video_num) != MM_ERROR_NONE ||
+			audio_num != expected_content.audio_track_num || video_num != expected_content.video_track_num) {
+			printf ("session: %s, stream count %d/%d\n", paths[i], audio_num, video_num);
+			goto exception;
+		}
+
+		if (mm_file_session_get_content_attrs (session, &attrs) != MM_ERROR_NONE || _get_content (attrs, &content) != MM_ERROR_NONE)
+			goto exception;
+		if (_expect_same_content ("session", &content, &expected_content) != 0)
+			goto exception;
+
+		if (mm_file_session_get_tag_attrs (session, &attrs) != MM_ERROR_NONE || _get_tag (attrs, &tag) != MM_ERROR_NONE)
+			goto exception;
+		if (_expect_same_tag ("session", &tag, &expected_tag) != 0)
+			goto exception;
+
+		ret = 0;
+
+exception:
+		mm_file_close_session (session);
+		if (ret != 0)
+			return -1;
+	}
+
+	if (strcmp (expected_tag.title, _MP3_TITLE) != 0 || strcmp (expected_tag.artist, _MP3_ARTIST) != 0) {
+		printf ("session: the ID3 tag of the fixture is read as \"%s\", \"%s\"\n", expected_tag.title, expected_tag.artist);
+		return -1;
+	}
+
+	return 0;
+}
+
+#define _BATCH_FILE_NUM		3
+
+typedef struct {
+	const char			**paths;
+	int					done[_BATCH_FILE_NUM];
+	int					result[_BATCH_FILE_NUM];
+	MMFileCheckContent	content[_BATCH_FILE_NUM];
+	int					unknown;
+	pthread_mutex_t		lock;
+} MMFileBatchResult;
+
+static void
+_batch_done (const char *filename, int result, MMHandleType content_attrs, void *user_data)
+{
+	MMFileBatchResult *batch = (MMFileBatchResult *) user_data;
+	int i = 0;
+
+	pthread_mutex_lock (&batch->lock);
+
+	/* the batch gives back the pointers it was given */
+	for (i = 0; i < _BATCH_FILE_NUM && batch->paths[i] != filename; i++)
+		;
+
+	if (i == _BATCH_FILE_NUM) {
+		batch->unknown++;
+	} else {
+		batch->done[i]++;
+		batch->result[i] = result;
+		if (content_attrs)
+			_get_content (content_attrs, &batch->content[i]);
+	}
+
+	pthread_mutex_unlock (&batch->lock);
+
+	if (content_attrs)
+		mm_file_destroy_content_attrs (content_attrs);
+}
+
+/* every file of a batch is reported once, with what a single call returns for it */
+static int
+mmfile_check_batch (void)
+{
+	const int flags[] = {0, MM_FILE_BATCH_NO_PRIORITY | MM_FILE_BATCH_NO_THUMBNAIL};
+	char missing[_FIXTURE_PATH_MAX];
+	const char *paths[_BATCH_FILE_NUM] = {g_fixture.mp3, missing, g_fixture.wav};
+	MMFileBatchResult batch;
+	MMFileCheckContent expected;
+	MMHandleType attrs = 0;
+	unsigned int f = 0;
+	int i = 0;
+	int ret = 0;
+
+	snprintf (missing, sizeof (missing), "%s/missing.mp3", g_fixture.dir);
+
+	for (f = 0; f < sizeof (flags) / sizeof (flags[0]); f++) {
+		memset (&batch, 0x00, sizeof (MMFileBatchResult));
+		batch.paths = paths;
+		pthread_mutex_init (&batch.lock, NULL);
+
+		ret = mm_file_create_content_attrs_batch (paths, _BATCH_FILE_NUM, flags[f], _batch_done, &batch);
+		pthread_mutex_destroy (&batch.lock);
+
+		if (ret != MM_ERROR_NONE || batch.unknown) {
+			printf ("batch: flags %x, error=[%x], %d unknown files reported\n", flags[f], ret, batch.unknown);
+			return -1;
+		}
+
+		for (i = 0; i < _BATCH_FILE_NUM; i++) {
+			if (batch.done[i] != 1) {
+				printf ("batch: flags %x, %s is reported %d times\n", flags[f], paths[i], batch.done[i]);
+				return -1;
+			}
+
+			memset (&expected, 0x00, sizeof (MMFileCheckContent));
+			attrs = 0;
+
+			if (flags[f] & MM_FILE_BATCH_NO_THUMBNAIL)
+				ret = mm_file_create_content_attrs_simple (&attrs, paths[i]);
+			else
+				ret = mm_file_create_content_attrs (&attrs, paths[i]);
+
+			if (attrs) {
+				_get_content (attrs, &expected);
+				mm_file_destroy_content_attrs (attrs);
+			}
+
+			if (batch.result[i] != ret) {
+				printf ("batch: flags %x, %s error=[%x], single call error=[%x]\n", flags[f], paths[i], batch.result[i], ret);
+				return -1;
+			}
+			if (_expect_same_content ("batch", &batch.content[i], &expected) != 0)
+				return -1;
+		}
+
+		/* the missing file must not be the only one which is compared */
+		if (batch.result[0] != MM_ERROR_NONE || batch.result[1] == MM_ERROR_NONE || batch.result[2] != MM_ERROR_NONE) {
+			printf ("batch: flags %x, results [%x] [%x] [%x]\n", flags[f], batch.result[0], batch.result[1], batch.result[2]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+typedef struct {
+	int		blocking;	/* parks at the open stage until the gate is opened */
+	int		done;
+	int		cancelled;
+	int		result;
+} MMFileAsyncRecord;
+
+typedef struct {
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	int				gate_open;
+	int				parked;
+	int				finished;
+} MMFileAsyncState;
+
+static MMFileAsyncState g_async = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0};
+
+static void
+_async_callback (int id, int stage, int result, MMHandleType content_attrs, void *user_data)
+{
+	MMFileAsyncRecord *record = (MMFileAsyncRecord *) user_data;
+
+	pthread_mutex_lock (&g_async.lock);
+
+	if (stage == MM_FILE_ASYNC_STAGE_OPEN && record->blocking) {
+		g_async.parked++;
+		pthread_cond_broadcast (&g_async.cond);
+		while (!g_async.gate_open)
+			pthread_cond_wait (&g_async.cond, &g_async.lock);
+	} else if (stage == MM_FILE_ASYNC_STAGE_DONE || stage == MM_FILE_ASYNC_STAGE_CANCELLED) {
+		if (stage == MM_FILE_ASYNC_STAGE_DONE)
+			record->done++;
+		else
+			record->cancelled++;
+		record->result = result;
+		g_async.finished++;
+		pthread_cond_broadcast (&g_async.cond);
+	}
+
+	pthread_mutex_unlock (&g_async.lock);
+
+	if (content_attrs)
+		mm_file_destroy_content_attrs (content_attrs);
+}
+
+/* gives up after a while, so that a lost callback fails the check instead of hanging it */
+static int
+_async_wait (int *counter, int value)
+{
+	struct timespec timeout;
+	int ret = 0;
+
+	clock_gettime (CLOCK_REALTIME, &timeout);
+	timeout.tv_sec += 10;
+
+	pthread_mutex_lock (&g_async.lock);
+	while (*counter < value && ret == 0)
+		ret = pthread_cond_timedwait (&g_async.cond, &g_async.lock, &timeout);
+	ret = (*counter < value) ? -1 : 0;
+	pthread_mutex_unlock (&g_async.lock);
+
+	return ret;
+}
+
+static void
+_async_open_gate (void)
+{
+	pthread_mutex_lock (&g_async.lock);
+	g_async.gate_open = 1;
+	pthread_cond_broadcast (&g_async.cond);
+	pthread_mutex_unlock (&g_async.lock);
+}
+
+static int
+_async_expect (const char *what, const MMFileAsyncRecord *record, int done, int cancelled)
+{
+	if (record->done != done || record->cancelled != cancelled || (done && record->result != MM_ERROR_NONE)) {
+		printf ("async: %s request, %d done (error=[%x]) and %d cancelled callbacks, expected %d and %d\n",
+				what, record->done, record->result, record->cancelled, done, cancelled);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * every request ends with exactly one DONE or CANCELLED callback.
+ * one request per worker is parked in its open stage, so that the next request is known to be waiting.
+ */
+static int
+mmfile_check_async (void)
+{
+	long cpu_count = sysconf (_SC_NPROCESSORS_ONLN);
+	int worker_num = (cpu_count > 0) ? (int) cpu_count : 1;	/* one worker per CPU */
+	MMFileAsyncRecord *blocking = NULL;
+	MMFileAsyncRecord waiting;
+	MMFileAsyncRecord plain;
+	int running_id = 0;
+	int waiting_id = 0;
+	int id = 0;
+	int i = 0;
+	int ret = -1;
+
+	memset (&waiting, 0x00, sizeof (MMFileAsyncRecord));
+	memset (&plain, 0x00, sizeof (MMFileAsyncRecord));
+
+	blocking = calloc (worker_num, sizeof (MMFileAsyncRecord));
+	if (!blocking)
+		return -1;
+
+	for (i = 0; i < worker_num; i++) {
+		blocking[i].blocking = 1;
+		id = mm_file_create_content_attrs_async (g_fixture.wav, MM_FILE_WANT_ALL, _async_callback, &blocking[i]);
+		if (id <= 0) {
+			printf ("async: failed to request %s\n", g_fixture.wav);
+			goto exception;
+		}
+		if (i == 0)
+			running_id = id;
+	}
+
+	if (_async_wait (&g_async.parked, worker_num) != 0) {
+		printf ("async: %d of %d workers reached the open stage\n", g_async.parked, worker_num);
+		goto exception;
+	}
+
+	/* all workers are parked, so this one is still waiting, and it is reported before the cancel returns */
+	waiting_id = mm_file_create_content_attrs_async (g_fixture.mp3, MM_FILE_WANT_ALL, _async_callback, &waiting);
+	if (waiting_id <= 0 || mm_file_cancel (waiting_id) != MM_ERROR_NONE) {
+		printf ("async: failed to request and cancel %s\n", g_fixture.mp3);
+		goto exception;
+	}
+	pthread_mutex_lock (&g_async.lock);
+	ret = _async_expect ("waiting", &waiting, 0, 1);
+	pthread_mutex_unlock (&g_async.lock);
+	if (ret != 0)
+		goto exception;
+
+	ret = -1;
+
+	/* a running request stops at the next check after its open stage */
+	if (mm_file_cancel (running_id) != MM_ERROR_NONE) {
+		printf ("async: failed to cancel a running request\n");
+		goto exception;
+	}
+
+	_async_open_gate ();
+
+	if (_async_wait (&g_async.finished, worker_num + 1) != 0)
+		goto exception;
+
+	if (mm_file_create_content_attrs_async (g_fixture.wav, MM_FILE_WANT_ALL, _async_callback, &plain) <= 0 ||
+		_async_wait (&g_async.finished, worker_num + 2) != 0)
+		goto exception;
+
+	/* joins the workers, a late or second callback would show up below */
+	if (mm_file_unload_libraries () != MM_ERROR_NONE) {
+		printf ("async: failed to unload the libraries\n");
+		goto exception;
+	}
+
+	if (mm_file_cancel (waiting_id) != MM_ERROR_INVALID_ARGUMENT) {
+		printf ("async: a finished request is cancelled\n");
+		goto exception;
+	}
+
+	if (_async_expect ("cancelled running", &blocking[0], 0, 1) != 0 ||
+		_async_expect ("cancelled waiting", &waiting, 0, 1) != 0 ||
+		_async_expect ("plain", &plain, 1, 0) != 0)
+		goto exception;
+
+	for (i = 1; i < worker_num; i++) {
+		if (_async_expect ("parked", &blocking[i], 1, 0) != 0)
+			goto exception;
+	}
+
+	ret = 0;
+
+exception:
+	_async_open_gate ();
+	if (ret != 0) {
+		/* the records must outlive the callbacks */
+		_async_wait (&g_async.finished, worker_num + 2);
+		mm_file_unload_libraries ();
+	}
+	free (blocking);
+
+	return ret;
+}
+
+static int
+_deadline_extract (int deadline, int *duration, int *incomplete)
+{
+	MMHandleType attrs = 0;
+	int ret = 0;
+
+	*duration = 0;
+	*incomplete = -1;
+
+	ret = mm_file_create_content_attrs_with_deadline (&attrs, g_fixture.amr, MM_FILE_WANT_DURATION | MM_FILE_WANT_AUDIO_CODEC, deadline);
+	if (attrs) {
+		mm_file_get_attrs (attrs, NULL,
+						MM_FILE_CONTENT_DURATION, duration,
+						MM_FILE_CONTENT_INCOMPLETE, incomplete,
+						NULL);
+		mm_file_destroy_content_attrs (attrs);
+	}
+
+	return ret;
+}
+
+/* an expired deadline stops the AMR frame scan and returns what is parsed so far, flagged as incomplete */
+static int
+mmfile_check_deadline (void)
+{
+	const int full_duration = _AMR_FRAME_NUM * _AMR_FRAME_DURATION;
+	const int deadlines[] = {0, 600000};
+	int duration = 0;
+	int incomplete = 0;
+	unsigned int i = 0;
+	int ret = 0;
+
+	/* no deadline, or one which is not reached, parses the whole file */
+	for (i = 0; i < sizeof (deadlines) / sizeof (deadlines[0]); i++) {
+		ret = _deadline_extract (deadlines[i], &duration, &incomplete);
+		if (ret != MM_ERROR_NONE || incomplete != 0 || duration != full_duration) {
+			printf ("deadline: %d ms, error=[%x], incomplete %d, duration %d, expected %d\n",
+					deadlines[i], ret, incomplete, duration, full_duration);
+			return -1;
+		}
+	}
+
+	/* an expired deadline is not an error, the result carries the flag instead */
+	ret = _deadline_extract (1, &duration, &incomplete);
+	if (ret != MM_ERROR_NONE || incomplete != 1 || duration >= full_duration) {
+		printf ("deadline: 1 ms, error=[%x], incomplete %d, duration %d of %d\n", ret, incomplete, duration, full_duration);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+_file_read (void *user_data, unsigned char *buf, int size)
+{
+	FILE *fp = (FILE *) user_data;
+	size_t readed = fread (buf, 1, size, fp);
+
+	if (readed == 0 && ferror (fp))
+		return -1;
+
+	return (int) readed;
+}
+
+static long long
+_file_seek (void *user_data, long long offset, int whence)
+{
+	FILE *fp = (FILE *) user_data;
+
+	if (fseeko (fp, (off_t) offset, whence) != 0)
+		return -1;
+
+	return (long long) ftello (fp);
+}
+
+static long long
+_file_size (void *user_data)
+{
+	struct stat st;
+
+	if (fstat (fileno ((FILE *) user_data), &st) != 0)
+		return -1;
+
+	return (long long) st.st_size;
+}
+
+/* the same bytes read through callbacks give the same attributes as the file path, with and without the size callback */
+static int
+mmfile_check_callback (void)
+{
+	const char *paths[] = {g_fixture.wav, g_fixture.mp3};
+	MMFileCheckContent expected_content;
+	MMFileCheckContent content;
+	MMFileCheckTag expected_tag;
+	MMFileCheckTag tag;
+	MMFileIOCallbacks callbacks;
+	MMHandleType attrs = 0;
+	FILE *fp = NULL;
+	unsigned int i = 0;
+	int with_size = 0;
+	int ret = 0;
+
+	for (i = 0; i < sizeof (paths) / sizeof (paths[0]); i++) {
+		if (_get_reference (paths[i], &expected_content, &expected_tag) != 0)
+			return -1;
+
+		for (with_size = 0; with_size < 2; with_size++) {
+			memset (&callbacks, 0x00, sizeof (MMFileIOCallbacks));
+			callbacks.read = _file_read;
+			callbacks.seek = _file_seek;
+			callbacks.size = with_size ? _file_size : NULL;
+
+			fp = fopen (paths[i], "rb");
+			if (!fp)
+				return -1;
+
+			ret = -1;
+
+			attrs = 0;
+			if (mm_file_create_content_attrs_from_callbacks (&attrs, &callbacks, fp) != MM_ERROR_NONE ||
+				_get_content (attrs, &content) != MM_ERROR_NONE) {
+				printf ("callback: %s, no content attributes\n", paths[i]);
+				goto exception;
+			}
+			mm_file_destroy_content_attrs (attrs);
+			if (_expect_same_content ("callback", &content, &expected_content) != 0)
+				goto exception;
+
+			rewind (fp);
+
+			attrs = 0;
+			if (mm_file_create_tag_attrs_from_callbacks (&attrs, &callbacks, fp) != MM_ERROR_NONE ||
+				_get_tag (attrs, &tag) != MM_ERROR_NONE) {
+				printf ("callback: %s, no tag attributes\n", paths[i]);
+				goto exception;
+			}
+			mm_file_destroy_tag_attrs (attrs);
+			if (_expect_same_tag ("callback", &tag, &expected_tag) != 0)
+				goto exception;
+
+			ret = 0;
+
+exception:
+			fclose (fp);
+			if (ret != 0)
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+_io_stats_extract (const char *path, int tag, MMFileCheckContent *content, MMFileCheckTag *tag_values, MMFileIOStats *stats)
+{
+	MMHandleType attrs = 0;
+	int ret = 0;
+
+	if (tag) {
+		ret = mm_file_create_tag_attrs (&attrs, path);
+		if (ret == MM_ERROR_NONE)
+			ret = _get_tag (attrs, tag_values);
+		if (attrs)
+			mm_file_destroy_tag_attrs (attrs);
+	} else {
+		ret = mm_file_create_content_attrs (&attrs, path);
+		if (ret == MM_ERROR_NONE)
+			ret = _get_content (attrs, content);
+		if (attrs)
+			mm_file_destroy_content_attrs (attrs);
+	}
+
+	if (ret != MM_ERROR_NONE || mm_file_get_last_io_stats (stats) != MM_ERROR_NONE) {
+		printf ("io_stats: %s, error=[%x]\n", path, ret);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* a parse reports the I/O it did, an answer from the metadata cache reports none and gives the same attributes */
+static int
+mmfile_check_io_stats (void)
+{
+	const char *paths[] = {g_fixture.wav, g_fixture.mp3};
+	char index_path[_FIXTURE_PATH_MAX];
+	MMFileCheckContent expected_content;
+	MMFileCheckContent content;
+	MMFileCheckTag expected_tag;
+	MMFileCheckTag tag;
+	MMFileIOStats stats;
+	unsigned int i = 0;
+	int kind = 0;
+	int ret = -1;
+
+	snprintf (index_path, sizeof (index_path), "%s/cache.idx", g_fixture.dir);
+
+	if (mm_file_enable_cache (index_path, 16) != MM_ERROR_NONE) {
+		printf ("io_stats: failed to enable the cache at %s\n", index_path);
+		unlink (index_path);
+		return -1;
+	}
+
+	for (i = 0; i < sizeof (paths) / sizeof (paths[0]); i++) {
+		/* kind 0 is content, 1 is tag */
+		for (kind = 0; kind < 2; kind++) {
+			if (_io_stats_extract (paths[i], kind, &expected_content, &expected_tag, &stats) != 0)
+				goto exception;
+			if (stats.open_count == 0 || stats.read_count == 0 || stats.read_bytes == 0) {
+				printf ("io_stats: %s, parse reports %u opens, %u reads, %llu bytes\n",
+						paths[i], stats.open_count, stats.read_count, stats.read_bytes);
+				goto exception;
+			}
+
+			if (_io_stats_extract (paths[i], kind, &content, &tag, &stats) != 0)
+				goto exception;
+			if (stats.open_count || stats.read_count || stats.read_bytes || stats.seek_count || stats.discontiguous_reads) {
+				printf ("io_stats: %s, cache hit reports %u opens, %u reads, %llu bytes, %u seeks, %u discontiguous reads\n",
+						paths[i], stats.open_count, stats.read_count, stats.read_bytes, stats.seek_count, stats.discontiguous_reads);
+				goto exception;
+			}
+
+			if (kind == 0 && _expect_same_content ("io_stats", &content, &expected_content) != 0)
+				goto exception;
+			if (kind == 1 && _expect_same_tag ("io_stats", &tag, &expected_tag) != 0)
+				goto exception;
+		}
+	}
+
+	ret = 0;
+
+exception:
+	mm_file_disable_cache ();
+	unlink (index_path);
+
+	return ret;
+}
+
+static const MMFileCheck g_checks[] = {
+	{"session",		mmfile_check_session},
+	{"batch",		mmfile_check_batch},
+	{"async",		mmfile_check_async},
+	{"deadline",	mmfile_check_deadline},
+	{"callback",	mmfile_check_callback},
+	{"io_stats",	mmfile_check_io_stats},
+};
+
+int main (int argc, char **argv)
+{
+	unsigned int i = 0;
+	int failed = 0;
+
+	if (_fixture_create () != 0) {
+		_fixture_remove ();
+		return 1;
+	}
+
+	for (i = 0; i < sizeof (g_checks) / sizeof (g_checks[0]); i++) {
+		if (g_checks[i].func () != 0) {
+			printf ("FAIL: %s\n", g_checks[i].name);
+			failed++;
+		} else {
+			printf ("PASS: %s\n", g_checks[i].name);
+		}
+	}
+
+	_fixture_remove ();
+
+	return failed ? 1 : 0;
+}
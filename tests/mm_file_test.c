@@ -28,6 +28,7 @@
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <unistd.h>
+#include <pthread.h>
 
 #include <mm_file.h>
 #include <mm_error.h>
@@ -123,6 +124,39 @@ FILE *fpFailList = NULL;
 
 static int mmfile_get_file_infomation (void *data, void* user_data, bool file_test);
 
+/**
+ * test modes, given after the path: mm_file_test <file or directory> [mode]
+ * without a mode, every attribute is printed by mmfile_get_file_infomation().
+ */
+typedef int (*MMFileTestFunc) (const char *path);
+
+typedef struct {
+	const char		*name;
+	MMFileTestFunc	func;
+	bool			whole_dir;	/* takes the directory itself instead of each file */
+	const char		*help;
+} MMFileTestMode;
+
+static int mmfile_test_session (const char *path);
+static int mmfile_test_batch (const char *path);
+static int mmfile_test_async (const char *path);
+static int mmfile_test_cancel (const char *path);
+static int mmfile_test_deadline (const char *path);
+static int mmfile_test_info (const char *path);
+static int mmfile_test_callback (const char *path);
+static int mmfile_test_iostats (const char *path);
+
+static const MMFileTestMode g_test_modes[] = {
+	{"session",		mmfile_test_session,	false,	"stream, content, tag and thumbnail from one session"},
+	{"batch",		mmfile_test_batch,		true,	"content of all files of the directory in parallel"},
+	{"async",		mmfile_test_async,		false,	"content in background, with the stages reported"},
+	{"cancel",		mmfile_test_cancel,		false,	"requests cancelled right after they are made"},
+	{"deadline",	mmfile_test_deadline,	false,	"content with shrinking time budgets"},
+	{"info",		mmfile_test_info,		false,	"content and tag through the struct API"},
+	{"callback",	mmfile_test_callback,	false,	"content and tag read through I/O callbacks"},
+	{"iostats",		mmfile_test_iostats,	false,	"I/O done by each kind of extraction"},
+};
+
 inline static int mm_file_is_little_endian (void)
 {
     int i = 0x00000001;
@@ -158,10 +192,52 @@ _is_file_exist (const char *filename)
 }
 
 
+static const MMFileTestMode *
+_find_test_mode (const char *name)
+{
+	unsigned int i = 0;
+
+	for (i = 0; i < sizeof (g_test_modes) / sizeof (g_test_modes[0]); i++) {
+		if (strcmp (name, g_test_modes[i].name) == 0)
+			return &g_test_modes[i];
+	}
+
+	printf ("unknown mode [%s], modes are:\n", name);
+	for (i = 0; i < sizeof (g_test_modes) / sizeof (g_test_modes[0]); i++)
+		printf ("  %-10s %s\n", g_test_modes[i].name, g_test_modes[i].help);
+
+	return NULL;
+}
+
+static int mmfile_run_test_mode (void *data, void* user_data, bool file_test)
+{
+	const MMFileTestMode *mode = (const MMFileTestMode *) user_data;
+	int ret = 0;
+
+	MM_TIME_CHECK_START
+
+	printf ("[%s] %s\n", mode->name, (char *) data);
+	ret = mode->func ((const char *) data);
+	if (ret != 0 && fpFailList != NULL)
+		fprintf (fpFailList, "[%s] %s\n", mode->name, (char *) data);
+	printf ("=================================================\n\n");
+
+	MM_TIME_CHECK_FINISH ((char *) data);
+
+	return ret;
+}
+
 int main(int argc, char **argv)
 {
     struct stat statbuf;
 	bool file_test = true;		//if you want to test mm_file_create_content_XXX_from_memory() set file_test to false
+	const MMFileTestMode *mode = NULL;
+
+	if (argc > 2) {
+		mode = _find_test_mode (argv[2]);
+		if (mode == NULL)
+			return MMFILE_FAIL;
+	}
 
     if (_is_file_exist (argv[1])) {
     	int ret = lstat (argv[1], &statbuf);
@@ -174,7 +250,12 @@ int main(int argc, char **argv)
 			fpFailList = fopen ("/opt/var/log/mmfile_fails.txt", "w");
 		}
 
-		if ( S_ISDIR (statbuf.st_mode) )	{
+		if (mode) {
+			if ( S_ISDIR (statbuf.st_mode) && !mode->whole_dir )
+				mmfile_get_file_names (argv[1], mmfile_run_test_mode, (void *) mode);
+			else
+				mmfile_run_test_mode (argv[1], (void *) mode, file_test);
+		} else if ( S_ISDIR (statbuf.st_mode) )	{
 			mmfile_get_file_names (argv[1], mmfile_get_file_infomation, NULL);
 		} else {
 			mmfile_get_file_infomation (argv[1], NULL, file_test);
@@ -399,3 +480,409 @@ static int mmfile_get_file_infomation (void *data, void* user_data, bool file_te
 
     return 0;
 }
+
+static int mmfile_test_session (const char *path)
+{
+	MMHandleType session = 0;
+	MMHandleType content_attrs = 0;
+	MMHandleType tag_attrs = 0;
+	int audio_track_num = 0;
+	int video_track_num = 0;
+	int duration = 0;
+	char *title = NULL;
+	int title_len = 0;
+	void *frame = NULL;
+	int frame_size = 0;
+	int width = 0;
+	int height = 0;
+	int ret = 0;
+
+	ret = mm_file_open_session (&session, path);
+	if (ret != MM_ERROR_NONE) {
+		printf ("Failed to mm_file_open_session() error=[%x]\n", ret);
+		return -1;
+	}
+
+	ret = mm_file_session_get_stream_info (session, &audio_track_num, &video_track_num);
+	if (ret == MM_ERROR_NONE)
+		printf ("# audio=%d, video=%d\n", audio_track_num, video_track_num);
+	else
+		printf ("Failed to mm_file_session_get_stream_info() error=[%x]\n", ret);
+
+	ret = mm_file_session_get_content_attrs (session, &content_attrs);
+	if (ret == MM_ERROR_NONE && content_attrs) {
+		mm_file_get_attrs (content_attrs, NULL, MM_FILE_CONTENT_DURATION, &duration, NULL);
+		printf ("# duration: %d\n", duration);
+	} else {
+		printf ("Failed to mm_file_session_get_content_attrs() error=[%x]\n", ret);
+	}
+
+	ret = mm_file_session_get_tag_attrs (session, &tag_attrs);
+	if (ret == MM_ERROR_NONE && tag_attrs) {
+		mm_file_get_attrs (tag_attrs, NULL, MM_FILE_TAG_TITLE, &title, &title_len, NULL);
+		printf ("# title: %s\n", title);
+	} else {
+		printf ("Failed to mm_file_session_get_tag_attrs() error=[%x]\n", ret);
+	}
+
+	if (video_track_num) {
+		ret = mm_file_session_get_thumbnail (session, &frame, &frame_size, &width, &height);
+		if (ret == MM_ERROR_NONE)
+			printf ("# thumbnail: %p, %d bytes, %d x %d\n", frame, frame_size, width, height);
+		else
+			printf ("Failed to mm_file_session_get_thumbnail() error=[%x]\n", ret);
+	}
+
+	/* attribute handles and the thumbnail are owned by the session */
+	mm_file_close_session (session);
+
+	return 0;
+}
+
+static int _collect_file_name (void *data, void* user_data, bool file_test)
+{
+	GList **file_list = (GList **) user_data;
+
+	*file_list = g_list_append (*file_list, strdup ((char *) data));
+
+	return 0;
+}
+
+static void _batch_done (const char *filename, int result, MMHandleType content_attrs, void *user_data)
+{
+	int duration = 0;
+
+	if (result == MM_ERROR_NONE && content_attrs) {
+		mm_file_get_attrs (content_attrs, NULL, MM_FILE_CONTENT_DURATION, &duration, NULL);
+		printf ("# %s: duration %d\n", filename, duration);
+		mm_file_destroy_content_attrs (content_attrs);
+	} else {
+		printf ("# %s: error=[%x]\n", filename, result);
+	}
+}
+
+static int mmfile_test_batch (const char *path)
+{
+	struct stat statbuf;
+	GList *file_list = NULL;
+	GList *iter = NULL;
+	const char **filenames = NULL;
+	int num = 0;
+	int i = 0;
+	int ret = 0;
+
+	if (lstat (path, &statbuf) == 0 && S_ISDIR (statbuf.st_mode))
+		mmfile_get_file_names ((char *) path, _collect_file_name, &file_list);
+	else
+		file_list = g_list_append (file_list, strdup (path));
+
+	num = g_list_length (file_list);
+	filenames = malloc (sizeof (char *) * num);
+	if (filenames == NULL) {
+		ret = -1;
+		goto exception;
+	}
+
+	for (iter = file_list, i = 0; iter; iter = g_list_next (iter), i++)
+		filenames[i] = (const char *) iter->data;
+
+	/* audio files are reported first, video files wait for their thumbnail */
+	ret = mm_file_create_content_attrs_batch (filenames, num, 0, _batch_done, NULL);
+	if (ret != MM_ERROR_NONE)
+		printf ("Failed to mm_file_create_content_attrs_batch() error=[%x]\n", ret);
+
+	free (filenames);
+
+exception:
+	for (iter = file_list; iter; iter = g_list_next (iter))
+		free (iter->data);
+	g_list_free (file_list);
+
+	return (ret == MM_ERROR_NONE) ? 0 : -1;
+}
+
+typedef struct {
+	pthread_mutex_t	lock;
+	pthread_cond_t	cond;
+	int				pending;	/* requests not finished */
+	int				cancelled;
+} MMFileAsyncWait;
+
+static void _async_progress (int id, int stage, int result, MMHandleType content_attrs, void *user_data)
+{
+	MMFileAsyncWait *wait = (MMFileAsyncWait *) user_data;
+	int duration = 0;
+
+	switch (stage) {
+		case MM_FILE_ASYNC_STAGE_OPEN:		printf ("# [%d] opened\n", id);	return;
+		case MM_FILE_ASYNC_STAGE_STREAM:	printf ("# [%d] stream read\n", id);	return;
+		case MM_FILE_ASYNC_STAGE_THUMBNAIL:	printf ("# [%d] thumbnail decoded\n", id);	return;
+		case MM_FILE_ASYNC_STAGE_DONE:
+			if (result == MM_ERROR_NONE && content_attrs) {
+				mm_file_get_attrs (content_attrs, NULL, MM_FILE_CONTENT_DURATION, &duration, NULL);
+				printf ("# [%d] done, duration %d\n", id, duration);
+				mm_file_destroy_content_attrs (content_attrs);
+			} else {
+				printf ("# [%d] done, error=[%x]\n", id, result);
+			}
+			break;
+		case MM_FILE_ASYNC_STAGE_CANCELLED:
+			printf ("# [%d] cancelled\n", id);
+			break;
+		default:
+			return;
+	}
+
+	pthread_mutex_lock (&wait->lock);
+	if (stage == MM_FILE_ASYNC_STAGE_CANCELLED)
+		wait->cancelled++;
+	wait->pending--;
+	pthread_cond_signal (&wait->cond);
+	pthread_mutex_unlock (&wait->lock);
+}
+
+static int _async_run (const char *path, int num, bool cancel)
+{
+	MMFileAsyncWait wait;
+	int ids[4];
+	int i = 0;
+
+	memset (&wait, 0x00, sizeof (MMFileAsyncWait));
+	pthread_mutex_init (&wait.lock, NULL);
+	pthread_cond_init (&wait.cond, NULL);
+
+	for (i = 0; i < num; i++) {
+		pthread_mutex_lock (&wait.lock);
+		ids[i] = mm_file_create_content_attrs_async (path, MM_FILE_WANT_ALL, _async_progress, &wait);
+		if (ids[i] > 0)
+			wait.pending++;
+		pthread_mutex_unlock (&wait.lock);
+
+		if (ids[i] <= 0)
+			printf ("Failed to mm_file_create_content_attrs_async() error=[%x]\n", ids[i]);
+	}
+
+	/* the last requests are still waiting for a worker, they are dropped at once */
+	for (i = num - 1; cancel && i >= 0; i--) {
+		if (ids[i] > 0 && mm_file_cancel (ids[i]) != MM_ERROR_NONE)
+			printf ("# [%d] finished before mm_file_cancel()\n", ids[i]);
+	}
+
+	pthread_mutex_lock (&wait.lock);
+	while (wait.pending > 0)
+		pthread_cond_wait (&wait.cond, &wait.lock);
+	pthread_mutex_unlock (&wait.lock);
+
+	printf ("# %d requests, %d cancelled\n", num, wait.cancelled);
+
+	pthread_cond_destroy (&wait.cond);
+	pthread_mutex_destroy (&wait.lock);
+
+	return 0;
+}
+
+static int mmfile_test_async (const char *path)
+{
+	return _async_run (path, 1, false);
+}
+
+static int mmfile_test_cancel (const char *path)
+{
+	return _async_run (path, 4, true);
+}
+
+static int mmfile_test_deadline (const char *path)
+{
+	static const int deadlines[] = {0, 1000, 100, 10, 1};
+	MMHandleType content_attrs = 0;
+	struct timeval start, finish;
+	int duration = 0;
+	int incomplete = 0;
+	int elapsed = 0;
+	unsigned int i = 0;
+	int ret = 0;
+
+	for (i = 0; i < sizeof (deadlines) / sizeof (deadlines[0]); i++) {
+		gettimeofday (&start, NULL);
+		ret = mm_file_create_content_attrs_with_deadline (&content_attrs, path, MM_FILE_WANT_ALL, deadlines[i]);
+		gettimeofday (&finish, NULL);
+		elapsed = (finish.tv_sec - start.tv_sec) * 1000 + (finish.tv_usec - start.tv_usec) / 1000;
+
+		if (ret != MM_ERROR_NONE || !content_attrs) {
+			printf ("# deadline %4d ms: error=[%x] after %d ms\n", deadlines[i], ret, elapsed);
+			continue;
+		}
+
+		duration = 0;
+		incomplete = 0;
+		mm_file_get_attrs (content_attrs, NULL,
+								MM_FILE_CONTENT_DURATION, &duration,
+								MM_FILE_CONTENT_INCOMPLETE, &incomplete,
+								NULL);
+		printf ("# deadline %4d ms: %s after %d ms, duration %d\n", deadlines[i], incomplete ? "incomplete" : "complete", elapsed, duration);
+
+		mm_file_destroy_content_attrs (content_attrs);
+		content_attrs = 0;
+	}
+
+	return 0;
+}
+
+static int mmfile_test_info (const char *path)
+{
+	MMFileContentInfo content_info;
+	MMFileTagInfo tag_info;
+	unsigned long time_info = 0;
+	char *lyrics_info = NULL;
+	int idx = 0;
+	int ret = 0;
+
+	ret = mm_file_get_content_info (path, MM_FILE_WANT_ALL, &content_info);
+	if (ret == MM_ERROR_NONE) {
+		printf ("[Content] ------------------------------------- \n");
+		printf ("# duration: %d\n", content_info.duration);
+		printf ("# audio: codec %d, %d Hz, %d bps, %d ch, %d tracks\n", content_info.audio_codec, content_info.audio_samplerate,
+				content_info.audio_bitrate, content_info.audio_channels, content_info.audio_track_count);
+		printf ("# video: codec %d, %d x %d, %d fps, %d bps, %d tracks\n", content_info.video_codec, content_info.video_width,
+				content_info.video_height, content_info.video_fps, content_info.video_bitrate, content_info.video_track_count);
+		printf ("# thumbnail: %p, %d bytes\n", content_info.thumbnail, content_info.thumbnail_size);
+		mm_file_free_content_info (&content_info);
+	} else {
+		printf ("Failed to mm_file_get_content_info() error=[%x]\n", ret);
+	}
+
+	ret = mm_file_get_tag_info (path, &tag_info);
+	if (ret == MM_ERROR_NONE) {
+		printf ("[Tag] ----------------------------------------- \n");
+		printf ("# artist: %s\n", tag_info.artist);
+		printf ("# title: %s\n", tag_info.title);
+		printf ("# album: %s\n", tag_info.album);
+		printf ("# genre: %s\n", tag_info.genre);
+		printf ("# artwork: %p, %d bytes, %s\n", tag_info.artwork, tag_info.artwork_size, tag_info.artwork_mime);
+		printf ("# synclyrics size: %d\n", tag_info.synclyrics_num);
+
+		for (idx = 0; idx < tag_info.synclyrics_num; idx++) {
+			ret = mm_file_get_tag_info_synclyrics (&tag_info, idx, &time_info, &lyrics_info);
+			if (ret != MM_ERROR_NONE) {
+				printf ("Error when get lyrics\n");
+				break;
+			}
+			printf ("[%2d][%6lu][%s]\n", idx, time_info, lyrics_info);
+		}
+
+		mm_file_free_tag_info (&tag_info);
+	} else {
+		printf ("Failed to mm_file_get_tag_info() error=[%x]\n", ret);
+	}
+
+	return 0;
+}
+
+/* I/O callbacks over a stdio stream, the media data is never given by path */
+static int _file_read (void *user_data, unsigned char *buf, int size)
+{
+	FILE *fp = (FILE *) user_data;
+	size_t readed = fread (buf, 1, size, fp);
+
+	if (readed == 0 && ferror (fp))
+		return -1;
+
+	return (int) readed;
+}
+
+static long long _file_seek (void *user_data, long long offset, int whence)
+{
+	FILE *fp = (FILE *) user_data;
+
+	if (fseeko (fp, (off_t) offset, whence) != 0)
+		return -1;
+
+	return (long long) ftello (fp);
+}
+
+static int mmfile_test_callback (const char *path)
+{
+	MMFileIOCallbacks callbacks;
+	MMHandleType content_attrs = 0;
+	MMHandleType tag_attrs = 0;
+	FILE *fp = NULL;
+	int duration = 0;
+	char *title = NULL;
+	int title_len = 0;
+	int ret = 0;
+
+	fp = fopen (path, "r");
+	if (fp == NULL) {
+		printf ("failed to open [%s]\n", path);
+		return -1;
+	}
+
+	memset (&callbacks, 0x00, sizeof (MMFileIOCallbacks));
+	callbacks.read = _file_read;
+	callbacks.seek = _file_seek;
+	callbacks.size = NULL;	/* taken by seeking to the end */
+
+	ret = mm_file_create_content_attrs_from_callbacks (&content_attrs, &callbacks, fp);
+	if (ret == MM_ERROR_NONE && content_attrs) {
+		mm_file_get_attrs (content_attrs, NULL, MM_FILE_CONTENT_DURATION, &duration, NULL);
+		printf ("# duration: %d\n", duration);
+		mm_file_destroy_content_attrs (content_attrs);
+	} else {
+		printf ("Failed to mm_file_create_content_attrs_from_callbacks() error=[%x]\n", ret);
+	}
+
+	rewind (fp);
+
+	ret = mm_file_create_tag_attrs_from_callbacks (&tag_attrs, &callbacks, fp);
+	if (ret == MM_ERROR_NONE && tag_attrs) {
+		mm_file_get_attrs (tag_attrs, NULL, MM_FILE_TAG_TITLE, &title, &title_len, NULL);
+		printf ("# title: %s\n", title);
+		mm_file_destroy_tag_attrs (tag_attrs);
+	} else {
+		printf ("Failed to mm_file_create_tag_attrs_from_callbacks() error=[%x]\n", ret);
+	}
+
+	fclose (fp);
+
+	return 0;
+}
+
+static void _print_io_stats (const char *title)
+{
+	MMFileIOStats stats;
+
+	if (mm_file_get_last_io_stats (&stats) != MM_ERROR_NONE) {
+		printf ("Failed to mm_file_get_last_io_stats()\n");
+		return;
+	}
+
+	printf ("# %-10s open %u, read %u (%llu bytes), seek %u, discontiguous %u\n", title,
+			stats.open_count, stats.read_count, stats.read_bytes, stats.seek_count, stats.discontiguous_reads);
+}
+
+static int mmfile_test_iostats (const char *path)
+{
+	MMHandleType attrs = 0;
+	int audio_track_num = 0;
+	int video_track_num = 0;
+
+	if (mm_file_get_stream_info (path, &audio_track_num, &video_track_num) == MM_ERROR_NONE)
+		_print_io_stats ("stream");
+
+	if (mm_file_create_content_attrs_simple (&attrs, path) == MM_ERROR_NONE) {
+		_print_io_stats ("simple");
+		mm_file_destroy_content_attrs (attrs);
+	}
+
+	if (mm_file_create_content_attrs (&attrs, path) == MM_ERROR_NONE) {
+		_print_io_stats ("content");
+		mm_file_destroy_content_attrs (attrs);
+	}
+
+	if (mm_file_create_tag_attrs (&attrs, path) == MM_ERROR_NONE) {
+		_print_io_stats ("tag");
+		mm_file_destroy_tag_attrs (attrs);
+	}
+
+	return 0;
+}
@@ -0,0 +1,374 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "mm_file_utils.h"
+
+/**
+ * checks of the utils library which need no media file, run by make check.
+ * each check returns 0 on success and prints what went wrong otherwise.
+ */
+typedef int (*MMFileCheckFunc) (void);
+
+typedef struct {
+	const char		*name;
+	MMFileCheckFunc	func;
+} MMFileCheck;
+
+#define _MP3_SYNC_MASK		0xE0
+#define _MP3_SYNC_VALUE		0xE0
+#define _SYNC_BUFFER_MAX	256
+
+static int
+_find_sync_reference (const unsigned char *buffer, int length, unsigned char mask, unsigned char value)
+{
+	int i = 0;
+
+	for (i = 0; i < length - 1; i++) {
+		if (buffer[i] == 0xFF && (buffer[i + 1] & mask) == value)
+			return i;
+	}
+
+	return -1;
+}
+
+static int
+_check_sync_one (const unsigned char *buffer, int length, const char *what)
+{
+	int expected = _find_sync_reference (buffer, length, _MP3_SYNC_MASK, _MP3_SYNC_VALUE);
+	int found = mmfile_util_find_sync (buffer, length, _MP3_SYNC_MASK, _MP3_SYNC_VALUE);
+
+	if (found != expected) {
+		printf ("find_sync: %s, length %d: found %d, expected %d\n", what, length, found, expected);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* the vector paths must agree with the byte loop, also across block edges and at the buffer end */
+static int
+mmfile_check_find_sync (void)
+{
+	unsigned char buffer[_SYNC_BUFFER_MAX];
+	int length = 0;
+	int pos = 0;
+	int round = 0;
+	int i = 0;
+
+	if (mmfile_util_find_sync (NULL, 16, _MP3_SYNC_MASK, _MP3_SYNC_VALUE) != -1)
+		return -1;
+
+	for (length = 0; length <= _SYNC_BUFFER_MAX; length++) {
+		/* one sync word at every position, in a buffer of false candidates */
+		for (pos = 0; pos + 1 < length; pos++) {
+			memset (buffer, 0xFF, length);
+			for (i = 1; i < length; i += 2)
+				buffer[i] = 0x1F;
+			if (pos > 0)
+				buffer[pos - 1] = 0x00;
+			buffer[pos] = 0xFF;
+			buffer[pos + 1] = 0xFB;
+
+			if (_check_sync_one (buffer, length, "single") != 0)
+				return -1;
+		}
+
+		/* 0xFF as the last byte has no header after it */
+		memset (buffer, 0x00, length);
+		if (length > 0)
+			buffer[length - 1] = 0xFF;
+		if (_check_sync_one (buffer, length, "last byte") != 0)
+			return -1;
+	}
+
+	srand (1);
+	for (round = 0; round < 10000; round++) {
+		length = rand () % (_SYNC_BUFFER_MAX + 1);
+		for (i = 0; i < length; i++)
+			buffer[i] = (rand () & 1) ? 0xFF : (unsigned char) rand ();
+
+		if (_check_sync_one (buffer, length, "random") != 0)
+			return -1;
+	}
+
+	return 0;
+}
+
+#define _CACHE_KIND		1
+
+static void
+_cache_make_test_key (MMFileCacheKey *key, int n)
+{
+	memset (key, 0x00, sizeof (MMFileCacheKey));
+	key->dev = 1;
+	key->ino = 1000 + n;
+	key->size = 4096 * n;
+	key->mtime = 1300000000 + n;
+}
+
+static int
+_cache_expect (MMFileCache *cache, int n, int hit, const char *what)
+{
+	MMFileCacheKey key;
+	unsigned char data[MMFILE_CACHE_DATA_MAX];
+	unsigned int mask = 0;
+	unsigned int size = 0;
+	int ret = 0;
+
+	_cache_make_test_key (&key, n);
+	ret = mmfile_cache_lookup (cache, &key, _CACHE_KIND, &mask, data, &size);
+
+	if (hit && (ret != MMFILE_UTIL_SUCCESS || mask != (unsigned int) n || size != sizeof (int) || memcmp (data, &n, sizeof (int)) != 0)) {
+		printf ("cache: %s, record %d is missing or wrong\n", what, n);
+		return -1;
+	}
+	if (!hit && ret == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: %s, record %d should be gone\n", what, n);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int
+_cache_store (MMFileCache *cache, int n)
+{
+	MMFileCacheKey key;
+
+	_cache_make_test_key (&key, n);
+
+	return mmfile_cache_store (cache, &key, _CACHE_KIND, n, &n, sizeof (int));
+}
+
+/* round trip, key identity, LRU eviction in a set, and an index kept across opens */
+static int
+mmfile_check_cache (void)
+{
+	char path[] = "/tmp/mmfile_cache_XXXXXX";
+	unsigned char big[MMFILE_CACHE_DATA_MAX + 1];
+	MMFileCache *cache = NULL;
+	MMFileCacheKey key;
+	struct stat statbuf;
+	unsigned int header[8];
+	unsigned int magic = 0;
+	off_t index_size = 0;
+	unsigned int mask = 0;
+	unsigned int size = 0;
+	int fd = -1;
+	int n = 0;
+	int ret = -1;
+
+	fd = mkstemp (path);
+	if (fd < 0)
+		return -1;
+
+	/* not an index yet, it is initialized */
+	if (write (fd, "garbage", 7) != 7)
+		goto exception;
+	close (fd);
+	fd = -1;
+
+	/* a single set of 8 ways */
+	if (mmfile_cache_open (&cache, path, 8) != MMFILE_UTIL_SUCCESS) {
+		printf ("cache: can not open a new index\n");
+		goto exception;
+	}
+
+	if (mmfile_cache_make_key ("/tmp", &key) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: a directory has a key\n");
+		goto exception;
+	}
+
+	memset (big, 0x00, sizeof (big));
+	_cache_make_test_key (&key, 1);
+	if (mmfile_cache_store (cache, &key, _CACHE_KIND, 0, big, sizeof (big)) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: a record over MMFILE_CACHE_DATA_MAX is stored\n");
+		goto exception;
+	}
+
+	for (n = 1; n <= 8; n++) {
+		if (_cache_store (cache, n) != MMFILE_UTIL_SUCCESS)
+			goto exception;
+	}
+	for (n = 1; n <= 8; n++) {
+		if (_cache_expect (cache, n, 1, "filled set") != 0)
+			goto exception;
+	}
+
+	/* another kind or a modified file is a miss */
+	_cache_make_test_key (&key, 1);
+	if (mmfile_cache_lookup (cache, &key, _CACHE_KIND + 1, &mask, big, &size) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: hit with another kind\n");
+		goto exception;
+	}
+	key.mtime++;
+	if (mmfile_cache_lookup (cache, &key, _CACHE_KIND, &mask, big, &size) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: hit for a modified file\n");
+		goto exception;
+	}
+
+	/* 1 is the oldest but just used, so 2 is evicted */
+	if (_cache_expect (cache, 1, 1, "before eviction") != 0 || _cache_store (cache, 9) != MMFILE_UTIL_SUCCESS)
+		goto exception;
+	if (_cache_expect (cache, 2, 0, "evicted") != 0 ||
+		_cache_expect (cache, 1, 1, "recently used") != 0 ||
+		_cache_expect (cache, 9, 1, "new") != 0)
+		goto exception;
+
+	mmfile_cache_close (cache);
+	cache = NULL;
+
+	/* a live index keeps its geometry and records when reopened with another size */
+	if (mmfile_cache_open (&cache, path, 64) != MMFILE_UTIL_SUCCESS) {
+		printf ("cache: can not reopen the index\n");
+		goto exception;
+	}
+	if (_cache_expect (cache, 9, 1, "reopened") != 0)
+		goto exception;
+	mmfile_cache_close (cache);
+	cache = NULL;
+
+	/* an index of another slot size is refused, not truncated */
+	fd = open (path, O_RDWR);
+	if (fd < 0 || pread (fd, header, sizeof (header), 0) != sizeof (header))
+		goto exception;
+	header[3]++;
+	if (pwrite (fd, header, sizeof (header), 0) != sizeof (header) || fstat (fd, &statbuf) < 0)
+		goto exception;
+	index_size = statbuf.st_size;
+
+	if (mmfile_cache_open (&cache, path, 8) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache: an incompatible index is opened\n");
+		goto exception;
+	}
+	cache = NULL;
+
+	if (fstat (fd, &statbuf) < 0 || statbuf.st_size != index_size ||
+		pread (fd, &magic, sizeof (magic), 0) != sizeof (magic) || magic != header[0]) {
+		printf ("cache: an incompatible index is truncated\n");
+		goto exception;
+	}
+
+	ret = 0;
+
+exception:
+	if (cache)
+		mmfile_cache_close (cache);
+	if (fd >= 0)
+		close (fd);
+	unlink (path);
+
+	return ret;
+}
+
+/* a file rewritten in place within the same second, with the same size, is a miss */
+static int
+mmfile_check_cache_key (void)
+{
+	char index_path[] = "/tmp/mmfile_cache_XXXXXX";
+	char media_path[] = "/tmp/mmfile_media_XXXXXX";
+	struct timespec times[2];
+	unsigned char data[MMFILE_CACHE_DATA_MAX];
+	MMFileCache *cache = NULL;
+	MMFileCacheKey key;
+	unsigned int mask = 0;
+	unsigned int size = 0;
+	int index_fd = -1;
+	int media_fd = -1;
+	int n = 1;
+	int ret = -1;
+
+	index_fd = mkstemp (index_path);
+	media_fd = mkstemp (media_path);
+	if (index_fd < 0 || media_fd < 0)
+		goto exception;
+
+	if (mmfile_cache_open (&cache, index_path, 8) != MMFILE_UTIL_SUCCESS)
+		goto exception;
+
+	/* both times are pinned inside one second, whatever the file system granularity */
+	times[0].tv_sec = times[1].tv_sec = 1300000000;
+	times[0].tv_nsec = times[1].tv_nsec = 100000000;
+	if (pwrite (media_fd, "ID3 tag v1", 10, 0) != 10 || futimens (media_fd, times) < 0)
+		goto exception;
+
+	if (mmfile_cache_make_key (media_path, &key) != MMFILE_UTIL_SUCCESS ||
+		mmfile_cache_store (cache, &key, _CACHE_KIND, n, &n, sizeof (int)) != MMFILE_UTIL_SUCCESS ||
+		mmfile_cache_lookup (cache, &key, _CACHE_KIND, &mask, data, &size) != MMFILE_UTIL_SUCCESS) {
+		printf ("cache_key: the record of an unchanged file is missing\n");
+		goto exception;
+	}
+
+	times[0].tv_nsec = times[1].tv_nsec = 600000000;
+	if (pwrite (media_fd, "ID3 tag v2", 10, 0) != 10 || futimens (media_fd, times) < 0)
+		goto exception;
+
+	if (mmfile_cache_make_key (media_path, &key) != MMFILE_UTIL_SUCCESS)
+		goto exception;
+	if (mmfile_cache_lookup (cache, &key, _CACHE_KIND, &mask, data, &size) == MMFILE_UTIL_SUCCESS) {
+		printf ("cache_key: hit for a file rewritten in the same second\n");
+		goto exception;
+	}
+
+	ret = 0;
+
+exception:
+	if (cache)
+		mmfile_cache_close (cache);
+	if (index_fd >= 0)
+		close (index_fd);
+	if (media_fd >= 0)
+		close (media_fd);
+	unlink (index_path);
+	unlink (media_path);
+
+	return ret;
+}
+
+static const MMFileCheck g_checks[] = {
+	{"find_sync",	mmfile_check_find_sync},
+	{"cache",		mmfile_check_cache},
+	{"cache_key",	mmfile_check_cache_key},
+};
+
+int main (int argc, char **argv)
+{
+	unsigned int i = 0;
+	int failed = 0;
+
+	for (i = 0; i < sizeof (g_checks) / sizeof (g_checks[0]); i++) {
+		if (g_checks[i].func () != 0) {
+			printf ("FAIL: %s\n", g_checks[i].name);
+			failed++;
+		} else {
+			printf ("PASS: %s\n", g_checks[i].name);
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -86,6 +86,25 @@ int MMFileFormatIsValidOGG (const char *mmfileuri);
 int MMFileFormatIsValidMatroska (const char *mmfileuri);
 int MMFileFormatIsValidQT (const char *mmfileuri);
 
+#define MMFILE_PROBE_HEAD_SIZE		(100 * 1024 + 16)	/*covers the widest header scan*/
+#define MMFILE_PROBE_TAIL_SIZE		256
+#define MMFILE_PROBE_SCORE_MAX		100
+#define MMFILE_PROBE_SCORE_WEAK		20	/*only good enough to confirm the file extension*/
+#define MMFILE_PROBE_RESULT_MAX		8
+
+typedef struct {
+	int format;	/* MM_FILE_FORMAT_XXX */
+	int score;	/* confidence, 1 ~ MMFILE_PROBE_SCORE_MAX */
+} MMFileProbeResult;
+
+struct MMFileIOHandle;
+
+int MMFileFormatProbe (const char *mmfileuri, MMFileProbeResult *result, int max);
+int MMFileFormatProbeBuffer (struct MMFileIOHandle *fp, long long filesize, const unsigned char *head, int headLen, const unsigned char *tail, int tailLen, MMFileProbeResult *result, int max);
+
+/* offset of the first 0xFF byte followed by a byte matching (byte & mask) == value, -1 if none */
+int mmfile_util_find_sync (const unsigned char *buffer, int length, unsigned char mask, unsigned char value);
+
 
 ////////////////////////////////////////////////////////////////////////
 //                       IO HANDLER API                               //
@@ -99,6 +118,8 @@ int MMFileFormatIsValidQT (const char *mmfileuri);
 #define MMFILE_MEM_URI_LEN     6
 #define MMFILE_MMAP_URI        "mmap://"
 #define MMFILE_MMAP_URI_LEN    7
+#define MMFILE_CALLBACK_URI    "callback://"
+#define MMFILE_CALLBACK_URI_LEN 11
 
 #define MMFILE_RDONLY		O_RDONLY
 #define MMFILE_WRONLY		O_WRONLY
@@ -108,12 +129,40 @@ int MMFileFormatIsValidQT (const char *mmfileuri);
 #define MMFILE_SEEK_CUR		SEEK_CUR
 #define MMFILE_SEEK_END		SEEK_END
 
+#define MMFILE_IO_BLOCK_SIZE_DEFAULT	(64 * 1024)
+
+/* access pattern hints, see mmfile_advise */
+#define MMFILE_ACCESS_NORMAL		0
+#define MMFILE_ACCESS_SEQUENTIAL	1
+#define MMFILE_ACCESS_RANDOM		2
+
+/* I/O reaching the source, reads served from the block buffer are not counted */
+typedef struct
+{
+    unsigned int        opens;
+    unsigned int        reads;      /* read, pread and peek calls of the source */
+    unsigned long long  bytes;
+    unsigned int        seeks;
+    unsigned int        jumps;      /* reads not starting where the previous one ended */
+} MMFileIOCounters;
+
 typedef struct MMFileIOHandle
 {
     struct MMFileIOFunc *iofunc;
     int     flags;         /* file flags */
     void   *privateData;
     char   *fileName;
+
+    /* block buffer of read only handles, NULL when reads go to the source */
+    unsigned char *block;
+    int     blockSize;
+    int     blockLen;      /* valid bytes in block */
+    long long blockPos;    /* source offset of block[0] */
+    long long pos;         /* offset seen by the caller */
+    long long rawPos;      /* offset of the source */
+
+    MMFileIOCounters counters;     /* added to the thread's counters on close */
+    long long readEnd;     /* source offset after the last read, -1 before the first one */
 } MMFileIOHandle;
 
 typedef struct MMFileIOFunc
@@ -125,7 +174,12 @@ typedef struct MMFileIOFunc
 	long long	(*mmfile_seek) (MMFileIOHandle *h, long long pos, int whence);
 	long long	(*mmfile_tell) (MMFileIOHandle *h);
 	int			(*mmfile_close)(MMFileIOHandle *h);
+	int			(*mmfile_pread)(MMFileIOHandle *h, unsigned char *buf, int size, long long offset);
+	int			(*mmfile_peek) (MMFileIOHandle *h, long long offset, int size, const unsigned char **ptr);
+	void		(*mmfile_release)(MMFileIOHandle *h, const unsigned char *ptr);	/*ends a peek, NULL if lent memory stays valid*/
+	int			(*mmfile_advise)(MMFileIOHandle *h, int pattern);
 	struct MMFileIOFunc *next;
+	int			buffered;	/* small reads are served from a block buffer */
 } MMFileIOFunc;
 
 
@@ -138,6 +192,22 @@ int			mmfile_write(MMFileIOHandle *h, unsigned char *buf, int size);
 long long	mmfile_seek (MMFileIOHandle *h, long long pos, int whence);
 long long	mmfile_tell (MMFileIOHandle *h);
 int			mmfile_close(MMFileIOHandle *h);
+int			mmfile_pread(MMFileIOHandle *h, unsigned char *buf, int size, long long offset);	/*position of h is kept*/
+int			mmfile_peek (MMFileIOHandle *h, long long offset, int size, const unsigned char **ptr);	/*give ptr back with mmfile_peek_release*/
+void		mmfile_peek_release (MMFileIOHandle *h, const unsigned char *ptr);
+/*
+ * mmfile_pread, mmfile_peek and mmfile_peek_release may be called from several threads
+ * on one handle if its source has pread (file, mem and mmap). The other calls move the
+ * handle position or block buffer, one thread at a time.
+ */
+int			mmfile_advise (MMFileIOHandle *h, int pattern);	/*MMFILE_ACCESS_XXX, a hint only*/
+
+/* block size for handles opened afterwards, 0 disables the block buffer */
+void		mmfile_set_io_block_size (int size);
+
+/* handles closed on the calling thread add their counters to counters, NULL to stop */
+void		mmfile_io_counters_set_current (MMFileIOCounters *counters);
+MMFileIOCounters *mmfile_io_counters_get_current (void);
 
 
 
@@ -233,6 +303,68 @@ MMFileList mmfile_list_remove_all (MMFileList list, void *data);
 MMFileList mmfile_list_reverse (MMFileList list);
 void mmfile_list_free (MMFileList list);
 
+////////////////////////////////////////////////////////////////////////
+//                          THREAD POOL API                           //
+////////////////////////////////////////////////////////////////////////
+typedef void (*MMFileTaskFunc) (void *task, void *user_data);
+int mmfile_pool_get_cpu_count (void);
+/* tasks are ordered by priority, most urgent first. num_workers <= 0 means cpu count */
+int mmfile_pool_run (void **tasks, int num_tasks, int num_workers, MMFileTaskFunc func, void *user_data);
+
+
+
+////////////////////////////////////////////////////////////////////////
+//                            CACHE API                               //
+////////////////////////////////////////////////////////////////////////
+#define MMFILE_CACHE_DATA_MAX   2048
+
+typedef struct _MMFileCache MMFileCache;
+
+typedef struct
+{
+    unsigned long long  dev;
+    unsigned long long  ino;
+    long long           size;
+    long long           mtime;
+    long long           mtime_nsec;
+    long long           ctime;      /* changed by any rewrite, also one restoring the mtime */
+    long long           ctime_nsec;
+} MMFileCacheKey;
+
+int mmfile_cache_open (MMFileCache **cache, const char *path, int max_entries);
+void mmfile_cache_close (MMFileCache *cache);
+/* stat() the file, fails for non regular files */
+int mmfile_cache_make_key (const char *path, MMFileCacheKey *key);
+/* data should have MMFILE_CACHE_DATA_MAX bytes */
+int mmfile_cache_lookup (MMFileCache *cache, const MMFileCacheKey *key, unsigned int kind, unsigned int *mask, void *data, unsigned int *size);
+int mmfile_cache_store (MMFileCache *cache, const MMFileCacheKey *key, unsigned int kind, unsigned int mask, const void *data, unsigned int size);
+
+
+
+////////////////////////////////////////////////////////////////////////
+//                            ABORT API                               //
+////////////////////////////////////////////////////////////////////////
+#define MMFILE_ABORT_NONE       0
+#define MMFILE_ABORT_CANCELLED  1
+#define MMFILE_ABORT_EXPIRED    2
+
+typedef struct
+{
+    int             cancelled;  /* set by another thread, use mmfile_abort_cancel()/mmfile_abort_is_cancelled() */
+    long long       deadline;   /* mmfile_abort_get_time() based, 0 is no deadline */
+} MMFileAbort;
+
+/* monotonic clock in milliseconds */
+long long mmfile_abort_get_time (void);
+/* attach abort state to the calling thread, NULL to detach */
+void mmfile_abort_set_current (MMFileAbort *abort);
+MMFileAbort *mmfile_abort_get_current (void);
+/* may be called from any thread */
+void mmfile_abort_cancel (MMFileAbort *abort);
+int mmfile_abort_is_cancelled (MMFileAbort *abort);
+/* returns MMFILE_ABORT_XXX, non zero if the extraction on the calling thread should stop */
+int mmfile_abort_check (void);
+
 
 
 ////////////////////////////////////////////////////////////////////////
@@ -357,8 +489,15 @@ typedef enum {
 #define MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH	65
 #define MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH		31
 #define MP3_ID3_IMAGE_EXT_MAX_LENGTH			4
+#define MP3_ID3_FRAME_INDEX_STEP				16
 #define TCC_FM_PATH_MOUNT_MMC					"/Mount/Mmc"
 
+/* frame types of mm_file_id3tag_decode */
+#define AV_ID3V2_FRAME_TEXT		0x01	/* text, comment, genre and url frames */
+#define AV_ID3V2_FRAME_IMAGE	0x02	/* attached picture */
+#define AV_ID3V2_FRAME_LYRICS	0x04	/* unsynchronised and synchronised lyrics */
+#define AV_ID3V2_FRAME_ALL		0x07
+
 
 
 typedef enum {
@@ -383,6 +522,14 @@ typedef struct{
 	
 } AvTagVer2ImageInfo;
 
+typedef struct{
+	char			id[5];
+	unsigned char	type;		// AV_ID3V2_FRAME_XXX
+	unsigned char	encoding;	// first content byte, the text encoding of most frames
+	unsigned int	offset;		// content offset from the start of the tag
+	unsigned int	size;		// content size
+} AvTagVer2Frame;
+
  typedef struct{
 	int		tagLen;
 	char	tagVersion;
@@ -412,6 +559,14 @@ typedef struct{
 
 	bool	bGenreUTF16;
 
+	// frame index of mm_file_id3tag_parse_v2xx, decoded by mm_file_id3tag_decode
+	AvTagVer2Frame	*pFrames;
+	int		frameNum;
+	int		frameAlloc;
+	unsigned int	indexedLen;	// tag bytes the index refers to
+	int		indexVersion;
+	int		decodedFrames;	// AV_ID3V2_FRAME_XXX done
+
 } AvTagVer2AdditionalData;
 
  
@@ -461,13 +616,15 @@ typedef struct
 	unsigned int	objectType;
 	unsigned int	headerType;
 	long long		fileLen;		// mp3 ������ ��ü ����
-	long			headerPos;		// mp3 ����?ó������ ��Ÿ���� ��ġ
+	long long		headerPos;		// mp3 ����?ó������ ��Ÿ���� ��ġ
 	long long		datafileLen;	// ID3Tag���� �����ϰ� ���� mp3 frame���� ���� ,  VBR�϶� XHEADDATA �� bytes �� �ش��Ѵ�
 	int				frameSize;		// mp3 frame �� ���� ũ��
 	int				frameNum;		// mp3 ���Ͽ� �������� � ����ִ°?
 	bool			bVbr;			// VBR mp3?
 	bool			bPadding;		// Padding?
 	bool			bV1tagFound;
+	bool			bTagDecoded;	// tag frames are decoded by the first read_tag
+	unsigned char	frameDataValid[4];	// masked header of the first frame, to confirm the next sync
 
 	char			*pTitle;		//Title/songname/
 	char			*pArtist;		//Lead performer(s)/Soloist(s), 
@@ -546,6 +703,7 @@ inline static void mm_file_free_AvFileContentInfo (AvFileContentInfo *pInfo)
 		if (strlen(pInfo->imageInfo.imageMIMEType)>0) memset(pInfo->imageInfo.imageMIMEType, 0, MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH);
 		if (pInfo->pTransactionID) mmfile_free (pInfo->pTransactionID);
 		if (pInfo->pUnsyncLyrics) mmfile_free (pInfo->pUnsyncLyrics);
+		if (pInfo->tagV2Info.pFrames) mmfile_free (pInfo->tagV2Info.pFrames);
 	}
 }
 
@@ -554,6 +712,8 @@ bool	mm_file_id3tag_parse_v110 (AvFileContentInfo* pInfo, unsigned char *buffer)
 bool	mm_file_id3tag_parse_v222 (AvFileContentInfo* pInfo, unsigned char *buffer);
 bool	mm_file_id3tag_parse_v223 (AvFileContentInfo* pInfo, unsigned char *buffer);
 bool	mm_file_id3tag_parse_v224 (AvFileContentInfo* pInfo, unsigned char *buffer);
+/* buffer holds the same tag bytes as given to the parse function, at least tagV2Info.indexedLen */
+void	mm_file_id3tag_decode (AvFileContentInfo* pInfo, const unsigned char *buffer, int frameTypes);
 void	mm_file_id3tag_restore_content_info (AvFileContentInfo* pInfo);
 int		MMFileUtilGetMetaDataFromMP4 (MMFileFormatContext *formatContext);
 
@@ -0,0 +1,82 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <time.h>
+#include "mm_file_utils.h"
+
+/**
+ * The abort state of the extraction running on this thread.
+ * It is per thread so that long loops deep inside the format parsers can poll it
+ * without passing it through every parser API.
+ */
+static __thread MMFileAbort *g_current_abort = NULL;
+
+EXPORT_API
+long long mmfile_abort_get_time (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+
+    return (long long) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+EXPORT_API
+void mmfile_abort_set_current (MMFileAbort *abort)
+{
+    g_current_abort = abort;
+}
+
+EXPORT_API
+MMFileAbort *mmfile_abort_get_current (void)
+{
+    return g_current_abort;
+}
+
+EXPORT_API
+void mmfile_abort_cancel (MMFileAbort *abort)
+{
+    __atomic_store_n (&abort->cancelled, 1, __ATOMIC_RELEASE);
+}
+
+EXPORT_API
+int mmfile_abort_is_cancelled (MMFileAbort *abort)
+{
+    return __atomic_load_n (&abort->cancelled, __ATOMIC_ACQUIRE);
+}
+
+EXPORT_API
+int mmfile_abort_check (void)
+{
+    MMFileAbort *abort = g_current_abort;
+
+    if (!abort)
+        return MMFILE_ABORT_NONE;
+
+    if (mmfile_abort_is_cancelled (abort))
+        return MMFILE_ABORT_CANCELLED;
+
+    if (abort->deadline > 0 && mmfile_abort_get_time () >= abort->deadline)
+        return MMFILE_ABORT_EXPIRED;
+
+    return MMFILE_ABORT_NONE;
+}
@@ -0,0 +1,372 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <mm_debug.h>
+#include "mm_file_utils.h"
+
+/**
+ * Metadata cache in a memory-mapped index file.
+ *
+ * The index is set associative: a key hashes to one set of MMFILE_CACHE_WAYS slots,
+ * and a new record replaces an empty slot or the least recently used slot of its set.
+ * Each slot is guarded by a sequence counter which is odd while the slot is written.
+ * Readers take no lock: they copy the slot and retry nothing, a counter change
+ * during the copy is simply a miss. Writers are serialized by a mutex inside the
+ * process and by a fcntl() lock on the index file between processes.
+ *
+ * An index in use is never resized: a later open adopts the geometry stored in
+ * its header, so other processes keep a valid mapping. Only a file without a
+ * valid header is (re)initialized, under the write lock.
+ */
+
+#define MMFILE_CACHE_MAGIC      0x4D4D4643  /* "MMFC" */
+#define MMFILE_CACHE_VERSION    2
+#define MMFILE_CACHE_WAYS       8
+
+typedef struct
+{
+    unsigned int    magic;
+    unsigned int    version;
+    unsigned int    num_slots;
+    unsigned int    slot_size;
+    unsigned int    clock;      /* LRU clock, bumped on every hit and store */
+    unsigned int    reserved[3];
+} MMFileCacheHeader;
+
+typedef struct
+{
+    unsigned int    seq;        /* odd while written */
+    unsigned int    kind;       /* 0 is empty slot */
+    unsigned int    mask;
+    unsigned int    last_used;
+    MMFileCacheKey  key;
+    unsigned int    size;
+    unsigned int    reserved;
+    unsigned char   data[MMFILE_CACHE_DATA_MAX];
+} MMFileCacheSlot;
+
+struct _MMFileCache
+{
+    int                 fd;
+    void               *map;
+    unsigned int        map_size;
+    unsigned int        num_sets;
+    MMFileCacheHeader  *header;
+    MMFileCacheSlot    *slots;
+    pthread_mutex_t     write_lock;
+};
+
+static unsigned int _mmfile_cache_hash (const MMFileCacheKey *key, unsigned int kind)
+{
+    const unsigned char *p = (const unsigned char *) key;
+    unsigned int hash = 2166136261U;    /* FNV-1a */
+    unsigned int i = 0;
+
+    for (i = 0; i < sizeof (MMFileCacheKey); i++)
+    {
+        hash ^= p[i];
+        hash *= 16777619U;
+    }
+
+    hash ^= kind;
+    hash *= 16777619U;
+
+    return hash;
+}
+
+static int _mmfile_cache_key_equal (const MMFileCacheKey *a, const MMFileCacheKey *b)
+{
+    return a->dev == b->dev && a->ino == b->ino && a->size == b->size &&
+           a->mtime == b->mtime && a->mtime_nsec == b->mtime_nsec &&
+           a->ctime == b->ctime && a->ctime_nsec == b->ctime_nsec;
+}
+
+static int _mmfile_cache_file_lock (int fd, short type)
+{
+    struct flock fl;
+
+    memset (&fl, 0x00, sizeof (fl));
+    fl.l_type = type;
+    fl.l_whence = SEEK_SET;
+
+    return fcntl (fd, F_SETLKW, &fl);
+}
+
+EXPORT_API
+int mmfile_cache_open (MMFileCache **cache, const char *path, int max_entries)
+{
+    MMFileCache *handle = NULL;
+    MMFileCacheHeader *header = NULL;
+    MMFileCacheHeader stored;
+    unsigned int num_slots = 0;
+    unsigned int map_size = 0;
+    struct stat statbuf;
+    int init = 1;
+    int fd = -1;
+
+    if (!cache || !path || max_entries <= 0)
+    {
+        debug_error ("invalid param\n");
+        return MMFILE_UTIL_FAIL;
+    }
+
+    num_slots = ((max_entries + MMFILE_CACHE_WAYS - 1) / MMFILE_CACHE_WAYS) * MMFILE_CACHE_WAYS;
+    map_size = sizeof (MMFileCacheHeader) + num_slots * sizeof (MMFileCacheSlot);
+
+    fd = open (path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        debug_error ("can not open cache file [%s]\n", path);
+        return MMFILE_UTIL_FAIL;
+    }
+
+    if (_mmfile_cache_file_lock (fd, F_WRLCK) < 0)
+    {
+        debug_error ("can not lock cache file [%s]\n", path);
+        goto exception;
+    }
+
+    if (fstat (fd, &statbuf) < 0)
+    {
+        debug_error ("can not stat cache file [%s]\n", path);
+        goto exception;
+    }
+
+    if (statbuf.st_size >= sizeof (MMFileCacheHeader) &&
+        pread (fd, &stored, sizeof (MMFileCacheHeader), 0) == sizeof (MMFileCacheHeader) &&
+        stored.magic == MMFILE_CACHE_MAGIC)
+    {
+        /* a live index, other processes may map it */
+        if (stored.version != MMFILE_CACHE_VERSION || stored.slot_size != sizeof (MMFileCacheSlot) ||
+            stored.num_slots == 0 || stored.num_slots % MMFILE_CACHE_WAYS ||
+            statbuf.st_size != sizeof (MMFileCacheHeader) + (off_t) stored.num_slots * sizeof (MMFileCacheSlot))
+        {
+            debug_error ("incompatible cache file [%s]\n", path);
+            goto exception;
+        }
+
+        if (stored.num_slots != num_slots)
+            debug_warning ("cache file [%s] keeps its %u slots\n", path, stored.num_slots);
+
+        num_slots = stored.num_slots;
+        map_size = sizeof (MMFileCacheHeader) + num_slots * sizeof (MMFileCacheSlot);
+        init = 0;
+    }
+    else
+    {
+        /* new, empty or not an index, nobody can be using it */
+        if (ftruncate (fd, 0) < 0 || ftruncate (fd, map_size) < 0)
+        {
+            debug_error ("can not resize cache file [%s]\n", path);
+            goto exception;
+        }
+    }
+
+    handle = mmfile_malloc (sizeof (MMFileCache));
+    if (!handle)
+    {
+        debug_error ("mmfile_malloc: MMFileCache\n");
+        goto exception;
+    }
+
+    handle->map = mmap (NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (handle->map == MAP_FAILED)
+    {
+        debug_error ("can not mmap cache file [%s]\n", path);
+        goto exception;
+    }
+
+    header = (MMFileCacheHeader *) handle->map;
+    if (init)
+    {
+        memset (handle->map, 0x00, map_size);
+        header->version = MMFILE_CACHE_VERSION;
+        header->num_slots = num_slots;
+        header->slot_size = sizeof (MMFileCacheSlot);
+        header->magic = MMFILE_CACHE_MAGIC;
+        msync (handle->map, map_size, MS_ASYNC);
+    }
+
+    _mmfile_cache_file_lock (fd, F_UNLCK);
+
+    handle->fd = fd;
+    handle->map_size = map_size;
+    handle->num_sets = num_slots / MMFILE_CACHE_WAYS;
+    handle->header = header;
+    handle->slots = (MMFileCacheSlot *) ((unsigned char *) handle->map + sizeof (MMFileCacheHeader));
+    pthread_mutex_init (&handle->write_lock, NULL);
+
+    *cache = handle;
+
+    return MMFILE_UTIL_SUCCESS;
+
+exception:
+    if (handle)
+    {
+        if (handle->map && handle->map != MAP_FAILED)
+            munmap (handle->map, map_size);
+        mmfile_free (handle);
+    }
+
+    _mmfile_cache_file_lock (fd, F_UNLCK);
+    close (fd);
+
+    return MMFILE_UTIL_FAIL;
+}
+
+EXPORT_API
+void mmfile_cache_close (MMFileCache *cache)
+{
+    if (!cache)
+        return;
+
+    munmap (cache->map, cache->map_size);
+    close (cache->fd);
+    pthread_mutex_destroy (&cache->write_lock);
+
+    mmfile_free (cache);
+}
+
+EXPORT_API
+int mmfile_cache_make_key (const char *path, MMFileCacheKey *key)
+{
+    struct stat statbuf;
+
+    if (!path || !key)
+        return MMFILE_UTIL_FAIL;
+
+    if (stat (path, &statbuf) < 0 || !S_ISREG (statbuf.st_mode))
+        return MMFILE_UTIL_FAIL;
+
+    memset (key, 0x00, sizeof (MMFileCacheKey));
+    key->dev = statbuf.st_dev;
+    key->ino = statbuf.st_ino;
+    key->size = statbuf.st_size;
+    key->mtime = statbuf.st_mtime;
+    key->mtime_nsec = statbuf.st_mtim.tv_nsec;
+    key->ctime = statbuf.st_ctime;
+    key->ctime_nsec = statbuf.st_ctim.tv_nsec;
+
+    return MMFILE_UTIL_SUCCESS;
+}
+
+EXPORT_API
+int mmfile_cache_lookup (MMFileCache *cache, const MMFileCacheKey *key, unsigned int kind, unsigned int *mask, void *data, unsigned int *size)
+{
+    MMFileCacheSlot *set = NULL;
+    unsigned int seq = 0;
+    unsigned int i = 0;
+
+    if (!cache || !key || !kind || !mask || !data || !size)
+        return MMFILE_UTIL_FAIL;
+
+    set = cache->slots + (_mmfile_cache_hash (key, kind) % cache->num_sets) * MMFILE_CACHE_WAYS;
+
+    for (i = 0; i < MMFILE_CACHE_WAYS; i++)
+    {
+        MMFileCacheSlot *slot = set + i;
+
+        seq = slot->seq;
+        __sync_synchronize ();
+
+        if ((seq & 1) || slot->kind != kind || !_mmfile_cache_key_equal (&slot->key, key))
+            continue;
+
+        *mask = slot->mask;
+        *size = slot->size;
+        if (*size > MMFILE_CACHE_DATA_MAX)
+            return MMFILE_UTIL_FAIL;
+        memcpy (data, slot->data, *size);
+
+        /* the slot was rewritten while copying */
+        __sync_synchronize ();
+        if (slot->seq != seq)
+            return MMFILE_UTIL_FAIL;
+
+        /* racy but harmless, it only steers eviction */
+        slot->last_used = __sync_add_and_fetch (&cache->header->clock, 1);
+
+        return MMFILE_UTIL_SUCCESS;
+    }
+
+    return MMFILE_UTIL_FAIL;
+}
+
+EXPORT_API
+int mmfile_cache_store (MMFileCache *cache, const MMFileCacheKey *key, unsigned int kind, unsigned int mask, const void *data, unsigned int size)
+{
+    MMFileCacheSlot *set = NULL;
+    MMFileCacheSlot *victim = NULL;
+    unsigned int i = 0;
+
+    if (!cache || !key || !kind || !data || size > MMFILE_CACHE_DATA_MAX)
+        return MMFILE_UTIL_FAIL;
+
+    set = cache->slots + (_mmfile_cache_hash (key, kind) % cache->num_sets) * MMFILE_CACHE_WAYS;
+
+    pthread_mutex_lock (&cache->write_lock);
+    if (_mmfile_cache_file_lock (cache->fd, F_WRLCK) < 0)
+    {
+        pthread_mutex_unlock (&cache->write_lock);
+        return MMFILE_UTIL_FAIL;
+    }
+
+    /* same file, empty slot, then least recently used */
+    for (i = 0; i < MMFILE_CACHE_WAYS; i++)
+    {
+        MMFileCacheSlot *slot = set + i;
+
+        if (slot->kind == kind && _mmfile_cache_key_equal (&slot->key, key))
+        {
+            victim = slot;
+            break;
+        }
+
+        if (!victim || (victim->kind && (!slot->kind || (int)(slot->last_used - victim->last_used) < 0)))
+            victim = slot;
+    }
+
+    /* odd while written, also when a writer died in the middle of a store */
+    victim->seq = (victim->seq | 1);
+    __sync_synchronize ();
+
+    victim->kind = kind;
+    victim->mask = mask;
+    victim->key = *key;
+    victim->size = size;
+    memcpy (victim->data, data, size);
+    victim->last_used = __sync_add_and_fetch (&cache->header->clock, 1);
+
+    __sync_synchronize ();
+    victim->seq = (victim->seq | 1) + 1;
+
+    _mmfile_cache_file_lock (cache->fd, F_UNLCK);
+    pthread_mutex_unlock (&cache->write_lock);
+
+    return MMFILE_UTIL_SUCCESS;
+}
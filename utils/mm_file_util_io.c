@@ -23,6 +23,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <pthread.h>
 #include "mm_debug.h"
 #include "mm_file_utils.h"
 
@@ -87,6 +88,141 @@ inline short mmfile_io_le_int16 (unsigned short value)
 
 MMFileIOFunc *first_io_func = NULL;
 
+static int g_io_block_size = MMFILE_IO_BLOCK_SIZE_DEFAULT;
+
+/* counters of the extraction running on this thread, see mmfile_close */
+static __thread MMFileIOCounters *g_current_counters = NULL;
+
+EXPORT_API
+void mmfile_set_io_block_size (int size)
+{
+	g_io_block_size = (size > 0) ? size : 0;
+}
+
+EXPORT_API
+void mmfile_io_counters_set_current (MMFileIOCounters *counters)
+{
+	g_current_counters = counters;
+}
+
+EXPORT_API
+MMFileIOCounters *mmfile_io_counters_get_current (void)
+{
+	return g_current_counters;
+}
+
+/**
+ * Counts a read of the source at offset. The counters are fields of the
+ * handle updated with atomic adds, since pread and peek may run on one
+ * handle from several threads. It costs a few adds and is always on.
+ */
+static inline void _mmfile_count_read (MMFileIOHandle *handle, long long offset, int readed)
+{
+	long long prevEnd = 0;
+
+	if (readed < 0)
+		return;
+
+	__sync_fetch_and_add (&handle->counters.reads, 1);
+	__sync_fetch_and_add (&handle->counters.bytes, readed);
+
+	prevEnd = __sync_lock_test_and_set (&handle->readEnd, offset + readed);
+	if (offset != prevEnd)
+		__sync_fetch_and_add (&handle->counters.jumps, 1);
+}
+
+/**
+ * Block buffer between the caller and a buffered source.
+ * Seeks only move the caller offset, the source is repositioned
+ * when the next block has to be read.
+ */
+static int _mmfile_block_read (MMFileIOHandle *handle, unsigned char *buf, int size)
+{
+	int copied = 0;
+	int chunk = 0;
+	int readed = 0;
+
+	while (copied < size) {
+		if (handle->pos >= handle->blockPos && handle->pos < handle->blockPos + handle->blockLen) {
+			chunk = (int)(handle->blockPos + handle->blockLen - handle->pos);
+			if (chunk > size - copied)
+				chunk = size - copied;
+
+			memcpy (buf + copied, handle->block + (handle->pos - handle->blockPos), chunk);
+			copied += chunk;
+			handle->pos += chunk;
+			continue;
+		}
+
+		if (handle->rawPos != handle->pos) {
+			handle->counters.seeks++;
+			if (handle->iofunc->mmfile_seek (handle, handle->pos, MMFILE_SEEK_SET) < 0) {
+				readed = MMFILE_IO_FAILED;
+				break;
+			}
+			handle->rawPos = handle->pos;
+		}
+
+		/* large reads go straight to the caller buffer */
+		if (size - copied >= handle->blockSize) {
+			readed = handle->iofunc->mmfile_read (handle, buf + copied, size - copied);
+			_mmfile_count_read (handle, handle->rawPos, readed);
+			if (readed <= 0)
+				break;
+
+			copied += readed;
+			handle->pos += readed;
+			handle->rawPos += readed;
+			continue;
+		}
+
+		readed = handle->iofunc->mmfile_read (handle, handle->block, handle->blockSize);
+		_mmfile_count_read (handle, handle->rawPos, readed);
+		if (readed <= 0) {
+			handle->blockLen = 0;
+			break;
+		}
+
+		handle->blockPos = handle->pos;
+		handle->blockLen = readed;
+		handle->rawPos += readed;
+	}
+
+	if (copied == 0 && readed < 0)
+		return MMFILE_IO_FAILED;
+
+	return copied;
+}
+
+static long long _mmfile_block_seek (MMFileIOHandle *handle, long long pos, int whence)
+{
+	long long target = 0;
+
+	switch (whence) {
+		case MMFILE_SEEK_SET:
+			target = pos;
+			break;
+		case MMFILE_SEEK_CUR:
+			target = handle->pos + pos;
+			break;
+		default:
+			/* only the source knows its end */
+			handle->counters.seeks++;
+			target = handle->iofunc->mmfile_seek (handle, pos, whence);
+			if (target < 0)
+				return MMFILE_IO_FAILED;
+			handle->rawPos = target;
+			break;
+	}
+
+	if (target < 0)
+		return MMFILE_IO_FAILED;
+
+	handle->pos = target;
+
+	return target;
+}
+
 static int _mmfile_open(MMFileIOHandle **handle, struct MMFileIOFunc *Func, const char *filename, int flags)
 {
 	MMFileIOHandle *pHandle = NULL;
@@ -130,6 +266,18 @@ static int _mmfile_open(MMFileIOHandle **handle, struct MMFileIOFunc *Func, cons
 		err = MMFILE_IO_FAILED;
 		goto fail;
 	}
+
+	pHandle->pos = pHandle->rawPos = Func->mmfile_tell (pHandle);
+	pHandle->readEnd = -1;
+	pHandle->counters.opens = 1;
+
+	/* without a block the handle simply stays unbuffered */
+	if (Func->buffered && g_io_block_size > 0 && !(flags & (MMFILE_WRONLY | MMFILE_RDWR))) {
+		pHandle->block = mmfile_malloc (g_io_block_size);
+		if (pHandle->block) {
+			pHandle->blockSize = g_io_block_size;
+		}
+	}
   
 	return MMFILE_IO_SUCCESS;
 
@@ -206,10 +354,129 @@ int mmfile_read(MMFileIOHandle *handle, unsigned char *buf, int size)
 		return MMFILE_IO_FAILED;
 	}
 
+	if (handle->block) {
+		return _mmfile_block_read (handle, buf, size);
+	}
+
 	ret = handle->iofunc->mmfile_read (handle, buf, size);
+	_mmfile_count_read (handle, handle->rawPos, ret);
+	if (ret > 0)
+		handle->rawPos += ret;
+
+	return ret;
+}
+
+EXPORT_API
+int mmfile_pread(MMFileIOHandle *handle, unsigned char *buf, int size, long long offset)
+{
+	long long pos = 0;
+	int ret = 0;
+
+	if (!handle || !buf || size < 0 || offset < 0 || (handle->flags & MMFILE_WRONLY)) {
+		return MMFILE_IO_FAILED;
+	}
+
+	if (!handle->iofunc) {
+		return MMFILE_IO_FAILED;
+	}
+
+	/* the block buffer is bypassed, so concurrent callers share nothing */
+	if (handle->iofunc->mmfile_pread) {
+		ret = handle->iofunc->mmfile_pread (handle, buf, size, offset);
+		_mmfile_count_read (handle, offset, ret);
+		return ret;
+	}
+
+	/* emulated for sources without it, the handle can't be shared then */
+	pos = mmfile_tell (handle);
+	if (mmfile_seek (handle, offset, MMFILE_SEEK_SET) < 0) {
+		return MMFILE_IO_FAILED;
+	}
+
+	ret = mmfile_read (handle, buf, size);
+	mmfile_seek (handle, pos, MMFILE_SEEK_SET);
+
 	return ret;
 }
 
+/**
+ * Memory backed sources lend a pointer into their data, the others read
+ * into a new copy. Either way the pointer is read only and goes back
+ * through mmfile_peek_release().
+ */
+EXPORT_API
+int mmfile_peek(MMFileIOHandle *handle, long long offset, int size, const unsigned char **ptr)
+{
+	unsigned char *copy = NULL;
+	int readed = 0;
+
+	if (!handle || !ptr || size < 0 || offset < 0 || !handle->iofunc) {
+		return MMFILE_IO_FAILED;
+	}
+
+	*ptr = NULL;
+
+	if (handle->iofunc->mmfile_peek) {
+		readed = handle->iofunc->mmfile_peek (handle, offset, size, ptr);
+		_mmfile_count_read (handle, offset, readed);
+		return readed;
+	}
+
+	/* one zeroed byte longer, as the parsers' own buffers used to be */
+	copy = mmfile_malloc (size + 1);
+	if (!copy) {
+		debug_error ("mmfile_malloc: peek copy\n");
+		return MMFILE_IO_FAILED;
+	}
+
+	readed = mmfile_pread (handle, copy, size, offset);
+	if (readed <= 0) {
+		mmfile_free (copy);
+		return readed;
+	}
+
+	*ptr = copy;
+
+	return readed;
+}
+
+EXPORT_API
+void mmfile_peek_release(MMFileIOHandle *handle, const unsigned char *ptr)
+{
+	unsigned char *copy = (unsigned char *)ptr;
+
+	if (!handle || !handle->iofunc || !ptr) {
+		return;
+	}
+
+	/* lent by the source */
+	if (handle->iofunc->mmfile_peek) {
+		if (handle->iofunc->mmfile_release)
+			handle->iofunc->mmfile_release (handle, ptr);
+		return;
+	}
+
+	mmfile_free (copy);
+}
+
+/**
+ * Tells the source how the content is going to be read, sources
+ * without read ahead control take it as success.
+ */
+EXPORT_API
+int mmfile_advise(MMFileIOHandle *handle, int pattern)
+{
+	if (!handle || !handle->iofunc) {
+		return MMFILE_IO_FAILED;
+	}
+
+	if (!handle->iofunc->mmfile_advise) {
+		return MMFILE_IO_SUCCESS;
+	}
+
+	return handle->iofunc->mmfile_advise (handle, pattern);
+}
+
 EXPORT_API
 int mmfile_write(MMFileIOHandle *handle, unsigned char *buf, int size)
 {
@@ -223,6 +490,9 @@ int mmfile_write(MMFileIOHandle *handle, unsigned char *buf, int size)
 	}
 
 	ret = handle->iofunc->mmfile_write (handle, buf, size);
+	if (ret > 0)
+		handle->rawPos += ret;
+
 	return ret;
 }
 
@@ -234,7 +504,15 @@ long long mmfile_seek(MMFileIOHandle *handle, long long pos, int whence)
 		return MMFILE_IO_FAILED;
 	}
 
+	if (handle->block) {
+		return _mmfile_block_seek (handle, pos, whence);
+	}
+
+	handle->counters.seeks++;
 	ret = handle->iofunc->mmfile_seek(handle, pos, whence);
+	if (ret >= 0)
+		handle->rawPos = ret;
+
 	return ret;
 }
 
@@ -246,6 +524,10 @@ long long mmfile_tell(MMFileIOHandle *handle)
 		return MMFILE_IO_FAILED;
 	}
 
+	if (handle->block) {
+		return handle->pos;
+	}
+
 	ret = handle->iofunc->mmfile_tell(handle);
 	return ret;
 }
@@ -261,10 +543,22 @@ int mmfile_close(MMFileIOHandle *handle)
 
 	ret = handle->iofunc->mmfile_close(handle);
 
+	if (g_current_counters) {
+		g_current_counters->opens += handle->counters.opens;
+		g_current_counters->reads += handle->counters.reads;
+		g_current_counters->bytes += handle->counters.bytes;
+		g_current_counters->seeks += handle->counters.seeks;
+		g_current_counters->jumps += handle->counters.jumps;
+	}
+
 	if (handle->fileName) {
 		mmfile_free(handle->fileName);
 	}
 
+	if (handle->block) {
+		mmfile_free(handle->block);
+	}
+
 	if (handle) mmfile_free(handle);
 
 	return ret;
@@ -289,25 +583,28 @@ int mmfile_register_io_func (MMFileIOFunc *iofunc)
 	return MMFILE_IO_SUCCESS;
 }
 
-EXPORT_API
-int mmfile_register_io_all ()
-{
-	static int initialized = 0;
-
-	if (initialized) {
-		return MMFILE_IO_FAILED;
-	}
-
-	is_little_endian = _is_little_endian ();
-	initialized = 1;
+static pthread_once_t io_once = PTHREAD_ONCE_INIT;
 
+static void _mmfile_register_io_all (void)
+{
 	extern MMFileIOFunc mmfile_file_io_handler;
 	extern MMFileIOFunc mmfile_mem_io_handler;
 	extern MMFileIOFunc mmfile_mmap_io_handler;
+	extern MMFileIOFunc mmfile_callback_io_handler;
+
+	is_little_endian = _is_little_endian ();
 
 	mmfile_register_io_func (&mmfile_file_io_handler);
 	mmfile_register_io_func (&mmfile_mem_io_handler);    
 	mmfile_register_io_func (&mmfile_mmap_io_handler);
+	mmfile_register_io_func (&mmfile_callback_io_handler);
+}
+
+EXPORT_API
+int mmfile_register_io_all ()
+{
+	/* the handler list is read without lock afterwards, so build it only once */
+	pthread_once (&io_once, _mmfile_register_io_all);
 
 	return MMFILE_IO_SUCCESS;
 }
@@ -0,0 +1,241 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mm_debug.h"
+#include "mm_file_utils.h"
+
+/**
+ * Content read through the caller's callbacks, "callback://%p" names the
+ * MM_FILE_SRC_TYPE_CALLBACK source. Several handles may be open on one
+ * source, so each handle keeps its own offset and seeks the source before
+ * reading.
+ */
+typedef struct {
+	MMFileSourceType *src;
+	long long size;
+	long long offset;
+} MMFCallbackIOHandle;
+
+static int mmf_callback_open (MMFileIOHandle *handle, const char *filename, int flags)
+{
+    MMFCallbackIOHandle *cbHandle = NULL;
+    MMFileSourceType *src = NULL;
+    void *ptr = NULL;
+
+    if (!handle || !filename || !handle->iofunc || !handle->iofunc->handleName)
+    {
+        debug_error ("invalid param\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    if (flags & (MMFILE_WRONLY | MMFILE_RDWR))
+    {
+        debug_error ("callback source is read only\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    filename += strlen(handle->iofunc->handleName) + 3; /* ://%p means source address */
+
+    if (sscanf (filename, "%p", &ptr) != 1 || !ptr)
+    {
+        debug_error ("invalid source [%s]\n", filename);
+        return MMFILE_IO_FAILED;
+    }
+
+    src = (MMFileSourceType *) ptr;
+    if (src->type != MM_FILE_SRC_TYPE_CALLBACK || !src->callback.read || !src->callback.seek)
+    {
+        debug_error ("invalid callback source\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle = mmfile_malloc (sizeof(MMFCallbackIOHandle));
+    if (!cbHandle)
+    {
+        debug_error ("error: mmfile_malloc cbHandle\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle->src = src;
+    cbHandle->offset = 0;
+
+    if (src->callback.size)
+    {
+        cbHandle->size = src->callback.size (src->callback.user_data);
+    }
+    else
+    {
+        cbHandle->size = src->callback.seek (src->callback.user_data, 0, SEEK_END);
+    }
+
+    if (cbHandle->size < 0)
+    {
+        debug_error ("failed to get source size\n");
+        mmfile_free (cbHandle);
+        return MMFILE_IO_FAILED;
+    }
+
+    handle->privateData = (void*) cbHandle;
+
+    return MMFILE_IO_SUCCESS;
+}
+
+static int mmf_callback_read (MMFileIOHandle *h, unsigned char *buf, int size)
+{
+    MMFCallbackIOHandle *cbHandle = NULL;
+    MMFileSourceType *src = NULL;
+    int len = 0;
+
+    if (!h || !h->privateData || !buf || size < 0)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle = h->privateData;
+    src = cbHandle->src;
+
+    if (cbHandle->offset >= cbHandle->size || size == 0)
+    {
+        return 0;
+    }
+
+    if (src->callback.seek (src->callback.user_data, cbHandle->offset, SEEK_SET) != cbHandle->offset)
+    {
+        debug_error ("source seek failed: %lld\n", cbHandle->offset);
+        return MMFILE_IO_FAILED;
+    }
+
+    len = size;
+    if (len > cbHandle->size - cbHandle->offset)
+    {
+        len = cbHandle->size - cbHandle->offset;
+    }
+
+    len = src->callback.read (src->callback.user_data, buf, len);
+    if (len < 0)
+    {
+        debug_error ("source read failed\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle->offset += len;
+
+    return len;
+}
+
+static int mmf_callback_write (MMFileIOHandle *h, unsigned char *buf, int size)
+{
+    debug_error ("NOT PERMITTED\n");
+    return MMFILE_IO_FAILED;
+}
+
+static long long mmf_callback_seek (MMFileIOHandle *h, long long pos, int whence)
+{
+    MMFCallbackIOHandle *cbHandle = NULL;
+    long long tmp_offset = 0;
+
+    if (!h || !h->privateData)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle = h->privateData;
+
+    switch (whence)
+    {
+        case SEEK_SET:
+            tmp_offset = 0 + pos;
+            break;
+        case SEEK_CUR:
+            tmp_offset = cbHandle->offset + pos;
+            break;
+        case SEEK_END:
+            tmp_offset = cbHandle->size + pos;
+            break;
+        default:
+            return MMFILE_IO_FAILED;
+    }
+
+    /*check validation*/
+    if (tmp_offset < 0)
+    {
+        debug_error ("invalid file offset\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    /* the source is moved on the next read */
+    cbHandle->offset = tmp_offset;
+
+    return cbHandle->offset;
+}
+
+static long long mmf_callback_tell (MMFileIOHandle *h)
+{
+    MMFCallbackIOHandle *cbHandle = NULL;
+
+    if (!h || !h->privateData)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    cbHandle = h->privateData;
+
+    return cbHandle->offset;
+}
+
+static int mmf_callback_close (MMFileIOHandle *h)
+{
+    if (!h || !h->privateData)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    /* the source belongs to the caller */
+    mmfile_free (h->privateData);
+    h->privateData = NULL;
+
+    return MMFILE_IO_SUCCESS;
+}
+
+
+MMFileIOFunc mmfile_callback_io_handler = {
+    "callback",
+    mmf_callback_open,
+    mmf_callback_read,
+    mmf_callback_write,
+    mmf_callback_seek,
+    mmf_callback_tell,
+    mmf_callback_close,
+    NULL,       /* pread by seek and read */
+    NULL,       /* no peek, copied */
+    NULL,
+    NULL,
+    NULL,
+    1,          /* buffered, callbacks may be costly */
+};
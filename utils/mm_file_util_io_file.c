@@ -106,6 +106,22 @@ static int file_read(MMFileIOHandle *handle, unsigned char *buf, int size)
     return readSize;
 }
 
+static int file_pread(MMFileIOHandle *handle, unsigned char *buf, int size, long long offset)
+{
+    tMMFORMAT_FILEIO_DATA *privateData = handle->privateData;
+    int readSize = 0;
+
+    /* the descriptor offset is left alone */
+    readSize = pread(privateData->fd, buf, size, offset);
+    if (readSize < 0)
+    {
+        debug_error ("pread\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    return readSize;
+}
+
 static int file_write(MMFileIOHandle *handle, unsigned char *buf, int size)
 {
     tMMFORMAT_FILEIO_DATA *privateData = handle->privateData;
@@ -155,6 +171,44 @@ static int file_close(MMFileIOHandle *handle)
 }
 
 
+static int file_advise(MMFileIOHandle *handle, int pattern)
+{
+    tMMFORMAT_FILEIO_DATA *privateData = NULL;
+    int advice = POSIX_FADV_NORMAL;
+    int ret = 0;
+
+    if (!handle || !handle->privateData)
+    {
+        debug_error ("invalid param\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    privateData = handle->privateData;
+
+    switch (pattern)
+    {
+        case MMFILE_ACCESS_SEQUENTIAL:
+            advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case MMFILE_ACCESS_RANDOM:
+            advice = POSIX_FADV_RANDOM;
+            break;
+        default:
+            advice = POSIX_FADV_NORMAL;
+            break;
+    }
+
+    ret = posix_fadvise (privateData->fd, 0, 0, advice);
+    if (ret != 0)
+    {
+        debug_warning ("posix_fadvise failed: %d\n", ret);
+        return MMFILE_IO_FAILED;
+    }
+
+    return MMFILE_IO_SUCCESS;
+}
+
+
 MMFileIOFunc mmfile_file_io_handler = {
     "file",
     file_open,
@@ -163,5 +217,11 @@ MMFileIOFunc mmfile_file_io_handler = {
     file_seek,
     file_tell,
     file_close,
+    file_pread,
+    NULL,       /* no peek, copied */
+    NULL,
+    file_advise,
+    NULL,
+    1,          /* buffered */
 };
 
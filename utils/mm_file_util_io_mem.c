@@ -37,64 +37,38 @@ typedef struct {
 static int mmf_mem_open (MMFileIOHandle *handle, const char *filename, int flags)
 {
     MMFmemIOHandle *memHandle = NULL;
-    char **splitedString = NULL;
-    
+    void *ptr = NULL;
+    unsigned long long size = 0;
+
     if (!handle || !filename || !handle->iofunc || !handle->iofunc->handleName)
     {
         debug_error ("invalid param\n");
         return MMFILE_IO_FAILED;    
     }
 
-    filename += strlen(handle->iofunc->handleName) + 3; /* ://%d:%d means (memory addr:mem size)*/
-
-    splitedString = mmfile_strsplit (filename, ":");
-    if (splitedString == NULL)
-    {   
-        debug_error ("invalid param\n");
-        return MMFILE_IO_FAILED;    
-    }
+    filename += strlen(handle->iofunc->handleName) + 3; /* ://%p:%u means (memory addr:mem size)*/
 
-    if (!splitedString[0] || !splitedString[1])
+    if (sscanf (filename, "%p:%llu", &ptr, &size) != 2 || !ptr)
     {
-        debug_error ("invalid param\n");
-        goto exception;    
+        debug_error ("invalid param [%s]\n", filename);
+        return MMFILE_IO_FAILED;
     }
 
     memHandle = mmfile_malloc (sizeof(MMFmemIOHandle));
     if (!memHandle)
     {
         debug_error ("error: mmfile_malloc memHandle\n");
-        goto exception;
+        return MMFILE_IO_FAILED;
     }
     
-    memHandle->ptr = (unsigned char*)atoi(splitedString[0]);
-    memHandle->size = atoi(splitedString[1]);
+    memHandle->ptr = (unsigned char*)ptr;
+    memHandle->size = size;
     memHandle->offset = 0;
     memHandle->state = 0;
 
     handle->privateData = (void*) memHandle;
 
-    if (splitedString)
-    {
-        mmfile_strfreev (splitedString);
-    }
-
     return MMFILE_IO_SUCCESS;
-
-exception:
-
-    if (splitedString)
-    {
-        mmfile_strfreev (splitedString);
-    }
-
-    if (memHandle)
-    {
-        mmfile_free (memHandle);
-        handle->privateData  = NULL;
-    }
-
-    return MMFILE_IO_FAILED;
 }
 
 static int mmf_mem_read (MMFileIOHandle *h, unsigned char *buf, int size)
@@ -140,6 +114,77 @@ static int mmf_mem_read (MMFileIOHandle *h, unsigned char *buf, int size)
     return len;
 }
 
+static int mmf_mem_pread (MMFileIOHandle *h, unsigned char *buf, int size, long long offset)
+{
+    MMFmemIOHandle *memHandle = NULL;
+    int len = 0;
+
+    if (!h || !h->privateData || !buf || size < 0 || offset < 0)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    memHandle = h->privateData;
+
+    if (!memHandle->ptr)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    if (offset >= memHandle->size)
+    {
+        return 0;
+    }
+
+    len = size;
+    if (len > memHandle->size - offset)
+    {
+        len = memHandle->size - offset;
+    }
+
+    memcpy (buf, memHandle->ptr + offset, len);
+
+    return len;
+}
+
+static int mmf_mem_peek (MMFileIOHandle *h, long long offset, int size, const unsigned char **ptr)
+{
+    MMFmemIOHandle *memHandle = NULL;
+    int len = 0;
+
+    if (!h || !h->privateData || !ptr || size < 0 || offset < 0)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    memHandle = h->privateData;
+    *ptr = NULL;
+
+    if (!memHandle->ptr)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    if (offset >= memHandle->size)
+    {
+        return 0;
+    }
+
+    len = size;
+    if (len > memHandle->size - offset)
+    {
+        len = memHandle->size - offset;
+    }
+
+    *ptr = memHandle->ptr + offset;
+
+    return len;
+}
+
 static int mmf_mem_write (MMFileIOHandle *h, unsigned char *buf, int size)
 {
     MMFmemIOHandle *memHandle = NULL;
@@ -181,7 +226,7 @@ static int mmf_mem_write (MMFileIOHandle *h, unsigned char *buf, int size)
 static long long mmf_mem_seek (MMFileIOHandle *h, long long pos, int whence)
 {
     MMFmemIOHandle *memHandle = NULL;
-    long tmp_offset = 0;
+    long long tmp_offset = 0;
 
     if (!h || !h->privateData)
     {
@@ -265,7 +310,9 @@ MMFileIOFunc mmfile_mem_io_handler = {
 	mmf_mem_write,
 	mmf_mem_seek,
 	mmf_mem_tell,
-	mmf_mem_close
+	mmf_mem_close,
+	mmf_mem_pread,
+	mmf_mem_peek
 };
 
 
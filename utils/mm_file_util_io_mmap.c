@@ -19,12 +19,13 @@
  *
  */
 
- 
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <unistd.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -33,25 +34,134 @@
 #include "mm_debug.h"
 #include "mm_file_utils.h"
 
+/**
+ * The file is mapped through a window of MMFILE_MMAP_WINDOW_SIZE bytes which
+ * moves with the accesses, so large files do not take the address space.
+ * A window still lent by mmf_mmap_peek is kept mapped until it is released.
+ *
+ * pread, peek and release may run on one handle from several threads: window
+ * changes are serialized by the handle lock, and pread pins the window while
+ * copying. pread outside the current window reads the fd and leaves the
+ * window where it is.
+ */
+#define MMFILE_MMAP_WINDOW_SIZE	(64 * 1024 * 1024)
+
+typedef struct _MMFMMapWindow {
+	unsigned char *ptr;
+	long long base;		/* file offset of ptr[0], page aligned */
+	long long len;
+	int refs;			/* peeks not released yet */
+	struct _MMFMMapWindow *next;
+} MMFMMapWindow;
 
 typedef struct {
 	int fd;
-	unsigned char *ptr;
+	int prot;
 	long long size;
 	long long offset;
 	int	state;
+	int advice;
+	MMFMMapWindow *window;	/* current window */
+	MMFMMapWindow *pinned;	/* replaced windows still lent out */
+	pthread_mutex_t lock;	/* guards window, pinned and refs */
 } MMFMMapIOHandle;
 
+static void _mmf_mmap_unmap (MMFMMapWindow *window)
+{
+    munmap (window->ptr, (size_t) window->len);
+    mmfile_free (window);
+}
+
+/* maps [offset, offset + len) if the current window does not hold it, len is within the file.
+ * called with the handle lock */
+static unsigned char *_mmf_mmap_window (MMFMMapIOHandle *mmapHandle, long long offset, int len)
+{
+    MMFMMapWindow *window = mmapHandle->window;
+    MMFMMapWindow *newWindow = NULL;
+    long long pageSize = sysconf (_SC_PAGESIZE);
+    long long base = 0;
+    long long mapLen = 0;
+    void *ptr = NULL;
+
+    if (window && offset >= window->base && offset + len <= window->base + window->len)
+    {
+        return window->ptr + (offset - window->base);
+    }
+
+    if (pageSize <= 0)
+    {
+        pageSize = 4096;
+    }
+
+    base = offset - (offset % pageSize);
+    mapLen = (offset - base) + len;
+    if (mapLen < MMFILE_MMAP_WINDOW_SIZE)
+    {
+        mapLen = MMFILE_MMAP_WINDOW_SIZE;
+    }
+    if (mapLen > mmapHandle->size - base)
+    {
+        mapLen = mmapHandle->size - base;
+    }
+
+    if (mapLen <= 0 || (unsigned long long) mapLen > (size_t) -1)
+    {
+        debug_error ("error: invalid window %lld:%lld\n", base, mapLen);
+        return NULL;
+    }
+
+    ptr = mmap (0, (size_t) mapLen, mmapHandle->prot, MAP_SHARED, mmapHandle->fd, (off_t) base);
+    if (ptr == MAP_FAILED)
+    {
+        debug_error ("error: mmap %lld:%lld\n", base, mapLen);
+        return NULL;
+    }
+
+    if (mmapHandle->advice != MADV_NORMAL)
+    {
+        madvise (ptr, (size_t) mapLen, mmapHandle->advice);
+    }
+
+    newWindow = mmfile_malloc (sizeof (MMFMMapWindow));
+    if (!newWindow)
+    {
+        debug_error ("error: mmfile_malloc window\n");
+        munmap (ptr, (size_t) mapLen);
+        return NULL;
+    }
+
+    newWindow->ptr = ptr;
+    newWindow->base = base;
+    newWindow->len = mapLen;
+
+    if (window)
+    {
+        if (window->refs > 0)
+        {
+            window->next = mmapHandle->pinned;
+            mmapHandle->pinned = window;
+        }
+        else
+        {
+            _mmf_mmap_unmap (window);
+        }
+    }
+
+    mmapHandle->window = newWindow;
+
+    return newWindow->ptr + (offset - base);
+}
+
 static int mmf_mmap_open (MMFileIOHandle *handle, const char *filename, int flags)
 {
     MMFMMapIOHandle *mmapHandle = NULL;
     struct stat finfo = {0, };
     int access = 0;
-    
+
     if (!handle || !filename || !handle->iofunc || !handle->iofunc->handleName)
     {
         debug_error ("invalid param\n");
-        return MMFILE_IO_FAILED;        
+        return MMFILE_IO_FAILED;
     }
 
     filename += strlen(handle->iofunc->handleName) + 3; /* :// */
@@ -62,22 +172,25 @@ static int mmf_mmap_open (MMFileIOHandle *handle, const char *filename, int flag
     if (!mmapHandle)
     {
         debug_error ("error: mmfile_malloc mmapHandle\n");
-        return MMFILE_IO_FAILED;        
+        return MMFILE_IO_FAILED;
     }
 
     if (flags & MMFILE_RDWR)
     {
         access = O_CREAT | O_TRUNC | O_RDWR;
-    } 
-    else if (flags & MMFILE_WRONLY) 
+        mmapHandle->prot = PROT_WRITE | PROT_READ;
+    }
+    else if (flags & MMFILE_WRONLY)
     {
         access = O_CREAT | O_TRUNC | O_WRONLY;
-    } 
-    else 
+        mmapHandle->prot = PROT_WRITE;
+    }
+    else
     {
         access = O_RDONLY;
+        mmapHandle->prot = PROT_READ;
     }
-    
+
 #ifdef O_BINARY
     access |= O_BINARY;
 #endif
@@ -89,7 +202,7 @@ static int mmf_mmap_open (MMFileIOHandle *handle, const char *filename, int flag
         goto exception;
     }
 
-    if (fstat (mmapHandle->fd, &finfo) == -1) 
+    if (fstat (mmapHandle->fd, &finfo) == -1)
     {
         debug_error ("error: fstat\n");
         goto exception;
@@ -104,30 +217,17 @@ static int mmf_mmap_open (MMFileIOHandle *handle, const char *filename, int flag
     mmapHandle->size = finfo.st_size;
     mmapHandle->offset = 0;
     mmapHandle->state = 0;
+    mmapHandle->advice = MADV_NORMAL;
 
-    if (flags & MMFILE_RDWR)
-    {
-        //mmapHandle->ptr = mmap64 (0, mmapHandle->size, PROT_WRITE | PROT_READ, MAP_SHARED, mmapHandle->fd, 0);
-        mmapHandle->ptr = mmap (0, mmapHandle->size, PROT_WRITE | PROT_READ, MAP_SHARED, mmapHandle->fd, 0);
-    } 
-    else if (flags & MMFILE_WRONLY) 
-    {
-        //mmapHandle->ptr = mmap64 (0, mmapHandle->size, PROT_WRITE, MAP_SHARED, mmapHandle->fd, 0);
-        mmapHandle->ptr = mmap (0, mmapHandle->size, PROT_WRITE, MAP_SHARED, mmapHandle->fd, 0);
-    } 
-    else 
-    {
-        //mmapHandle->ptr = mmap64 (0, mmapHandle->size, PROT_READ, MAP_SHARED, mmapHandle->fd, 0);
-        mmapHandle->ptr = mmap (0, mmapHandle->size, PROT_READ, MAP_SHARED, mmapHandle->fd, 0);
-    }
-    
-    if (mmapHandle->ptr == (void*)-1)
+    /* the first window, the probe reads the head next */
+    if (!_mmf_mmap_window (mmapHandle, 0, 0))
     {
         debug_error ("error: mmap\n");
-        mmapHandle->ptr = NULL;
         goto exception;
     }
 
+    pthread_mutex_init (&mmapHandle->lock, NULL);
+
     handle->privateData = (void*) mmapHandle;
 
     return MMFILE_IO_SUCCESS;
@@ -135,9 +235,9 @@ static int mmf_mmap_open (MMFileIOHandle *handle, const char *filename, int flag
 exception:
     if (mmapHandle)
     {
-        if (mmapHandle->ptr)
+        if (mmapHandle->window)
         {
-            munmap (mmapHandle->ptr, mmapHandle->size);
+            _mmf_mmap_unmap (mmapHandle->window);
         }
 
         if (mmapHandle->fd > 2)
@@ -148,7 +248,7 @@ exception:
         mmfile_free (mmapHandle);
         handle->privateData = NULL;
     }
-    
+
     return MMFILE_IO_FAILED;
 }
 
@@ -166,12 +266,10 @@ static int mmf_mmap_read (MMFileIOHandle *h, unsigned char *buf, int size)
 
     mmapHandle = h->privateData;
 
-    c = mmapHandle->ptr + mmapHandle->offset;
-
     if (mmapHandle->state != EOF)
     {
         len = size;
-        if (len + mmapHandle->offset > mmapHandle->size) 
+        if (len + mmapHandle->offset > mmapHandle->size)
         {
             len = mmapHandle->size - mmapHandle->offset;
         }
@@ -181,11 +279,27 @@ static int mmf_mmap_read (MMFileIOHandle *h, unsigned char *buf, int size)
         return 0;
     }
 
+    if (len <= 0)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock (&mmapHandle->lock);
+
+    c = _mmf_mmap_window (mmapHandle, mmapHandle->offset, len);
+    if (!c)
+    {
+        pthread_mutex_unlock (&mmapHandle->lock);
+        return MMFILE_IO_FAILED;
+    }
+
     memcpy (buf, c, len);
-    
+
+    pthread_mutex_unlock (&mmapHandle->lock);
+
     mmapHandle->offset += len;
 
-    if ( mmapHandle->offset == mmapHandle->size) 
+    if ( mmapHandle->offset == mmapHandle->size)
     {
         mmapHandle->state = EOF;
     }
@@ -193,6 +307,192 @@ static int mmf_mmap_read (MMFileIOHandle *h, unsigned char *buf, int size)
     return len;
 }
 
+static void mmf_mmap_release (MMFileIOHandle *h, const unsigned char *ptr);
+
+static int mmf_mmap_pread (MMFileIOHandle *h, unsigned char *buf, int size, long long offset)
+{
+    MMFMMapIOHandle *mmapHandle = NULL;
+    MMFMMapWindow *window = NULL;
+    const unsigned char *c = NULL;
+    int len = 0;
+
+    if (!h || !h->privateData || !buf || size < 0 || offset < 0)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    mmapHandle = h->privateData;
+
+    if (offset >= mmapHandle->size || size == 0)
+    {
+        return 0;
+    }
+
+    len = size;
+    if (len > mmapHandle->size - offset)
+    {
+        len = mmapHandle->size - offset;
+    }
+
+    /* pinned like a peek, so no other thread unmaps it during the copy */
+    pthread_mutex_lock (&mmapHandle->lock);
+    window = mmapHandle->window;
+    if (window && offset >= window->base && offset + len <= window->base + window->len)
+    {
+        c = window->ptr + (offset - window->base);
+        window->refs++;
+    }
+    pthread_mutex_unlock (&mmapHandle->lock);
+
+    if (c)
+    {
+        memcpy (buf, c, len);
+        mmf_mmap_release (h, c);
+        return len;
+    }
+
+    /* outside the window, the window stays for the sequential reader */
+    len = pread (mmapHandle->fd, buf, len, (off_t) offset);
+    if (len < 0)
+    {
+        debug_error ("error: pread %lld\n", offset);
+        return MMFILE_IO_FAILED;
+    }
+
+    return len;
+}
+
+static int mmf_mmap_peek (MMFileIOHandle *h, long long offset, int size, const unsigned char **ptr)
+{
+    MMFMMapIOHandle *mmapHandle = NULL;
+    int len = 0;
+
+    if (!h || !h->privateData || !ptr || size < 0 || offset < 0)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    mmapHandle = h->privateData;
+    *ptr = NULL;
+
+    if (offset >= mmapHandle->size || size == 0)
+    {
+        return 0;
+    }
+
+    len = size;
+    if (len > mmapHandle->size - offset)
+    {
+        len = mmapHandle->size - offset;
+    }
+
+    pthread_mutex_lock (&mmapHandle->lock);
+
+    *ptr = _mmf_mmap_window (mmapHandle, offset, len);
+    if (!*ptr)
+    {
+        pthread_mutex_unlock (&mmapHandle->lock);
+        return MMFILE_IO_FAILED;
+    }
+
+    mmapHandle->window->refs++;
+
+    pthread_mutex_unlock (&mmapHandle->lock);
+
+    return len;
+}
+
+static void mmf_mmap_release (MMFileIOHandle *h, const unsigned char *ptr)
+{
+    MMFMMapIOHandle *mmapHandle = NULL;
+    MMFMMapWindow **link = NULL;
+    MMFMMapWindow *window = NULL;
+
+    if (!h || !h->privateData || !ptr)
+    {
+        return;
+    }
+
+    mmapHandle = h->privateData;
+
+    pthread_mutex_lock (&mmapHandle->lock);
+
+    window = mmapHandle->window;
+    if (window && ptr >= window->ptr && ptr < window->ptr + window->len)
+    {
+        if (window->refs > 0)
+        {
+            window->refs--;
+        }
+        pthread_mutex_unlock (&mmapHandle->lock);
+        return;
+    }
+
+    for (link = &mmapHandle->pinned; *link; link = &(*link)->next)
+    {
+        window = *link;
+        if (ptr >= window->ptr && ptr < window->ptr + window->len)
+        {
+            if (--window->refs <= 0)
+            {
+                *link = window->next;
+                _mmf_mmap_unmap (window);
+            }
+            pthread_mutex_unlock (&mmapHandle->lock);
+            return;
+        }
+    }
+
+    pthread_mutex_unlock (&mmapHandle->lock);
+
+    debug_warning ("unknown peek pointer\n");
+}
+
+static int mmf_mmap_advise (MMFileIOHandle *h, int pattern)
+{
+    MMFMMapIOHandle *mmapHandle = NULL;
+    int advice = MADV_NORMAL;
+
+    if (!h || !h->privateData)
+    {
+        debug_error ("invalid para\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    mmapHandle = h->privateData;
+
+    switch (pattern)
+    {
+        case MMFILE_ACCESS_SEQUENTIAL:
+            advice = MADV_SEQUENTIAL;
+            break;
+        case MMFILE_ACCESS_RANDOM:
+            advice = MADV_RANDOM;
+            break;
+        default:
+            advice = MADV_NORMAL;
+            break;
+    }
+
+    pthread_mutex_lock (&mmapHandle->lock);
+
+    /* windows mapped later take the same advice */
+    mmapHandle->advice = advice;
+
+    if (mmapHandle->window && madvise (mmapHandle->window->ptr, (size_t) mmapHandle->window->len, advice) < 0)
+    {
+        pthread_mutex_unlock (&mmapHandle->lock);
+        debug_warning ("madvise failed\n");
+        return MMFILE_IO_FAILED;
+    }
+
+    pthread_mutex_unlock (&mmapHandle->lock);
+
+    return MMFILE_IO_SUCCESS;
+}
+
 static int mmf_mmap_write (MMFileIOHandle *h, unsigned char *buf, int size)
 {
     MMFMMapIOHandle *mmapHandle = NULL;
@@ -206,8 +506,6 @@ static int mmf_mmap_write (MMFileIOHandle *h, unsigned char *buf, int size)
     }
 
     mmapHandle = h->privateData;
-    
-    c = mmapHandle->ptr + mmapHandle->offset;
 
     if (mmapHandle->state != EOF)
     {
@@ -222,11 +520,27 @@ static int mmf_mmap_write (MMFileIOHandle *h, unsigned char *buf, int size)
         return 0;
     }
 
+    if (len <= 0)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock (&mmapHandle->lock);
+
+    c = _mmf_mmap_window (mmapHandle, mmapHandle->offset, len);
+    if (!c)
+    {
+        pthread_mutex_unlock (&mmapHandle->lock);
+        return MMFILE_IO_FAILED;
+    }
+
     memcpy (c, buf, len);
 
+    pthread_mutex_unlock (&mmapHandle->lock);
+
     mmapHandle->offset += len;
 
-    if ( mmapHandle->offset == mmapHandle->size) 
+    if ( mmapHandle->offset == mmapHandle->size)
     {
         mmapHandle->state = EOF;
     }
@@ -238,7 +552,7 @@ static int mmf_mmap_write (MMFileIOHandle *h, unsigned char *buf, int size)
 static long long mmf_mmap_seek (MMFileIOHandle *h, long long pos, int whence)
 {
     MMFMMapIOHandle *mmapHandle = NULL;
-    long tmp_offset = 0;
+    long long tmp_offset = 0;
 
     if (!h || !h->privateData)
     {
@@ -248,7 +562,7 @@ static long long mmf_mmap_seek (MMFileIOHandle *h, long long pos, int whence)
 
     mmapHandle = h->privateData;
 
-    switch (whence) 
+    switch (whence)
     {
         case SEEK_SET:
             tmp_offset = 0 + pos;
@@ -296,6 +610,7 @@ static long long mmf_mmap_tell (MMFileIOHandle *h)
 static int mmf_mmap_close (MMFileIOHandle *h)
 {
     MMFMMapIOHandle *mmapHandle = NULL;
+    MMFMMapWindow *window = NULL;
 
     if (!h || !h->privateData)
     {
@@ -307,19 +622,28 @@ static int mmf_mmap_close (MMFileIOHandle *h)
 
     if (mmapHandle)
     {
-        if (mmapHandle->ptr)
+        if (mmapHandle->window)
         {
-            munmap (mmapHandle->ptr, mmapHandle->size);
+            _mmf_mmap_unmap (mmapHandle->window);
+        }
+
+        while (mmapHandle->pinned)
+        {
+            window = mmapHandle->pinned;
+            mmapHandle->pinned = window->next;
+            debug_warning ("peek not released, %d left\n", window->refs);
+            _mmf_mmap_unmap (window);
         }
 
         if (mmapHandle->fd > 2)
         {
-    close (mmapHandle->fd);
+            close (mmapHandle->fd);
         }
 
-    mmfile_free (mmapHandle);
+        pthread_mutex_destroy (&mmapHandle->lock);
+        mmfile_free (mmapHandle);
     }
-    
+
     h->privateData = NULL;
 
     return MMFILE_IO_SUCCESS;
@@ -333,5 +657,9 @@ MMFileIOFunc mmfile_mmap_io_handler = {
 	mmf_mmap_write,
 	mmf_mmap_seek,
 	mmf_mmap_tell,
-	mmf_mmap_close
+	mmf_mmap_close,
+	mmf_mmap_pread,
+	mmf_mmap_peek,
+	mmf_mmap_release,
+	mmf_mmap_advise
 };
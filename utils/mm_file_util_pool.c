@@ -0,0 +1,238 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <mm_debug.h>
+#include "mm_file_utils.h"
+
+/**
+ * Work-stealing pool for a fixed set of tasks.
+ *
+ * Tasks are dealt round-robin to one queue per worker, keeping the caller's order,
+ * so each worker runs the most urgent tasks of its queue first (from the head).
+ * A worker with an empty queue steals from the tail of another queue, which takes
+ * the least urgent (usually the longest) task. No task is added while running,
+ * so a worker stops when every queue is empty.
+ */
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    void          **tasks;
+    int             head;
+    int             tail;   /* [head, tail) is pending */
+} MMFileTaskQueue;
+
+typedef struct
+{
+    MMFileTaskQueue *queues;
+    int              num_workers;
+    MMFileTaskFunc   func;
+    void            *user_data;
+} MMFileTaskPool;
+
+typedef struct
+{
+    MMFileTaskPool *pool;
+    int             index;
+    pthread_t       thread;
+} MMFileTaskWorker;
+
+
+static void *_mmfile_pool_pop (MMFileTaskQueue *queue)
+{
+    void *task = NULL;
+
+    pthread_mutex_lock (&queue->lock);
+    if (queue->head < queue->tail)
+    {
+        task = queue->tasks[queue->head++];
+    }
+    pthread_mutex_unlock (&queue->lock);
+
+    return task;
+}
+
+static void *_mmfile_pool_steal (MMFileTaskQueue *queue)
+{
+    void *task = NULL;
+
+    pthread_mutex_lock (&queue->lock);
+    if (queue->head < queue->tail)
+    {
+        task = queue->tasks[--queue->tail];
+    }
+    pthread_mutex_unlock (&queue->lock);
+
+    return task;
+}
+
+static void *_mmfile_pool_worker (void *data)
+{
+    MMFileTaskWorker *worker = (MMFileTaskWorker *)data;
+    MMFileTaskPool   *pool = worker->pool;
+    void             *task = NULL;
+    int               i = 0;
+
+    while (1)
+    {
+        task = _mmfile_pool_pop (&pool->queues[worker->index]);
+
+        for (i = 1; task == NULL && i < pool->num_workers; i++)
+        {
+            task = _mmfile_pool_steal (&pool->queues[(worker->index + i) % pool->num_workers]);
+        }
+
+        if (task == NULL)
+        {
+            break;
+        }
+
+        pool->func (task, pool->user_data);
+    }
+
+    return NULL;
+}
+
+EXPORT_API
+int mmfile_pool_get_cpu_count (void)
+{
+    long count = sysconf (_SC_NPROCESSORS_ONLN);
+
+    return (count > 0) ? (int)count : 1;
+}
+
+EXPORT_API
+int mmfile_pool_run (void **tasks, int num_tasks, int num_workers, MMFileTaskFunc func, void *user_data)
+{
+    MMFileTaskPool    pool;
+    MMFileTaskWorker *workers = NULL;
+    int               per_queue = 0;
+    int               i = 0;
+
+    if (!tasks || num_tasks < 0 || !func)
+    {
+        debug_error ("invalid param\n");
+        return MMFILE_UTIL_FAIL;
+    }
+
+    if (num_tasks == 0)
+    {
+        return MMFILE_UTIL_SUCCESS;
+    }
+
+    if (num_workers <= 0)
+    {
+        num_workers = mmfile_pool_get_cpu_count ();
+    }
+    if (num_workers > num_tasks)
+    {
+        num_workers = num_tasks;
+    }
+
+    per_queue = (num_tasks + num_workers - 1) / num_workers;
+
+    pool.num_workers = num_workers;
+    pool.func = func;
+    pool.user_data = user_data;
+    pool.queues = mmfile_malloc (sizeof (MMFileTaskQueue) * num_workers);
+    workers = mmfile_malloc (sizeof (MMFileTaskWorker) * num_workers);
+    if (!pool.queues || !workers)
+    {
+        debug_error ("mmfile_malloc fail\n");
+        goto exception;
+    }
+
+    for (i = 0; i < num_workers; i++)
+    {
+        pool.queues[i].tasks = mmfile_malloc (sizeof (void *) * per_queue);
+        if (!pool.queues[i].tasks)
+        {
+            debug_error ("mmfile_malloc fail\n");
+            goto exception;
+        }
+        pthread_mutex_init (&pool.queues[i].lock, NULL);
+    }
+
+    /* deal in order, so the head of every queue keeps the most urgent tasks */
+    for (i = 0; i < num_tasks; i++)
+    {
+        MMFileTaskQueue *queue = &pool.queues[i % num_workers];
+        queue->tasks[queue->tail++] = tasks[i];
+    }
+
+    /* the calling thread works as worker 0 */
+    for (i = 1; i < num_workers; i++)
+    {
+        workers[i].pool = &pool;
+        workers[i].index = i;
+        if (pthread_create (&workers[i].thread, NULL, _mmfile_pool_worker, &workers[i]) != 0)
+        {
+            /* its queue is drained by stealing */
+            debug_error ("pthread_create fail [%d]\n", i);
+            workers[i].pool = NULL;
+        }
+    }
+
+    workers[0].pool = &pool;
+    workers[0].index = 0;
+    _mmfile_pool_worker (&workers[0]);
+
+    for (i = 1; i < num_workers; i++)
+    {
+        if (workers[i].pool)
+        {
+            pthread_join (workers[i].thread, NULL);
+        }
+    }
+
+    for (i = 0; i < num_workers; i++)
+    {
+        pthread_mutex_destroy (&pool.queues[i].lock);
+        mmfile_free (pool.queues[i].tasks);
+    }
+    mmfile_free (pool.queues);
+    mmfile_free (workers);
+
+    return MMFILE_UTIL_SUCCESS;
+
+exception:
+    if (pool.queues)
+    {
+        for (i = 0; i < num_workers; i++)
+        {
+            if (pool.queues[i].tasks)
+            {
+                pthread_mutex_destroy (&pool.queues[i].lock);
+                mmfile_free (pool.queues[i].tasks);
+            }
+        }
+        mmfile_free (pool.queues);
+    }
+    if (workers)
+    {
+        mmfile_free (workers);
+    }
+
+    return MMFILE_UTIL_FAIL;
+}
@@ -21,10 +21,225 @@
  
 #include <stdlib.h> 
 #include <string.h>
+#include <errno.h>
+#include <iconv.h>
+#include <pthread.h>
 #include <glib.h>
 #include "mm_debug.h"
 #include "mm_file_utils.h"
 
+/**
+ * Charset conversion with cached iconv descriptors.
+ *
+ * Tags convert one text frame at a time between a handful of codesets, so
+ * opening a descriptor per call costs more than the conversion itself. Each
+ * thread keeps its last MMFILE_ICONV_CACHE_SIZE descriptors keyed by
+ * (from, to), they are reset before use and closed when the thread exits.
+ * The result follows g_convert(): zero terminated, NULL on an invalid
+ * sequence, and on a truncated input unless bytes_read is asked for.
+ */
+
+#define MMFILE_ICONV_CACHE_SIZE     4
+#define MMFILE_ICONV_CODESET_MAX    32
+#define MMFILE_ICONV_NUL_LEN        4   /* wide enough for UTF-32 */
+
+typedef struct
+{
+    iconv_t         cd;
+    unsigned int    last_used;
+    char            from[MMFILE_ICONV_CODESET_MAX];
+    char            to[MMFILE_ICONV_CODESET_MAX];
+} MMFileIconvEntry;
+
+typedef struct
+{
+    unsigned int        clock;
+    MMFileIconvEntry    entries[MMFILE_ICONV_CACHE_SIZE];
+} MMFileIconvCache;
+
+static pthread_key_t g_iconv_key;
+static pthread_once_t g_iconv_once = PTHREAD_ONCE_INIT;
+
+static void _mmfile_iconv_cache_free (void *data)
+{
+    MMFileIconvCache *cache = data;
+    int i = 0;
+
+    for (i = 0; i < MMFILE_ICONV_CACHE_SIZE; i++)
+    {
+        if (cache->entries[i].last_used)
+            iconv_close (cache->entries[i].cd);
+    }
+
+    free (cache);
+}
+
+static void _mmfile_iconv_key_init (void)
+{
+    pthread_key_create (&g_iconv_key, _mmfile_iconv_cache_free);
+}
+
+static iconv_t _mmfile_iconv_get (const char *to_codeset, const char *from_codeset)
+{
+    MMFileIconvCache *cache = NULL;
+    MMFileIconvEntry *victim = NULL;
+    iconv_t cd = (iconv_t) -1;
+    int i = 0;
+
+    /* long names are not cached */
+    if (strlen (to_codeset) >= MMFILE_ICONV_CODESET_MAX || strlen (from_codeset) >= MMFILE_ICONV_CODESET_MAX)
+        return (iconv_t) -1;
+
+    pthread_once (&g_iconv_once, _mmfile_iconv_key_init);
+
+    cache = pthread_getspecific (g_iconv_key);
+    if (!cache)
+    {
+        cache = calloc (1, sizeof (MMFileIconvCache));
+        if (!cache)
+            return (iconv_t) -1;
+
+        if (pthread_setspecific (g_iconv_key, cache) != 0)
+        {
+            free (cache);
+            return (iconv_t) -1;
+        }
+    }
+
+    for (i = 0; i < MMFILE_ICONV_CACHE_SIZE; i++)
+    {
+        MMFileIconvEntry *entry = cache->entries + i;
+
+        if (entry->last_used && !strcmp (entry->from, from_codeset) && !strcmp (entry->to, to_codeset))
+        {
+            entry->last_used = ++cache->clock;
+
+            /* back to the initial shift state, a BOM is looked for again */
+            iconv (entry->cd, NULL, NULL, NULL, NULL);
+            return entry->cd;
+        }
+
+        if (!victim || (victim->last_used && (!entry->last_used || entry->last_used < victim->last_used)))
+            victim = entry;
+    }
+
+    cd = iconv_open (to_codeset, from_codeset);
+    if (cd == (iconv_t) -1)
+        return cd;
+
+    if (victim->last_used)
+        iconv_close (victim->cd);
+
+    victim->cd = cd;
+    victim->last_used = ++cache->clock;
+    strcpy (victim->from, from_codeset);
+    strcpy (victim->to, to_codeset);
+
+    return cd;
+}
+
+static char *_mmfile_iconv_convert (const char *str, unsigned int len,
+                                    const char *to_codeset, const char *from_codeset,
+                                    unsigned int *bytes_read,
+                                    unsigned int *bytes_written)
+{
+    iconv_t cd = (iconv_t) -1;
+    char *inbuf = (char *) str;
+    size_t inleft = len;
+    char *dest = NULL;
+    char *outbuf = NULL;
+    size_t outsize = 0;
+    size_t outleft = 0;
+    size_t err = 0;
+    bool failed = false;
+    bool flushed = false;
+
+    if (!str || !to_codeset || !from_codeset)
+        return NULL;
+
+    cd = _mmfile_iconv_get (to_codeset, from_codeset);
+    if (cd == (iconv_t) -1)
+    {
+        gsize read = 0, written = 0;
+
+        /* unknown to iconv or not cacheable, glib may still know it */
+        dest = g_convert (str, len, to_codeset, from_codeset, bytes_read ? &read : NULL, &written, NULL);
+        if (bytes_read)
+            *bytes_read = read;
+        if (bytes_written)
+            *bytes_written = written;
+
+        return dest;
+    }
+
+    outsize = len + MMFILE_ICONV_NUL_LEN;
+    dest = mmfile_malloc (outsize);
+    if (!dest)
+        return NULL;
+
+    outbuf = dest;
+    outleft = outsize - MMFILE_ICONV_NUL_LEN;
+
+    while (1)
+    {
+        if (!flushed)
+            err = iconv (cd, &inbuf, &inleft, &outbuf, &outleft);
+        else
+            err = iconv (cd, NULL, NULL, &outbuf, &outleft);
+
+        if (err != (size_t) -1)
+        {
+            /* the input is done, the shift state is written out once */
+            if (flushed)
+                break;
+            flushed = true;
+            continue;
+        }
+
+        if (errno == E2BIG)
+        {
+            size_t used = outbuf - dest;
+            char *tmp = NULL;
+
+            outsize = outsize * 2;
+            tmp = mmfile_realloc (dest, outsize);
+            if (!tmp)
+            {
+                failed = true;
+                break;
+            }
+
+            dest = tmp;
+            outbuf = dest + used;
+            outleft = outsize - used - MMFILE_ICONV_NUL_LEN;
+            continue;
+        }
+
+        /* EINVAL is a truncated last character, told by bytes_read only */
+        if (errno != EINVAL)
+            failed = true;
+        break;
+    }
+
+    memset (outbuf, 0x00, MMFILE_ICONV_NUL_LEN);
+
+    if (bytes_read)
+        *bytes_read = inbuf - str;
+    else if (inleft)
+        failed = true;
+
+    if (bytes_written)
+        *bytes_written = outbuf - dest;
+
+    if (failed)
+    {
+        mmfile_free (dest);
+        return NULL;
+    }
+
+    return dest;
+}
+
 #ifdef __MMFILE_MEM_TRACE__
 EXPORT_API
 int  mmfile_util_wstrlen (unsigned short *wText)
@@ -79,11 +294,11 @@ char *mmfile_string_convert_debug (const char *str, unsigned int len,
                              const char *func,
                              unsigned int line)
 {
-    char *tmp = g_convert (str, len, to_codeset, from_codeset, bytes_read, bytes_written, NULL);
+    char *tmp = _mmfile_iconv_convert (str, len, to_codeset, from_codeset, (unsigned int *) bytes_read, (unsigned int *) bytes_written);
 
     if (tmp)
     {
-        fprintf (stderr, "## DEBUG ## %p = g_convert (%p, %u, %p, %p, %p ,%p, %p, %u) by %s() %d\n",
+        fprintf (stderr, "## DEBUG ## %p = mmfile_string_convert (%p, %u, %p, %p, %p ,%p, %p, %u) by %s() %d\n",
                           tmp, str, len, to_codeset, from_codeset, bytes_read, bytes_written, func, line);
     }
 
@@ -152,7 +367,7 @@ char *mmfile_string_convert (const char *str, unsigned int len,
 {
 	char *result = NULL;
 
-	result = g_convert (str, len, to_codeset, from_codeset, bytes_read, bytes_written, NULL);  
+	result = _mmfile_iconv_convert (str, len, to_codeset, from_codeset, bytes_read, bytes_written);
 
 	/*if converting failed, return duplicated source string.*/
 	if (result == NULL) {
@@ -0,0 +1,127 @@
+/*
+ * libmm-fileinfo
+ *
+ * Copyright (c) 2000 - 2011 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Contact: Haejeong Kim <backto.kim@samsung.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <string.h>
+#include <mm_debug.h>
+#include "mm_file_utils.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Frame sync search shared by the MP3 and AAC checks.
+ *
+ * A candidate is a 0xFF byte whose next byte matches (next & mask) == value.
+ * The vector paths compare a whole block of byte pairs at once and fall back
+ * to the byte loop only for the last partial block. The instruction set is
+ * chosen at build time from the compiler target flags.
+ */
+
+static int _mmfile_find_sync_scalar (const unsigned char *buffer, int start, int length, unsigned char mask, unsigned char value)
+{
+    const unsigned char *p = NULL;
+    int i = start;
+
+    while (i < length - 1)
+    {
+        p = memchr (buffer + i, 0xFF, length - 1 - i);
+        if (!p)
+            return -1;
+
+        i = p - buffer;
+        if ((buffer[i + 1] & mask) == value)
+            return i;
+
+        i++;
+    }
+
+    return -1;
+}
+
+EXPORT_API
+int mmfile_util_find_sync (const unsigned char *buffer, int length, unsigned char mask, unsigned char value)
+{
+    int i = 0;
+
+    if (!buffer || length < 2)
+        return -1;
+
+#if defined(__AVX2__)
+    {
+        const __m256i ff = _mm256_set1_epi8 ((char) 0xFF);
+        const __m256i m = _mm256_set1_epi8 ((char) mask);
+        const __m256i v = _mm256_set1_epi8 ((char) value);
+
+        for (; i + 33 <= length; i += 32)
+        {
+            __m256i first = _mm256_loadu_si256 ((const __m256i *) (buffer + i));
+            __m256i second = _mm256_loadu_si256 ((const __m256i *) (buffer + i + 1));
+            __m256i hit = _mm256_and_si256 (_mm256_cmpeq_epi8 (first, ff),
+                                             _mm256_cmpeq_epi8 (_mm256_and_si256 (second, m), v));
+            unsigned int bits = (unsigned int) _mm256_movemask_epi8 (hit);
+
+            if (bits)
+                return i + __builtin_ctz (bits);
+        }
+    }
+#elif defined(__SSE2__)
+    {
+        const __m128i ff = _mm_set1_epi8 ((char) 0xFF);
+        const __m128i m = _mm_set1_epi8 ((char) mask);
+        const __m128i v = _mm_set1_epi8 ((char) value);
+
+        for (; i + 17 <= length; i += 16)
+        {
+            __m128i first = _mm_loadu_si128 ((const __m128i *) (buffer + i));
+            __m128i second = _mm_loadu_si128 ((const __m128i *) (buffer + i + 1));
+            __m128i hit = _mm_and_si128 (_mm_cmpeq_epi8 (first, ff),
+                                          _mm_cmpeq_epi8 (_mm_and_si128 (second, m), v));
+            unsigned int bits = (unsigned int) _mm_movemask_epi8 (hit);
+
+            if (bits)
+                return i + __builtin_ctz (bits);
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    {
+        const uint8x16_t ff = vdupq_n_u8 (0xFF);
+        const uint8x16_t m = vdupq_n_u8 (mask);
+        const uint8x16_t v = vdupq_n_u8 (value);
+
+        for (; i + 17 <= length; i += 16)
+        {
+            uint8x16_t first = vld1q_u8 (buffer + i);
+            uint8x16_t second = vld1q_u8 (buffer + i + 1);
+            uint8x16_t hit = vandq_u8 (vceqq_u8 (first, ff), vceqq_u8 (vandq_u8 (second, m), v));
+            uint64x2_t lanes = vreinterpretq_u64_u8 (hit);
+
+            /* no movemask on NEON, the block is located first and then scanned */
+            if (vgetq_lane_u64 (lanes, 0) | vgetq_lane_u64 (lanes, 1))
+                return _mmfile_find_sync_scalar (buffer, i, i + 17, mask, value);
+        }
+    }
+#endif
+
+    return _mmfile_find_sync_scalar (buffer, i, length, mask, value);
+}
@@ -1145,6 +1145,9 @@ static int GetTagFromMetaBox (MMFileFormatContext *formatContext, MMFileIOHandle
 			goto exception;
 		}
 
+		/* lyrics are not taken from the ID3 box */
+		mm_file_id3tag_decode (&tagInfo, id3v2Box.id3v2Data, AV_ID3V2_FRAME_TEXT | AV_ID3V2_FRAME_IMAGE);
+
 		if (!formatContext->title)          formatContext->title = mmfile_strdup((const char*)tagInfo.pTitle);
 		if (!formatContext->artist)         formatContext->artist = mmfile_strdup((const char*)tagInfo.pArtist);
 		if (!formatContext->author)         formatContext->author = mmfile_strdup((const char*)tagInfo.pAuthor);
@@ -1410,6 +1413,91 @@ bool mm_file_id3tag_parse_v110(AvFileContentInfo* pInfo,  unsigned char *buffer)
 	return true;
 }
 
+/**
+ * ID3v2 frame index.
+ *
+ * The parse functions only walk the frame headers and keep the frames the
+ * decoders know in pInfo->tagV2Info.pFrames. Text conversion and copying of
+ * pictures and lyrics is done by mm_file_id3tag_decode(), for the frame
+ * types asked for and only once.
+ */
+static const char *g_id3v2_image_frames[] = { "PIC", "APIC" };
+static const char *g_id3v2_lyrics_frames[] = { "USLT", "SYLT" };
+static const char *g_id3v2_text_frames[] = {
+	/* v2.2 */
+	"TT2", "TP1", "TP3", "TAL", "TYE", "COM", "TCO", "TRK", "TEN", "WXX", "TCR", "TOA", "TCM", "TRD",
+	/* v2.3, v2.4 */
+	"TIT1", "TIT2", "TPE1", "TPE3", "TALB", "TYER", "COMM", "TCON", "TRCK", "TENC", "WXXX", "TCOP",
+	"TOPE", "TCOM", "TRDA", "TDRC",
+};
+
+static int _mm_file_id3tag_frame_type (const char *id)
+{
+	int i = 0;
+
+	for (i = 0; i < sizeof (g_id3v2_text_frames) / sizeof (g_id3v2_text_frames[0]); i++)
+		if (!strcmp (id, g_id3v2_text_frames[i]))
+			return AV_ID3V2_FRAME_TEXT;
+
+	for (i = 0; i < sizeof (g_id3v2_image_frames) / sizeof (g_id3v2_image_frames[0]); i++)
+		if (!strcmp (id, g_id3v2_image_frames[i]))
+			return AV_ID3V2_FRAME_IMAGE;
+
+	for (i = 0; i < sizeof (g_id3v2_lyrics_frames) / sizeof (g_id3v2_lyrics_frames[0]); i++)
+		if (!strcmp (id, g_id3v2_lyrics_frames[i]))
+			return AV_ID3V2_FRAME_LYRICS;
+
+	return 0;
+}
+
+static void _mm_file_id3tag_reset_index (AvFileContentInfo* pInfo, int version)
+{
+	if (pInfo->tagV2Info.pFrames)
+		mmfile_free (pInfo->tagV2Info.pFrames);
+
+	pInfo->tagV2Info.frameNum = 0;
+	pInfo->tagV2Info.frameAlloc = 0;
+	pInfo->tagV2Info.indexedLen = 0;
+	pInfo->tagV2Info.indexVersion = version;
+	pInfo->tagV2Info.decodedFrames = 0;
+}
+
+static void _mm_file_id3tag_index_frame (AvFileContentInfo* pInfo, const unsigned char *buffer, const char *id, unsigned long offset, unsigned long size)
+{
+	AvTagVer2AdditionalData *tag = &pInfo->tagV2Info;
+	AvTagVer2Frame *frames = NULL;
+	AvTagVer2Frame *frame = NULL;
+	int type = _mm_file_id3tag_frame_type (id);
+
+	if (!type)
+		return;
+
+	if (tag->frameNum == tag->frameAlloc) {
+		frames = mmfile_realloc (tag->pFrames, (tag->frameAlloc + MP3_ID3_FRAME_INDEX_STEP) * sizeof (AvTagVer2Frame));
+		if (!frames) {
+			debug_error ("failed to grow frame index\n");
+			return;
+		}
+		tag->pFrames = frames;
+		tag->frameAlloc += MP3_ID3_FRAME_INDEX_STEP;
+	}
+
+	frame = &tag->pFrames[tag->frameNum++];
+	memset (frame, 0x00, sizeof (AvTagVer2Frame));
+	strncpy (frame->id, id, 4);
+	frame->type = type;
+	frame->encoding = buffer[offset];
+	frame->offset = offset;
+	frame->size = size;
+
+	if (offset + size > tag->indexedLen)
+		tag->indexedLen = offset + size;
+
+	#ifdef __MMFILE_TEST_MODE__
+	debug_msg ("frame %s type(%d) encoding(%d) offset(%lu) size(%lu)\n", id, type, frame->encoding, offset, size);
+	#endif
+}
+
 EXPORT_API
 bool mm_file_id3tag_parse_v222(AvFileContentInfo* pInfo, unsigned char *buffer)
 {
@@ -1419,15 +1507,9 @@ bool mm_file_id3tag_parse_v222(AvFileContentInfo* pInfo, unsigned char *buffer)
 	unsigned long v2numOfFrames = 0;
 	unsigned long curPos = 0;
 	char CompTmp[4];
-	char *pExtContent = NULL;
 	unsigned long purelyFramelen = 0;
-	char *tmpConvert2Pcode = NULL;
-	int inx=0, encodingOffSet=0, realCpyFrameNum=0,
-		checkImgMimeTypeMax=0, checkImgDescriptionMax=0, checkImgExtMax=0,
-		imgstartOffset=0, tmp = 0;
 
-	int textEncodingType = 0;
-	const char *locale = NULL;
+	_mm_file_id3tag_reset_index (pInfo, 2);
 
 	pInfo->tagV2Info.bTitleMarked = false;
 	pInfo->tagV2Info.bAlbumMarked= false;
@@ -1449,8 +1531,6 @@ bool mm_file_id3tag_parse_v222(AvFileContentInfo* pInfo, unsigned char *buffer)
 	pInfo->imageInfo.pImageBuf = NULL;
 	pInfo->imageInfo.imageLen = 0;
 
-	locale = MMFileUtilGetLocale (NULL);
-
 	taglen = pInfo->tagV2Info.tagLen;
 	needToloopv2taglen = taglen - MP3_TAGv2_HEADER_LEN;
 	curPos = MP3_TAGv2_HEADER_LEN;
@@ -1479,437 +1559,148 @@ bool mm_file_id3tag_parse_v222(AvFileContentInfo* pInfo, unsigned char *buffer)
 
 			if(oneFrameLen > MP3_TAGv2_22_TXT_HEADER_LEN && purelyFramelen <= taglen-curPos)
 			{
+				_mm_file_id3tag_index_frame (pInfo, buffer, CompTmp, curPos, purelyFramelen);
 				curPos += purelyFramelen;
+			}
+			else
+			{
+				curPos += purelyFramelen;
+				if(purelyFramelen != 0)
+					needToloopv2taglen = MP3_TAGv2_22_TXT_HEADER_LEN;
+			}
 
-				if(buffer[curPos-purelyFramelen] == 0x00)
-				{
-					encodingOffSet = 1;
-					textEncodingType = AV_ID3V2_ISO_8859;
-				}
-				else if(buffer[curPos-purelyFramelen] == 0x01)
-				{
-					encodingOffSet = 1;
-					textEncodingType = AV_ID3V2_UTF16;
-				}
-
-				//in order to deliver valid string to MP
-				while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen))
-					encodingOffSet++;
+			memset(CompTmp, 0, 4);
+			if(curPos < taglen)
+			{
+				needToloopv2taglen -= oneFrameLen;
+				v2numOfFrames++;
+			}
+			else
+				needToloopv2taglen = MP3_TAGv2_22_TXT_HEADER_LEN;
+			oneFrameLen = 0;
+			purelyFramelen = 0;
 
-				if(encodingOffSet < purelyFramelen)
-				{
-					realCpyFrameNum = purelyFramelen - encodingOffSet;
-					pExtContent = mmfile_malloc (realCpyFrameNum+3);
-					memset(pExtContent, '\0', realCpyFrameNum+3);
-					if(textEncodingType == AV_ID3V2_ISO_8859)
-					{
-						if(strncmp((char *)CompTmp, "PIC", 3) != 0)
-						{
-							tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
-							memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
-						}
-					}
+		}
+	}
 
-					memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
 
-					if(realCpyFrameNum > 0)
-					{
-						if(strncmp((char *)CompTmp, "TT2", 3) == 0 && pInfo->tagV2Info.bTitleMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
-							}
-							else
-							{
-								pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
-							}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
-							#endif
-							pInfo->tagV2Info.bTitleMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TP1", 3) == 0 && pInfo->tagV2Info.bArtistMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
-							}
-							else
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
-							#endif
-							pInfo->tagV2Info.bArtistMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TP3", 3) == 0 && pInfo->tagV2Info.bConductorMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
-							}
-							else
-							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
-							#endif
-							pInfo->tagV2Info.bConductorMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TAL", 3) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
-							}
-							else
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
-							#endif
-							pInfo->tagV2Info.bAlbumMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TYE", 3) == 0 && pInfo->tagV2Info.bYearMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
-							}
-							else
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
-							#endif
-							pInfo->tagV2Info.bYearMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "COM", 3) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
-						{
-							//skip language data!
-							if(realCpyFrameNum > 4)
-							{
-								realCpyFrameNum -= 4;
-								tmp = 4;
+	if(taglen) {
+		return true;
+	} else {
+		return false;
+	}
+}
 
-								//pExtContent[tmp+1] value should't have encoding value
-								if(pExtContent[tmp] > 0x20 && (pExtContent[tmp - 1] == 0x00 || pExtContent[tmp - 1] == 0x01))
-								{
-									if(pExtContent[tmp - 1] == 0x00)
-										textEncodingType = AV_ID3V2_ISO_8859;
-									else
-										textEncodingType = AV_ID3V2_UTF16;
+EXPORT_API
+bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
+{
+	unsigned long taglen = 0;
+	unsigned long needToloopv2taglen;
+	unsigned long oneFrameLen = 0;
+	unsigned long v2numOfFrames = 0;
+	unsigned long curPos = 0;
+	char CompTmp[5];
+	unsigned long purelyFramelen = 0;
 
-									if(textEncodingType == AV_ID3V2_UTF16)
-									{
-										pInfo->pDescription = mmfile_string_convert ((char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
-									}
-									else
-									{
-										pInfo->pDescription = mmfile_string_convert ((char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
-									}
+	_mm_file_id3tag_reset_index (pInfo, 3);
 
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
-									#endif
-									pInfo->tagV2Info.bDescriptionMarked = true;
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg (  "mmf_file_id3tag_parse_v222: failed to get Comment Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet );
-									#endif
-								}
-							}
-							else
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg (  "mmf_file_id3tag_parse_v222: Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum );
-								#endif
-							}
-							tmp = 0;
+	pInfo->tagV2Info.bTitleMarked = false;
+	pInfo->tagV2Info.bAlbumMarked= false;
+	pInfo->tagV2Info.bArtistMarked= false;
+	pInfo->tagV2Info.bDescriptionMarked= false;
+	pInfo->tagV2Info.bGenreMarked= false;
+	pInfo->tagV2Info.bYearMarked= false;
+	pInfo->tagV2Info.bTrackNumMarked= false;
+	pInfo->tagV2Info.bEncByMarked= false;
+	pInfo->tagV2Info.bURLMarked= false;
+	pInfo->tagV2Info.bCopyRightMarked= false;
+	pInfo->tagV2Info.bOriginArtistMarked= false;
+	pInfo->tagV2Info.bComposerMarked= false;
+	pInfo->tagV2Info.bImageMarked= false;
+	pInfo->imageInfo.bURLInfo = false;
+	pInfo->tagV2Info.bConductorMarked = false;
+	pInfo->tagV2Info.bUnsyncLyricsMarked = false;
+	pInfo->tagV2Info.bSyncLyricsMarked = false;
 
-						}
-						else if(strncmp((char *)CompTmp, "TCO", 3) == 0 && pInfo->tagV2Info.bGenreMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
-							}
-							else
-							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
-							}
+	pInfo->tagV2Info.bGenreUTF16 = false;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
-							#endif
-							pInfo->tagV2Info.bGenreMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TRK", 3) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
-							else
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
+	pInfo->imageInfo.pImageBuf = NULL;
+	pInfo->imageInfo.imageLen = 0;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
-							#endif
-							pInfo->tagV2Info.bTrackNumMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TEN", 3) == 0 && pInfo->tagV2Info.bEncByMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
-							}
-							else
-							{
-								pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
-							}
+	taglen = pInfo->tagV2Info.tagLen;
+	needToloopv2taglen = taglen - MP3_TAGv2_HEADER_LEN;
+	curPos = MP3_TAGv2_HEADER_LEN;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
-							#endif
-							pInfo->tagV2Info.bEncByMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "WXX", 3) == 0 && pInfo->tagV2Info.bURLMarked == false)
-						{
-							if(realCpyFrameNum > 4)
-							{
-								//skip language data!
-								realCpyFrameNum -= 4;
-								tmp = 4;
+#ifdef __MMFILE_TEST_MODE__
+	debug_msg ("ID3tag v223--------------------------------------------------------------\n");
+#endif
 
-								//pExtContent[tmp+1] value should't have null value
-								if(pExtContent[tmp] > 0x20 && (pExtContent[tmp - 1] == 0x00 || pExtContent[tmp - 1] == 0x01))
-								{
-									if(pExtContent[tmp - 1] == 0x00)
-										textEncodingType = AV_ID3V2_ISO_8859;
-									else
-										textEncodingType = AV_ID3V2_UTF16;
+	if(needToloopv2taglen -MP3_TAGv2_23_TXT_HEADER_LEN > MP3_TAGv2_23_TXT_HEADER_LEN)
+	{
+		v2numOfFrames = 1;
+		while(needToloopv2taglen > MP3_TAGv2_23_TXT_HEADER_LEN)
+		{
+			if((buffer[curPos] < '0' || buffer[curPos] > 'Z') || (buffer[curPos+1] < '0' || buffer[curPos+1] > 'Z')
+				|| (buffer[curPos+2] < '0' || buffer[curPos+2] > 'Z')|| (buffer[curPos+3] < '0' || buffer[curPos+3] > 'Z'))
+				break;
 
-									if(textEncodingType == AV_ID3V2_UTF16)
-									{
-										pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
-									}
-									else
-									{
-										pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
-									}
+			memcpy(CompTmp, &buffer[curPos], 4);
 
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
-									#endif
-									pInfo->tagV2Info.bURLMarked = true;
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg (  "mmf_file_id3tag_parse_v222: failed to get URL Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet );
-									#endif
-								}
-							}
-							else
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg (  "mmf_file_id3tag_parse_v222: URL info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum );
-								#endif
-							}
-							tmp = 0;
-						}
-						else if(strncmp((char *)CompTmp, "TCR", 3) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
-							}
-							else
-							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
-							}
+			CompTmp[4] = 0;
+			oneFrameLen = MP3_TAGv2_23_TXT_HEADER_LEN;
+			oneFrameLen += (unsigned long)buffer[4+curPos] << 24 | (unsigned long)buffer[5+curPos] << 16
+				| (unsigned long)buffer[6+curPos] << 8 | (unsigned long)buffer[7+curPos];
+			
+			#ifdef __MMFILE_TEST_MODE__
+			debug_msg ("----------------------------------------------------------------------------------------------------\n");
+			#endif
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
-							#endif
-							pInfo->tagV2Info.bCopyRightMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TOA", 3) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
-							}
-							else
-							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
-							#endif
-							pInfo->tagV2Info.bOriginArtistMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TCM", 3) == 0 && pInfo->tagV2Info.bComposerMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
-							}
-							else
-							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pComposer returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
-							#endif
-							pInfo->tagV2Info.bComposerMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TRD", 3) == 0 && pInfo->tagV2Info.bRecDateMarked== false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
-							}
-							else
-							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
-							#endif
-							pInfo->tagV2Info.bRecDateMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "PIC", 3) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ("mmf_file_id3tag_parse_v222: this is abnormal case!!\n");
-								#endif
-							}
-							else
-							{
-								if(pExtContent[0] != 0)
-								{
-									for(inx = 0; inx < MP3_ID3_IMAGE_EXT_MAX_LENGTH; inx++)
-										pInfo->imageInfo.imageExt[inx] = '\0';//ini mimetype variable
-
-									while((checkImgExtMax < MP3_ID3_IMAGE_EXT_MAX_LENGTH-1) && pExtContent[checkImgExtMax] != '\0')
-									{
-										pInfo->imageInfo.imageExt[checkImgExtMax] = pExtContent[checkImgExtMax];
-										checkImgExtMax++;
-									}
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									 debug_msg ( "mmf_file_id3tag_parse_v222: PIC image's not included to image Extention\n");
-									#endif
-								}
-
-								imgstartOffset += checkImgExtMax;
-
-								if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
-								{
-									pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
-								}
-								imgstartOffset++;//PictureType(1byte)
-
-								if(pExtContent[imgstartOffset] != 0x0)
-								{
-									for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
-										pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
-
-									while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
-									{
-										pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
-										checkImgDescriptionMax++;
-									}
-									pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
-								}
-								else
-								{
-									pInfo->imageInfo.imgDesLen= 0;
-								}
-
-								imgstartOffset += checkImgDescriptionMax;
-
-								if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
-								{
-									imgstartOffset ++; // endofDesceriptionType(1byte)
-
-									pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
-									pInfo->imageInfo.pImageBuf= mmfile_malloc (pInfo->imageInfo.imageLen + 1);
-									memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
-									pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
-
-									if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
-										pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
-								}
-
-							}
-
-							checkImgMimeTypeMax = 0;
-							checkImgDescriptionMax = 0;
-							checkImgExtMax = 0;
-							inx = 0;
-							imgstartOffset = 0;
-							pInfo->tagV2Info.bImageMarked= true;
+			if(oneFrameLen > taglen-curPos)
+				break;
 
-						}
-					}
+			purelyFramelen = oneFrameLen - MP3_TAGv2_23_TXT_HEADER_LEN;
+			curPos +=MP3_TAGv2_23_TXT_HEADER_LEN;
 
-				}
+			if(oneFrameLen > MP3_TAGv2_23_TXT_HEADER_LEN && purelyFramelen <= taglen-curPos)
+			{
+				_mm_file_id3tag_index_frame (pInfo, buffer, CompTmp, curPos, purelyFramelen);
+				curPos += purelyFramelen;
 			}
 			else
 			{
 				curPos += purelyFramelen;
 				if(purelyFramelen != 0)
-					needToloopv2taglen = MP3_TAGv2_22_TXT_HEADER_LEN;
+					needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "This Frame's size is Zero! purelyFramelen(%d)\n", purelyFramelen);
+				#endif
 			}
 
-			if(pExtContent)	_FREE_EX(pExtContent);
-			if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
 			memset(CompTmp, 0, 4);
+
 			if(curPos < taglen)
 			{
 				needToloopv2taglen -= oneFrameLen;
 				v2numOfFrames++;
 			}
 			else
-				needToloopv2taglen = MP3_TAGv2_22_TXT_HEADER_LEN;
+				needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
 			oneFrameLen = 0;
-			encodingOffSet = 0;
-			realCpyFrameNum = 0;
-			textEncodingType = 0;
 			purelyFramelen = 0;
 
 		}
 	}
 
-
-
-	if(taglen) {
+	if(taglen)
 		return true;
-	} else {
+	else
 		return false;
-	}
+
 }
 
 EXPORT_API
-bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
+bool mm_file_id3tag_parse_v224(AvFileContentInfo* pInfo, unsigned char *buffer)
 {
 	unsigned long taglen = 0;
 	unsigned long needToloopv2taglen;
@@ -1917,14 +1708,9 @@ bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
 	unsigned long v2numOfFrames = 0;
 	unsigned long curPos = 0;
 	char CompTmp[5];
-	unsigned char *pExtContent = NULL;
 	unsigned long purelyFramelen = 0;
-	char *tmpConvert2Pcode = NULL;
-	int inx=0, encodingOffSet=0, realCpyFrameNum=0, checkImgMimeTypeMax=0, checkImgDescriptionMax=0, imgstartOffset=0,  tmp = 0;
-	int textEncodingType = 0;
-	const char *locale = NULL;
 
-	locale = MMFileUtilGetLocale (NULL);
+	_mm_file_id3tag_reset_index (pInfo, 4);
 
 	pInfo->tagV2Info.bTitleMarked = false;
 	pInfo->tagV2Info.bAlbumMarked= false;
@@ -1941,11 +1727,10 @@ bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
 	pInfo->tagV2Info.bImageMarked= false;
 	pInfo->imageInfo.bURLInfo = false;
 	pInfo->tagV2Info.bConductorMarked = false;
+	pInfo->tagV2Info.bGenreUTF16 = false;
 	pInfo->tagV2Info.bUnsyncLyricsMarked = false;
 	pInfo->tagV2Info.bSyncLyricsMarked = false;
 
-	pInfo->tagV2Info.bGenreUTF16 = false;
-
 	pInfo->imageInfo.pImageBuf = NULL;
 	pInfo->imageInfo.imageLen = 0;
 
@@ -1954,9 +1739,22 @@ bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
 	curPos = MP3_TAGv2_HEADER_LEN;
 
 #ifdef __MMFILE_TEST_MODE__
-	debug_msg ("ID3tag v223--------------------------------------------------------------\n");
+	debug_msg ("ID3tag v224--------------------------------------------------------------\n");
 #endif
 
+	/* check Extended Header */
+	if (buffer[5] & 0x40)
+	{
+		/* if extended header exists, skip it*/
+		int extendedHeaderLen = (unsigned long)buffer[10] << 21 | (unsigned long)buffer[11] << 14 | (unsigned long)buffer[12] << 7  | (unsigned long)buffer[13];
+
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ("[%s][%d]--------------- extendedHeaderLen = %d\n",__func__,__LINE__, extendedHeaderLen);
+		#endif 
+
+		curPos += extendedHeaderLen;
+	}
+
 	if(needToloopv2taglen -MP3_TAGv2_23_TXT_HEADER_LEN > MP3_TAGv2_23_TXT_HEADER_LEN)
 	{
 		v2numOfFrames = 1;
@@ -1970,1848 +1768,2196 @@ bool mm_file_id3tag_parse_v223(AvFileContentInfo* pInfo, unsigned char *buffer)
 
 			CompTmp[4] = 0;
 			oneFrameLen = MP3_TAGv2_23_TXT_HEADER_LEN;
-			oneFrameLen += (unsigned long)buffer[4+curPos] << 24 | (unsigned long)buffer[5+curPos] << 16
-				| (unsigned long)buffer[6+curPos] << 8 | (unsigned long)buffer[7+curPos];
-			
-			#ifdef __MMFILE_TEST_MODE__
-			debug_msg ("----------------------------------------------------------------------------------------------------\n");
-			#endif
-
+			oneFrameLen += (unsigned long)buffer[4+curPos] << 21 | (unsigned long)buffer[5+curPos] << 14
+				| (unsigned long)buffer[6+curPos] << 7 | (unsigned long)buffer[7+curPos];
 			if(oneFrameLen > taglen-curPos)
 				break;
 
 			purelyFramelen = oneFrameLen - MP3_TAGv2_23_TXT_HEADER_LEN;
 			curPos +=MP3_TAGv2_23_TXT_HEADER_LEN;
 
+#ifdef __MMFILE_TEST_MODE__
+			debug_msg ("-----------------------------------------------------------------------------------\n");
+#endif
+
 			if(oneFrameLen > MP3_TAGv2_23_TXT_HEADER_LEN && purelyFramelen <= taglen-curPos)
+			{
+				_mm_file_id3tag_index_frame (pInfo, buffer, CompTmp, curPos, purelyFramelen);
+				curPos += purelyFramelen;
+			}
+			else
 			{
 				curPos += purelyFramelen;
+				if(purelyFramelen != 0)
+					needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+			}
+
+			memset(CompTmp, 0, 4);
+			if(curPos < taglen)
+			{
+				needToloopv2taglen -= oneFrameLen;
+				v2numOfFrames++;
+			}
+			else
+				needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+
+			oneFrameLen = 0;
+			purelyFramelen = 0;
+
+		}
+	}
+
+	if(taglen)
+		return true;
+	else
+		return false;
+
+}
+
+/* decodes one indexed v2.2 frame, the body of the former frame loop */
+static void _mm_file_id3tag_decode_v222 (AvFileContentInfo* pInfo, const unsigned char *buffer, const AvTagVer2Frame *frame, const char *locale)
+{
+	unsigned long curPos = frame->offset;
+	unsigned long purelyFramelen = frame->size;
+	const char *CompTmp = frame->id;
+	char *pExtContent = NULL;
+	char *tmpConvert2Pcode = NULL;
+	int inx=0, encodingOffSet=0, realCpyFrameNum=0,
+		checkImgMimeTypeMax=0, checkImgDescriptionMax=0, checkImgExtMax=0,
+		imgstartOffset=0, tmp = 0;
+	int textEncodingType = 0;
+
+	curPos += purelyFramelen;
+
+	if(buffer[curPos-purelyFramelen] == 0x00)
+	{
+		encodingOffSet = 1;
+		textEncodingType = AV_ID3V2_ISO_8859;
+	}
+	else if(buffer[curPos-purelyFramelen] == 0x01)
+	{
+		encodingOffSet = 1;
+		textEncodingType = AV_ID3V2_UTF16;
+	}
+
+	//in order to deliver valid string to MP
+	while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen))
+		encodingOffSet++;
+
+	if(encodingOffSet < purelyFramelen)
+	{
+		realCpyFrameNum = purelyFramelen - encodingOffSet;
+		pExtContent = mmfile_malloc (realCpyFrameNum+3);
+		memset(pExtContent, '\0', realCpyFrameNum+3);
+		if(textEncodingType == AV_ID3V2_ISO_8859)
+		{
+			if(strncmp((char *)CompTmp, "PIC", 3) != 0)
+			{
+				tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
+				memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
+			}
+		}
+
+		memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
 
-				if( IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen)) )
+		if(realCpyFrameNum > 0)
+		{
+			if(strncmp((char *)CompTmp, "TT2", 3) == 0 && pInfo->tagV2Info.bTitleMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
 				{
-					encodingOffSet = 2;
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
-					#endif
-					textEncodingType = AV_ID3V2_UTF16;
+					pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
 				}
-				else if ( IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen)) )
+				else
 				{
-					encodingOffSet = 2;
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
-					#endif
-					textEncodingType = AV_ID3V2_UTF16_BE;
+					pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
 				}
-				else if( IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen+1)) )
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
+				#endif
+				pInfo->tagV2Info.bTitleMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TP1", 3) == 0 && pInfo->tagV2Info.bArtistMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
 				{
-					encodingOffSet = 3;
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
-					#endif
-					textEncodingType = AV_ID3V2_UTF16;
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
 				}
-				else if ( IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen+1)) )
+				else
 				{
-					encodingOffSet = 3;
-					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
-					#endif
-					textEncodingType = AV_ID3V2_UTF16_BE;
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
+				#endif
+				pInfo->tagV2Info.bArtistMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TP3", 3) == 0 && pInfo->tagV2Info.bConductorMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
+				}
+				else
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
+				#endif
+				pInfo->tagV2Info.bConductorMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TAL", 3) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
+				}
+				else
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
+				#endif
+				pInfo->tagV2Info.bAlbumMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TYE", 3) == 0 && pInfo->tagV2Info.bYearMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
 				}
 				else
 				{
-					if (buffer[curPos-purelyFramelen+encodingOffSet] == 0x00)
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
+				#endif
+				pInfo->tagV2Info.bYearMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "COM", 3) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
+			{
+				//skip language data!
+				if(realCpyFrameNum > 4)
+				{
+					realCpyFrameNum -= 4;
+					tmp = 4;
+
+					//pExtContent[tmp+1] value should't have encoding value
+					if(pExtContent[tmp] > 0x20 && (pExtContent[tmp - 1] == 0x00 || pExtContent[tmp - 1] == 0x01))
 					{
+						if(pExtContent[tmp - 1] == 0x00)
+							textEncodingType = AV_ID3V2_ISO_8859;
+						else
+							textEncodingType = AV_ID3V2_UTF16;
+
+						if(textEncodingType == AV_ID3V2_UTF16)
+						{
+							pInfo->pDescription = mmfile_string_convert ((char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
+						}
+						else
+						{
+							pInfo->pDescription = mmfile_string_convert ((char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
+						}
+
 						#ifdef __MMFILE_TEST_MODE__
-						debug_msg ("encodingOffset will be set to 1\n");
+						debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
 						#endif
-
-						encodingOffSet=1;
+						pInfo->tagV2Info.bDescriptionMarked = true;
 					}
 					else
 					{
 						#ifdef __MMFILE_TEST_MODE__
-						debug_msg ("Finding encodingOffset\n");
+						debug_msg (  "mmf_file_id3tag_parse_v222: failed to get Comment Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet );
 						#endif
-
-						while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen)) // text string encoded by ISO-8859-1
-							encodingOffSet++;
 					}
-					textEncodingType = AV_ID3V2_ISO_8859;
+				}
+				else
+				{
 					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "this text string(%s) encoded by ISO-8859-1 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+					debug_msg (  "mmf_file_id3tag_parse_v222: Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum );
 					#endif
 				}
+				tmp = 0;
 
-				if(encodingOffSet < purelyFramelen)
+			}
+			else if(strncmp((char *)CompTmp, "TCO", 3) == 0 && pInfo->tagV2Info.bGenreMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
 				{
-					realCpyFrameNum = purelyFramelen - encodingOffSet;
-					pExtContent = mmfile_malloc (realCpyFrameNum+3);
-					memset(pExtContent, '\0', realCpyFrameNum+3);
-					if(textEncodingType == AV_ID3V2_ISO_8859)
-					{
-						if(strncmp((char *)CompTmp, "APIC", 4) != 0)
-						{
-							tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
-							memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
-						}
-					}
-
-					memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
-					if(realCpyFrameNum > 0)
-					{
-						if(strncmp((char *)CompTmp, "TIT2", 4) == 0 && pInfo->tagV2Info.bTitleMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTitle = mmfile_string_convert ((char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
-							}
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
+				}
+				else
+				{
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
+				}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
-							#endif
-							pInfo->tagV2Info.bTitleMarked = true;
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
+				#endif
+				pInfo->tagV2Info.bGenreMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TRK", 3) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
+				else
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
 
-						}
-						else if(strncmp((char *)CompTmp, "TPE1", 4) == 0 && pInfo->tagV2Info.bArtistMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
-							}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
+				#endif
+				pInfo->tagV2Info.bTrackNumMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TEN", 3) == 0 && pInfo->tagV2Info.bEncByMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
+				}
+				else
+				{
+					pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
+				}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
-							#endif
-							pInfo->tagV2Info.bArtistMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TPE3", 4) == 0 && pInfo->tagV2Info.bConductorMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
-							}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
+				#endif
+				pInfo->tagV2Info.bEncByMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "WXX", 3) == 0 && pInfo->tagV2Info.bURLMarked == false)
+			{
+				if(realCpyFrameNum > 4)
+				{
+					//skip language data!
+					realCpyFrameNum -= 4;
+					tmp = 4;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
-							#endif
-							pInfo->tagV2Info.bConductorMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TALB", 4) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
+					//pExtContent[tmp+1] value should't have null value
+					if(pExtContent[tmp] > 0x20 && (pExtContent[tmp - 1] == 0x00 || pExtContent[tmp - 1] == 0x01))
+					{
+						if(pExtContent[tmp - 1] == 0x00)
+							textEncodingType = AV_ID3V2_ISO_8859;
+						else
+							textEncodingType = AV_ID3V2_UTF16;
+
+						if(textEncodingType == AV_ID3V2_UTF16)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
-							#endif
-							pInfo->tagV2Info.bAlbumMarked = true;
+							pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
 						}
-						else if(strncmp((char *)CompTmp, "TYER", 4) == 0 && pInfo->tagV2Info.bYearMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
-							}
+							pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
+						}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
-							#endif
-							pInfo->tagV2Info.bYearMarked = true;
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
+						#endif
+						pInfo->tagV2Info.bURLMarked = true;
+					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg (  "mmf_file_id3tag_parse_v222: failed to get URL Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet );
+						#endif
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg (  "mmf_file_id3tag_parse_v222: URL info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum );
+					#endif
+				}
+				tmp = 0;
+			}
+			else if(strncmp((char *)CompTmp, "TCR", 3) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
+				else
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
+				#endif
+				pInfo->tagV2Info.bCopyRightMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TOA", 3) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+				else
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
+				#endif
+				pInfo->tagV2Info.bOriginArtistMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TCM", 3) == 0 && pInfo->tagV2Info.bComposerMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
+				}
+				else
+				{
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pComposer returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
+				#endif
+				pInfo->tagV2Info.bComposerMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TRD", 3) == 0 && pInfo->tagV2Info.bRecDateMarked== false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
+				}
+				else
+				{
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
+				#endif
+				pInfo->tagV2Info.bRecDateMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "PIC", 3) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ("mmf_file_id3tag_parse_v222: this is abnormal case!!\n");
+					#endif
+				}
+				else
+				{
+					if(pExtContent[0] != 0)
+					{
+						for(inx = 0; inx < MP3_ID3_IMAGE_EXT_MAX_LENGTH; inx++)
+							pInfo->imageInfo.imageExt[inx] = '\0';//ini mimetype variable
+
+						while((checkImgExtMax < MP3_ID3_IMAGE_EXT_MAX_LENGTH-1) && pExtContent[checkImgExtMax] != '\0')
+						{
+							pInfo->imageInfo.imageExt[checkImgExtMax] = pExtContent[checkImgExtMax];
+							checkImgExtMax++;
 						}
-						else if(strncmp((char *)CompTmp, "COMM", 4) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
+					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						 debug_msg ( "mmf_file_id3tag_parse_v222: PIC image's not included to image Extention\n");
+						#endif
+					}
+
+					imgstartOffset += checkImgExtMax;
+
+					if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
+					{
+						pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
+					}
+					imgstartOffset++;//PictureType(1byte)
+
+					if(pExtContent[imgstartOffset] != 0x0)
+					{
+						for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
+							pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
+
+						while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
 						{
-							if(realCpyFrameNum > 3)
-							{
-								realCpyFrameNum -= 3;
-								tmp = 3;
+							pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
+							checkImgDescriptionMax++;
+						}
+						pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
+					}
+					else
+					{
+						pInfo->imageInfo.imgDesLen= 0;
+					}
 
-								//pExtContent[tmp+1] value should't have encoding value
-								if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
-								{
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-										{
-											realCpyFrameNum -= 4;
-											tmp += 4;
-										}
+					imgstartOffset += checkImgDescriptionMax;
 
-										if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else
-										{
-											#ifdef __MMFILE_TEST_MODE__
-											debug_msg ( "pInfo->pDescription Never Get Here!!\n");
-											#endif
-										}
-									}
-									else
-									{
-										while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-										{
-											realCpyFrameNum --;
-											tmp++;
-										}
-										textEncodingType = AV_ID3V2_ISO_8859;
-									}
+					if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
+					{
+						imgstartOffset ++; // endofDesceriptionType(1byte)
+
+						pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
+						pInfo->imageInfo.pImageBuf= mmfile_malloc (pInfo->imageInfo.imageLen + 1);
+						memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
+						pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
+
+						if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
+							pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
+					}
+
+				}
+
+				checkImgMimeTypeMax = 0;
+				checkImgDescriptionMax = 0;
+				checkImgExtMax = 0;
+				inx = 0;
+				imgstartOffset = 0;
+				pInfo->tagV2Info.bImageMarked= true;
+
+			}
+		}
+
+	}
+
+	if(pExtContent)	_FREE_EX(pExtContent);
+	if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
+}
+
+/* decodes one indexed v2.3 frame, the body of the former frame loop */
+static void _mm_file_id3tag_decode_v223 (AvFileContentInfo* pInfo, const unsigned char *buffer, const AvTagVer2Frame *frame, const char *locale)
+{
+	unsigned long curPos = frame->offset;
+	unsigned long purelyFramelen = frame->size;
+	const char *CompTmp = frame->id;
+	unsigned char *pExtContent = NULL;
+	char *tmpConvert2Pcode = NULL;
+	int inx=0, encodingOffSet=0, realCpyFrameNum=0, checkImgMimeTypeMax=0, checkImgDescriptionMax=0, imgstartOffset=0,  tmp = 0;
+	int textEncodingType = 0;
+
+	curPos += purelyFramelen;
+
+	if( IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen)) )
+	{
+		encodingOffSet = 2;
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+		#endif
+		textEncodingType = AV_ID3V2_UTF16;
+	}
+	else if ( IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen)) )
+	{
+		encodingOffSet = 2;
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+		#endif
+		textEncodingType = AV_ID3V2_UTF16_BE;
+	}
+	else if( IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen+1)) )
+	{
+		encodingOffSet = 3;
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+		#endif
+		textEncodingType = AV_ID3V2_UTF16;
+	}
+	else if ( IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen+1)) )
+	{
+		encodingOffSet = 3;
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "this text string(%s) encoded by UTF16 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+		#endif
+		textEncodingType = AV_ID3V2_UTF16_BE;
+	}
+	else
+	{
+		if (buffer[curPos-purelyFramelen+encodingOffSet] == 0x00)
+		{
+			#ifdef __MMFILE_TEST_MODE__
+			debug_msg ("encodingOffset will be set to 1\n");
+			#endif
+
+			encodingOffSet=1;
+		}
+		else
+		{
+			#ifdef __MMFILE_TEST_MODE__
+			debug_msg ("Finding encodingOffset\n");
+			#endif
+
+			while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen)) // text string encoded by ISO-8859-1
+				encodingOffSet++;
+		}
+		textEncodingType = AV_ID3V2_ISO_8859;
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "this text string(%s) encoded by ISO-8859-1 encodingOffSet(%d)\n", CompTmp, encodingOffSet);
+		#endif
+	}
+
+	if(encodingOffSet < purelyFramelen)
+	{
+		realCpyFrameNum = purelyFramelen - encodingOffSet;
+		pExtContent = mmfile_malloc (realCpyFrameNum+3);
+		memset(pExtContent, '\0', realCpyFrameNum+3);
+		if(textEncodingType == AV_ID3V2_ISO_8859)
+		{
+			if(strncmp((char *)CompTmp, "APIC", 4) != 0)
+			{
+				tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
+				memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
+			}
+		}
+
+		memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
+		if(realCpyFrameNum > 0)
+		{
+			if(strncmp((char *)CompTmp, "TIT2", 4) == 0 && pInfo->tagV2Info.bTitleMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pTitle = mmfile_string_convert ((char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
+				#endif
+				pInfo->tagV2Info.bTitleMarked = true;
+
+			}
+			else if(strncmp((char *)CompTmp, "TPE1", 4) == 0 && pInfo->tagV2Info.bArtistMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
+				#endif
+				pInfo->tagV2Info.bArtistMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TPE3", 4) == 0 && pInfo->tagV2Info.bConductorMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
+				#endif
+				pInfo->tagV2Info.bConductorMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TALB", 4) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
+				#endif
+				pInfo->tagV2Info.bAlbumMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TYER", 4) == 0 && pInfo->tagV2Info.bYearMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
+				}
 
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-									#endif
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
+				#endif
+				pInfo->tagV2Info.bYearMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "COMM", 4) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
+			{
+				if(realCpyFrameNum > 3)
+				{
+					realCpyFrameNum -= 3;
+					tmp = 3;
 
-									if(textEncodingType == AV_ID3V2_UTF16)
-									{
-										pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
-									}
-									else if (textEncodingType == AV_ID3V2_UTF16_BE)
-									{
-										debug_warning ("not implemented\n");
-									}
-									else
-									{
-										pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
-									}
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "failed to get Comment Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
-									#endif
-									pInfo->descriptionLen = 0;
-								}
-							}
-							else
+					//pExtContent[tmp+1] value should't have encoding value
+					if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
+					{
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
+						{
+							while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
 							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
-								#endif
-								pInfo->descriptionLen = 0;
+								realCpyFrameNum -= 4;
+								tmp += 4;
 							}
-							tmp = 0;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
-							#endif
-							pInfo->tagV2Info.bDescriptionMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "SYLT", 4) == 0 && pInfo->tagV2Info.bSyncLyricsMarked == false)
-						{
-							int idx = 0;
-							int copy_len = 0;
-							int copy_start_pos = tmp;
-							AvSynclyricsInfo *synclyrics_info = NULL;
-							GList *synclyrics_info_list = NULL;
-									
-							if(realCpyFrameNum > 5)
+							if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
 							{
-								realCpyFrameNum -= 5;
-								tmp = 5;
-
-								//pExtContent[tmp+1] value should't have encoding value
-								if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
-								{
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-										{
-											realCpyFrameNum -= 4;
-											tmp += 4;
-										}
-
-										if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else
-										{
-											#ifdef __MMFILE_TEST_MODE__
-											debug_msg ( "pInfo->pSyncLyrics Never Get Here!!\n");
-											#endif
-										}
-									}
-									else
-									{
-										while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-										{
-											realCpyFrameNum --;
-											tmp++;
-										}
-										textEncodingType = AV_ID3V2_ISO_8859;
-									}
-
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-									#endif
-
-									if(realCpyFrameNum < MMFILE_SYNC_LYRIC_INFO_MIN_LEN)
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "failed to get Synchronised lyrics Info realCpyFramNum(%d)\n", realCpyFrameNum);
-										#endif
-										pInfo->syncLyricsNum = 0;
-									}
-									else
-									{
-										if(textEncodingType == AV_ID3V2_UTF16)
-										{
-											debug_warning ("[AV_ID3V2_UTF16] not implemented\n");
-										}
-										else if (textEncodingType == AV_ID3V2_UTF16_BE)
-										{
-											debug_warning ("[AV_ID3V2_UTF16_BE] not implemented\n");
-										}
-										else
-										{
-											for(idx = 0; idx < realCpyFrameNum; idx++)
-											{
-												if(pExtContent[tmp+idx] == 0x00)
-												{
-													synclyrics_info = (AvSynclyricsInfo *)malloc(sizeof(AvSynclyricsInfo));
-
-													if(textEncodingType == AV_ID3V2_UTF8) {
-														synclyrics_info->lyric_info= mmfile_malloc(copy_len+1);
-														memset(synclyrics_info->lyric_info, 0, copy_len+1);
-														memcpy(synclyrics_info->lyric_info, pExtContent+copy_start_pos, copy_len);
-														synclyrics_info->lyric_info[copy_len+1] = '\0';
-													}
-													else {
-														synclyrics_info->lyric_info = mmfile_string_convert ((const char*)&pExtContent[copy_start_pos], copy_len, "UTF-8", locale, NULL, NULL);
-													}
-
-													synclyrics_info->time_info= (unsigned long)pExtContent[tmp+idx+1] << 24 | (unsigned long)pExtContent[tmp+idx+2] << 16 | (unsigned long)pExtContent[tmp+idx+3] << 8  | (unsigned long)pExtContent[tmp+idx+4];
-													idx += 4;
-													copy_start_pos = tmp + idx + 1;
-													debug_msg("[%d][%s] idx[%d], copy_len[%d] copy_start_pos[%d]", synclyrics_info->time_info, synclyrics_info->lyric_info, idx, copy_len, copy_start_pos);
-													copy_len = 0;
-													synclyrics_info_list = g_list_append(synclyrics_info_list, synclyrics_info);
-												}
-												copy_len ++;
-											}
-											pInfo->pSyncLyrics = synclyrics_info_list;
-											pInfo->syncLyricsNum = g_list_length(pInfo->pSyncLyrics);
-										}
-									}
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "failed to get Synchronised lyrics Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
-									#endif
-									pInfo->syncLyricsNum = 0;
-								}
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16;
 							}
-							else
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
 							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "Synchronised lyrics too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
-								#endif
-								pInfo->syncLyricsNum = 0;
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16_BE;
 							}
-							tmp = 0;
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pSyncLyrics returned = (%s), pInfo->syncLyricsNum(%d)\n", pInfo->pSyncLyrics, pInfo->syncLyricsNum);
-							#endif
-							pInfo->tagV2Info.bSyncLyricsMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "USLT", 4) == 0 && pInfo->tagV2Info.bUnsyncLyricsMarked == false)
-						{
-							if(realCpyFrameNum > 3)
+							else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
 							{
 								realCpyFrameNum -= 3;
-								tmp = 3;
-
-								//pExtContent[tmp+1] value should't have encoding value
-								if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
-								{
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-										{
-											realCpyFrameNum -= 4;
-											tmp += 4;
-										}
-
-										if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
-										{
-											realCpyFrameNum -= 2;
-											tmp += 2;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16;
-										}
-										else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
-										{
-											realCpyFrameNum -= 3;
-											tmp += 3;
-											textEncodingType = AV_ID3V2_UTF16_BE;
-										}
-										else
-										{
-											#ifdef __MMFILE_TEST_MODE__
-											debug_msg ( "pInfo->pUnsyncLyrics Never Get Here!!\n");
-											#endif
-										}
-									}
-									else
-									{
-										while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-										{
-											realCpyFrameNum --;
-											tmp++;
-										}
-										textEncodingType = AV_ID3V2_ISO_8859;
-									}
-
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-									#endif
-
-									if(textEncodingType == AV_ID3V2_UTF16)
-									{
-										pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->unsynclyricsLen);
-									}
-									else if (textEncodingType == AV_ID3V2_UTF16_BE)
-									{
-										debug_warning ("not implemented\n");
-									}
-									else
-									{
-										pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->unsynclyricsLen);
-									}
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "failed to get Unsynchronised lyrics Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
-									#endif
-									pInfo->unsynclyricsLen = 0;
-								}
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16;
+							}
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
+							{
+								realCpyFrameNum -= 3;
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16_BE;
 							}
 							else
 							{
 								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "Unsynchronised lyrics too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+								debug_msg ( "pInfo->pDescription Never Get Here!!\n");
 								#endif
-								pInfo->unsynclyricsLen = 0;
 							}
-							tmp = 0;
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pUnsyncLyrics returned = (%s), pInfo->unsynclyricsLen(%d)\n", pInfo->pUnsyncLyrics, pInfo->unsynclyricsLen);
-							#endif
-							pInfo->tagV2Info.bUnsyncLyricsMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TCON", 4) == 0 && pInfo->tagV2Info.bGenreMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
+							while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
+								realCpyFrameNum --;
+								tmp++;
 							}
+							textEncodingType = AV_ID3V2_ISO_8859;
+						}
 
-								#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
-								#endif
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+						#endif
 
-							pInfo->tagV2Info.bGenreMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TRCK", 4) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
+						if(textEncodingType == AV_ID3V2_UTF16)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
-							#endif
-							pInfo->tagV2Info.bTrackNumMarked = true;
+							pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
 						}
-						else if(strncmp((char *)CompTmp, "TENC", 4) == 0 && pInfo->tagV2Info.bEncByMarked == false)
+						else if (textEncodingType == AV_ID3V2_UTF16_BE)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pEncBy = mmfile_string_convert ((char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
-							#endif
-							pInfo->tagV2Info.bEncByMarked = true;
+							debug_warning ("not implemented\n");
 						}
-						else if(strncmp((char *)CompTmp, "WXXX", 4) == 0 && pInfo->tagV2Info.bURLMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
-							{
-								pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
-							#endif
-							pInfo->tagV2Info.bURLMarked = true;
+							pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
 						}
-						else if(strncmp((char *)CompTmp, "TCOP", 4) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
+					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "failed to get Comment Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
+						#endif
+						pInfo->descriptionLen = 0;
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+					#endif
+					pInfo->descriptionLen = 0;
+				}
+				tmp = 0;
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
+				#endif
+				pInfo->tagV2Info.bDescriptionMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "SYLT", 4) == 0 && pInfo->tagV2Info.bSyncLyricsMarked == false)
+			{
+				int idx = 0;
+				int copy_len = 0;
+				int copy_start_pos = tmp;
+				AvSynclyricsInfo *synclyrics_info = NULL;
+				GList *synclyrics_info_list = NULL;
+						
+				if(realCpyFrameNum > 5)
+				{
+					realCpyFrameNum -= 5;
+					tmp = 5;
+
+					//pExtContent[tmp+1] value should't have encoding value
+					if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
+					{
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
+							while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
 							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
+								realCpyFrameNum -= 4;
+								tmp += 4;
 							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
+
+							if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
 							{
-								debug_warning ("not implemented\n");
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16;
 							}
-							else
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
 							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16_BE;
 							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
-							#endif
-							pInfo->tagV2Info.bCopyRightMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TOPE", 4) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
+							else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
 							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
+								realCpyFrameNum -= 3;
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16;
 							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
 							{
-								debug_warning ("not implemented\n");
+								realCpyFrameNum -= 3;
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16_BE;
 							}
 							else
 							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
+								#ifdef __MMFILE_TEST_MODE__
+								debug_msg ( "pInfo->pSyncLyrics Never Get Here!!\n");
+								#endif
 							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
-							#endif
-							pInfo->tagV2Info.bOriginArtistMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TCOM", 4) == 0 && pInfo->tagV2Info.bComposerMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else
+							while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
+								realCpyFrameNum --;
+								tmp++;
 							}
+							textEncodingType = AV_ID3V2_ISO_8859;
+						}
+
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+						#endif
 
+						if(realCpyFrameNum < MMFILE_SYNC_LYRIC_INFO_MIN_LEN)
+						{
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pComposer returned = (%s), pInfo->composerLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
+							debug_msg ( "failed to get Synchronised lyrics Info realCpyFramNum(%d)\n", realCpyFrameNum);
 							#endif
-							pInfo->tagV2Info.bComposerMarked = true;
+							pInfo->syncLyricsNum = 0;
 						}
-						else if(strncmp((char *)CompTmp, "TRDA", 4) == 0 && pInfo->tagV2Info.bRecDateMarked== false)
+						else
 						{
 							if(textEncodingType == AV_ID3V2_UTF16)
 							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
+								debug_warning ("[AV_ID3V2_UTF16] not implemented\n");
 							}
 							else if (textEncodingType == AV_ID3V2_UTF16_BE)
 							{
-								debug_warning ("not implemented\n");
+								debug_warning ("[AV_ID3V2_UTF16_BE] not implemented\n");
 							}
 							else
 							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
-							#endif
-							pInfo->tagV2Info.bRecDateMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "APIC", 4) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "mmf_file_id3tag_parse_v223: this is abnormal case!!\n");
-								#endif
-
-							}
-							else
-							{
-								if(pExtContent[0] != '\0')
+								for(idx = 0; idx < realCpyFrameNum; idx++)
 								{
-									for(inx = 0; inx < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1; inx++)
-										pInfo->imageInfo.imageMIMEType[inx] = '\0';//ini mimetype variable
-
-									while((checkImgMimeTypeMax < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1) && pExtContent[checkImgMimeTypeMax] != '\0')
+									if(pExtContent[tmp+idx] == 0x00)
 									{
-										pInfo->imageInfo.imageMIMEType[checkImgMimeTypeMax] = pExtContent[checkImgMimeTypeMax];
-										checkImgMimeTypeMax++;
-									}
-									pInfo->imageInfo.imgMimetypeLen = checkImgMimeTypeMax;
-								}
-								else
-								{
-									pInfo->imageInfo.imgMimetypeLen = 0;
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "APIC image's not included to MIME type\n");
-									#endif
-								}
+										synclyrics_info = (AvSynclyricsInfo *)malloc(sizeof(AvSynclyricsInfo));
 
-								imgstartOffset += checkImgMimeTypeMax;
-
-								if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
-								{
-									imgstartOffset++;//endofMIME(1byte)
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "after scaning Mime type imgstartOffset(%d) value!\n", imgstartOffset);
-									#endif
+										if(textEncodingType == AV_ID3V2_UTF8) {
+											synclyrics_info->lyric_info= mmfile_malloc(copy_len+1);
+											memset(synclyrics_info->lyric_info, 0, copy_len+1);
+											memcpy(synclyrics_info->lyric_info, pExtContent+copy_start_pos, copy_len);
+											synclyrics_info->lyric_info[copy_len+1] = '\0';
+										}
+										else {
+											synclyrics_info->lyric_info = mmfile_string_convert ((const char*)&pExtContent[copy_start_pos], copy_len, "UTF-8", locale, NULL, NULL);
+										}
 
-									if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
-									{
-										pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
-									}
-									else
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "APIC image has invalid picture type(0x%x)\n", pExtContent[imgstartOffset]);
-										#endif
+										synclyrics_info->time_info= (unsigned long)pExtContent[tmp+idx+1] << 24 | (unsigned long)pExtContent[tmp+idx+2] << 16 | (unsigned long)pExtContent[tmp+idx+3] << 8  | (unsigned long)pExtContent[tmp+idx+4];
+										idx += 4;
+										copy_start_pos = tmp + idx + 1;
+										debug_msg("[%d][%s] idx[%d], copy_len[%d] copy_start_pos[%d]", synclyrics_info->time_info, synclyrics_info->lyric_info, idx, copy_len, copy_start_pos);
+										copy_len = 0;
+										synclyrics_info_list = g_list_append(synclyrics_info_list, synclyrics_info);
 									}
-									imgstartOffset++;//PictureType(1byte)
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "after scaning PictureType imgstartOffset(%d) value!\n", imgstartOffset);
-									#endif
-
-									if(pExtContent[imgstartOffset] != 0x0)
-									{
-										for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
-											pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
+									copy_len ++;
+								}
+								pInfo->pSyncLyrics = synclyrics_info_list;
+								pInfo->syncLyricsNum = g_list_length(pInfo->pSyncLyrics);
+							}
+						}
+					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "failed to get Synchronised lyrics Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
+						#endif
+						pInfo->syncLyricsNum = 0;
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "Synchronised lyrics too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+					#endif
+					pInfo->syncLyricsNum = 0;
+				}
+				tmp = 0;
 
-										while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
-										{
-											pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
-											checkImgDescriptionMax++;
-										}
-										pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
-									}
-									else
-									{
-										pInfo->imageInfo.imgDesLen= 0;
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "APIC image's not included to Description!!!\n");
-										#endif
-									}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pSyncLyrics returned = (%s), pInfo->syncLyricsNum(%d)\n", pInfo->pSyncLyrics, pInfo->syncLyricsNum);
+				#endif
+				pInfo->tagV2Info.bSyncLyricsMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "USLT", 4) == 0 && pInfo->tagV2Info.bUnsyncLyricsMarked == false)
+			{
+				if(realCpyFrameNum > 3)
+				{
+					realCpyFrameNum -= 3;
+					tmp = 3;
 
-									imgstartOffset += checkImgDescriptionMax;
-									if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
-									{
-										imgstartOffset ++; // endofDesceriptionType(1byte)
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "after scaning imgDescription imgstartOffset(%d) value!\n", imgstartOffset);
-										#endif
-										pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
-										pInfo->imageInfo.pImageBuf = mmfile_malloc (pInfo->imageInfo.imageLen + 1);
-										memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
-										pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
-										if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
-											pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
-
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "pInfo->imageInfo.imageLen(%d), imgstartOffset(%d)!\n", pInfo->imageInfo.imageLen, imgstartOffset);
-										#endif
-									}
-									else
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "pExtContent[imgstartOffset](%d) value should setted NULL value for end of description! realCpyFrameNum - imgstartOffset(%d)\n",
-													pExtContent[imgstartOffset], realCpyFrameNum - imgstartOffset);
-										#endif
-									}
-								}
-								else
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "pExtContent[imgstartOffset](%d) value should setted NULL value for end of mimetype! realCpyFrameNum - imgstartOffset(%d)\n",
-											pExtContent[imgstartOffset], realCpyFrameNum - imgstartOffset);
-									#endif
-								}
+					//pExtContent[tmp+1] value should't have encoding value
+					if(pExtContent[tmp] == 0x00 || pExtContent[tmp] == 0xFF|| pExtContent[tmp] == 0xFE)
+					{
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
+						{
+							while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
+							{
+								realCpyFrameNum -= 4;
+								tmp += 4;
+							}
 
+							if(IS_ENCODEDBY_UTF16(pExtContent+tmp) && (realCpyFrameNum > 2))
+							{
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16;
+							}
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp) && (realCpyFrameNum > 2))
+							{
+								realCpyFrameNum -= 2;
+								tmp += 2;
+								textEncodingType = AV_ID3V2_UTF16_BE;
+							}
+							else if(IS_ENCODEDBY_UTF16(pExtContent+tmp+1) && (realCpyFrameNum > 3))
+							{
+								realCpyFrameNum -= 3;
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16;
+							}
+							else if (IS_ENCODEDBY_UTF16_R(pExtContent+tmp+1)  && (realCpyFrameNum > 3))
+							{
+								realCpyFrameNum -= 3;
+								tmp += 3;
+								textEncodingType = AV_ID3V2_UTF16_BE;
 							}
+							else
+							{
+								#ifdef __MMFILE_TEST_MODE__
+								debug_msg ( "pInfo->pUnsyncLyrics Never Get Here!!\n");
+								#endif
+							}
+						}
+						else
+						{
+							while((pExtContent[tmp] < 0x20) && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
+							{
+								realCpyFrameNum --;
+								tmp++;
+							}
+							textEncodingType = AV_ID3V2_ISO_8859;
+						}
 
-							checkImgMimeTypeMax = 0;
-							checkImgDescriptionMax = 0;
-							inx = 0;
-							imgstartOffset = 0;
-							pInfo->tagV2Info.bImageMarked= true;
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+						#endif
 
+						if(textEncodingType == AV_ID3V2_UTF16)
+						{
+							pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->unsynclyricsLen);
+						}
+						else if (textEncodingType == AV_ID3V2_UTF16_BE)
+						{
+							debug_warning ("not implemented\n");
 						}
 						else
 						{
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "CompTmp(%s) This Frame ID currently not Supports!!\n", CompTmp);
-							#endif
+							pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->unsynclyricsLen);
 						}
 					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "failed to get Unsynchronised lyrics Info tmp(%d), purelyFramelen - encodingOffSet(%d)\n", tmp, purelyFramelen - encodingOffSet);
+						#endif
+						pInfo->unsynclyricsLen = 0;
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "Unsynchronised lyrics too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+					#endif
+					pInfo->unsynclyricsLen = 0;
+				}
+				tmp = 0;
 
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pUnsyncLyrics returned = (%s), pInfo->unsynclyricsLen(%d)\n", pInfo->pUnsyncLyrics, pInfo->unsynclyricsLen);
+				#endif
+				pInfo->tagV2Info.bUnsyncLyricsMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TCON", 4) == 0 && pInfo->tagV2Info.bGenreMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
 				}
 				else
 				{
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
+				}
+
 					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "All of the pExtContent Values are NULL\n");
+						debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
 					#endif
+
+				pInfo->tagV2Info.bGenreMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TRCK", 4) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
 				}
+				else
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
+				#endif
+				pInfo->tagV2Info.bTrackNumMarked = true;
 			}
-			else
+			else if(strncmp((char *)CompTmp, "TENC", 4) == 0 && pInfo->tagV2Info.bEncByMarked == false)
 			{
-				curPos += purelyFramelen;
-				if(purelyFramelen != 0)
-					needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pEncBy = mmfile_string_convert ((char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
+				}
 				#ifdef __MMFILE_TEST_MODE__
-				debug_msg ( "This Frame's size is Zero! purelyFramelen(%d)\n", purelyFramelen);
+				debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
 				#endif
+				pInfo->tagV2Info.bEncByMarked = true;
 			}
+			else if(strncmp((char *)CompTmp, "WXXX", 4) == 0 && pInfo->tagV2Info.bURLMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
+				}
 
-			if(pExtContent)	_FREE_EX(pExtContent);
-			if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
-			memset(CompTmp, 0, 4);
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
+				#endif
+				pInfo->tagV2Info.bURLMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TCOP", 4) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
 
-			if(curPos < taglen)
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
+				#endif
+				pInfo->tagV2Info.bCopyRightMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TOPE", 4) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
 			{
-				needToloopv2taglen -= oneFrameLen;
-				v2numOfFrames++;
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
+				#endif
+				pInfo->tagV2Info.bOriginArtistMarked = true;
 			}
-			else
-				needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
-			oneFrameLen = 0;
-			encodingOffSet = 0;
-			realCpyFrameNum = 0;
-			textEncodingType = 0;
-			purelyFramelen = 0;
-
-		}
-	}
-
-	if(taglen)
-		return true;
-	else
-		return false;
-
-}
-
-EXPORT_API
-bool mm_file_id3tag_parse_v224(AvFileContentInfo* pInfo, unsigned char *buffer)
-{
-	unsigned long taglen = 0;
-	unsigned long needToloopv2taglen;
-	unsigned long oneFrameLen = 0;
-	unsigned long v2numOfFrames = 0;
-	unsigned long curPos = 0;
-	char CompTmp[5];
-	unsigned char *pExtContent = NULL;
-	unsigned long purelyFramelen = 0;
-	char *tmpConvert2Pcode = NULL;
-	int inx=0, encodingOffSet=0, realCpyFrameNum=0, checkImgMimeTypeMax=0, checkImgDescriptionMax=0, imgstartOffset=0,  tmp = 0;
-	int textEncodingType = 0;
-	const char *locale = NULL;
-
-	locale = MMFileUtilGetLocale (NULL);
-
-	pInfo->tagV2Info.bTitleMarked = false;
-	pInfo->tagV2Info.bAlbumMarked= false;
-	pInfo->tagV2Info.bArtistMarked= false;
-	pInfo->tagV2Info.bDescriptionMarked= false;
-	pInfo->tagV2Info.bGenreMarked= false;
-	pInfo->tagV2Info.bYearMarked= false;
-	pInfo->tagV2Info.bTrackNumMarked= false;
-	pInfo->tagV2Info.bEncByMarked= false;
-	pInfo->tagV2Info.bURLMarked= false;
-	pInfo->tagV2Info.bCopyRightMarked= false;
-	pInfo->tagV2Info.bOriginArtistMarked= false;
-	pInfo->tagV2Info.bComposerMarked= false;
-	pInfo->tagV2Info.bImageMarked= false;
-	pInfo->imageInfo.bURLInfo = false;
-	pInfo->tagV2Info.bConductorMarked = false;
-	pInfo->tagV2Info.bGenreUTF16 = false;
-	pInfo->tagV2Info.bUnsyncLyricsMarked = false;
-	pInfo->tagV2Info.bSyncLyricsMarked = false;
-
-	pInfo->imageInfo.pImageBuf = NULL;
-	pInfo->imageInfo.imageLen = 0;
-
-	taglen = pInfo->tagV2Info.tagLen;
-	needToloopv2taglen = taglen - MP3_TAGv2_HEADER_LEN;
-	curPos = MP3_TAGv2_HEADER_LEN;
-
-#ifdef __MMFILE_TEST_MODE__
-	debug_msg ("ID3tag v224--------------------------------------------------------------\n");
-#endif
-
-	/* check Extended Header */
-	if (buffer[5] & 0x40)
-	{
-		/* if extended header exists, skip it*/
-		int extendedHeaderLen = (unsigned long)buffer[10] << 21 | (unsigned long)buffer[11] << 14 | (unsigned long)buffer[12] << 7  | (unsigned long)buffer[13];
-
-		#ifdef __MMFILE_TEST_MODE__
-		debug_msg ("[%s][%d]--------------- extendedHeaderLen = %d\n",__func__,__LINE__, extendedHeaderLen);
-		#endif 
-
-		curPos += extendedHeaderLen;
-	}
-
-	if(needToloopv2taglen -MP3_TAGv2_23_TXT_HEADER_LEN > MP3_TAGv2_23_TXT_HEADER_LEN)
-	{
-		v2numOfFrames = 1;
-		while(needToloopv2taglen > MP3_TAGv2_23_TXT_HEADER_LEN)
-		{
-			if((buffer[curPos] < '0' || buffer[curPos] > 'Z') || (buffer[curPos+1] < '0' || buffer[curPos+1] > 'Z')
-				|| (buffer[curPos+2] < '0' || buffer[curPos+2] > 'Z')|| (buffer[curPos+3] < '0' || buffer[curPos+3] > 'Z'))
-				break;
-
-			memcpy(CompTmp, &buffer[curPos], 4);
-
-			CompTmp[4] = 0;
-			oneFrameLen = MP3_TAGv2_23_TXT_HEADER_LEN;
-			oneFrameLen += (unsigned long)buffer[4+curPos] << 21 | (unsigned long)buffer[5+curPos] << 14
-				| (unsigned long)buffer[6+curPos] << 7 | (unsigned long)buffer[7+curPos];
-			if(oneFrameLen > taglen-curPos)
-				break;
-
-			purelyFramelen = oneFrameLen - MP3_TAGv2_23_TXT_HEADER_LEN;
-			curPos +=MP3_TAGv2_23_TXT_HEADER_LEN;
-
-#ifdef __MMFILE_TEST_MODE__
-			debug_msg ("-----------------------------------------------------------------------------------\n");
-#endif
-
-			if(oneFrameLen > MP3_TAGv2_23_TXT_HEADER_LEN && purelyFramelen <= taglen-curPos)
+			else if(strncmp((char *)CompTmp, "TCOM", 4) == 0 && pInfo->tagV2Info.bComposerMarked == false)
 			{
-				curPos += purelyFramelen;
-
-				//in case of UTF 16 encoding
-				//buffer+(curPos-purelyFramelen) data should '0x01' but in order to expansion, we don't accurately check the value.
-				if(IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen)))
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
 				{
-					encodingOffSet = 2;
-					textEncodingType = AV_ID3V2_UTF16;
+					debug_warning ("not implemented\n");
 				}
-				else if (IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen)))
+				else
 				{
-					encodingOffSet = 2;
-					textEncodingType = AV_ID3V2_UTF16_BE;
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
 				}
-				else if(IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen+1)))
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pComposer returned = (%s), pInfo->composerLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
+				#endif
+				pInfo->tagV2Info.bComposerMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TRDA", 4) == 0 && pInfo->tagV2Info.bRecDateMarked== false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
 				{
-					encodingOffSet = 3;
-					textEncodingType = AV_ID3V2_UTF16;
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
 				}
-				else if(IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen+1)))
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
 				{
-					encodingOffSet = 3;
-					textEncodingType = AV_ID3V2_UTF16_BE;
+					debug_warning ("not implemented\n");
 				}
 				else
 				{
-					//in case of UTF-16 BE encoding
-					if(buffer[curPos-purelyFramelen] == 0x02)
-					{
-						encodingOffSet = 1;
-						while((buffer[curPos-purelyFramelen+encodingOffSet] == '\0') && (encodingOffSet < purelyFramelen))
-							encodingOffSet++;//null skip!
-						textEncodingType = AV_ID3V2_UTF16_BE;
-					}
-					//in case of UTF8 encoding
-					else if (buffer[curPos-purelyFramelen] == 0x03)
-					{
-						encodingOffSet = 1;
-						while((buffer[curPos-purelyFramelen+encodingOffSet] == '\0') && (encodingOffSet < purelyFramelen))
-							encodingOffSet++;//null skip!
-						textEncodingType = AV_ID3V2_UTF8;
-					}
-					//in case of ISO-8859-1 encoding
-					else
-					{
-						//buffer+(curPos-purelyFramelen) data should 0x00 but in order to expansion, we don't accurately check the value.
-						encodingOffSet = 1;
-						while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen))
-							encodingOffSet++;//less than 0x20 value skip!
-						textEncodingType = AV_ID3V2_ISO_8859;
-					}
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
 				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
+				#endif
+				pInfo->tagV2Info.bRecDateMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "APIC", 4) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "mmf_file_id3tag_parse_v223: this is abnormal case!!\n");
+					#endif
 
-				if(encodingOffSet < purelyFramelen)
+				}
+				else
 				{
-					realCpyFrameNum = purelyFramelen - encodingOffSet;
-					pExtContent = mmfile_malloc (realCpyFrameNum+3);
-					memset(pExtContent, '\0', realCpyFrameNum+3);
-					if(textEncodingType == AV_ID3V2_ISO_8859)
+					if(pExtContent[0] != '\0')
 					{
-						if(strncmp((char *)CompTmp, "APIC", 4) != 0)
+						for(inx = 0; inx < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1; inx++)
+							pInfo->imageInfo.imageMIMEType[inx] = '\0';//ini mimetype variable
+
+						while((checkImgMimeTypeMax < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1) && pExtContent[checkImgMimeTypeMax] != '\0')
 						{
-							tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
-							memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
+							pInfo->imageInfo.imageMIMEType[checkImgMimeTypeMax] = pExtContent[checkImgMimeTypeMax];
+							checkImgMimeTypeMax++;
 						}
+						pInfo->imageInfo.imgMimetypeLen = checkImgMimeTypeMax;
+					}
+					else
+					{
+						pInfo->imageInfo.imgMimetypeLen = 0;
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "APIC image's not included to MIME type\n");
+						#endif
 					}
 
-					memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
+					imgstartOffset += checkImgMimeTypeMax;
 
-					if(realCpyFrameNum > 0)
+					if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
 					{
-						if(strncmp((char *)CompTmp, "TIT2", 4) == 0 && pInfo->tagV2Info.bTitleMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pTitle= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pTitle, pExtContent, realCpyFrameNum);
-								pInfo->pTitle[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->titleLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pTitle, pExtContent, pInfo->titleLen);
-							}
-							else
-							{
-								pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
-							#endif
-							pInfo->tagV2Info.bTitleMarked = true;
+						imgstartOffset++;//endofMIME(1byte)
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "after scaning Mime type imgstartOffset(%d) value!\n", imgstartOffset);
+						#endif
 
+						if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
+						{
+							pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
 						}
-						else if(strncmp((char *)CompTmp, "TPE1", 4) == 0 && pInfo->tagV2Info.bArtistMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pArtist= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pArtist, pExtContent, realCpyFrameNum);
-								pInfo->pArtist[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->artistLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pArtist, pExtContent, pInfo->artistLen);
-							}
-							else
-							{
-								pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
-							}
-
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
+							debug_msg ( "APIC image has invalid picture type(0x%x)\n", pExtContent[imgstartOffset]);
 							#endif
-							pInfo->tagV2Info.bArtistMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TPE3", 4) == 0 && pInfo->tagV2Info.bConductorMarked == false)
+						imgstartOffset++;//PictureType(1byte)
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "after scaning PictureType imgstartOffset(%d) value!\n", imgstartOffset);
+						#endif
+
+						if(pExtContent[imgstartOffset] != 0x0)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pConductor= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pConductor, pExtContent, realCpyFrameNum);
-								pInfo->pConductor[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->conductorLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pConductor, pExtContent, pInfo->conductorLen);
-							}
-							else
+							for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
+								pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
+
+							while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
 							{
-								pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
+								pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
+								checkImgDescriptionMax++;
 							}
-
+							pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
+						}
+						else
+						{
+							pInfo->imageInfo.imgDesLen= 0;
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
+							debug_msg ( "APIC image's not included to Description!!!\n");
 							#endif
-							pInfo->tagV2Info.bConductorMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TALB", 4) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
+
+						imgstartOffset += checkImgDescriptionMax;
+						if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pAlbum= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pAlbum, pExtContent, realCpyFrameNum);
-								pInfo->pAlbum[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->albumLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pAlbum, pExtContent, pInfo->albumLen);
-							}
-							else
-							{
-								pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
-							}
+							imgstartOffset ++; // endofDesceriptionType(1byte)
+							#ifdef __MMFILE_TEST_MODE__
+							debug_msg ( "after scaning imgDescription imgstartOffset(%d) value!\n", imgstartOffset);
+							#endif
+							pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
+							pInfo->imageInfo.pImageBuf = mmfile_malloc (pInfo->imageInfo.imageLen + 1);
+							memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
+							pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
+							if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
+								pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
 
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
+							debug_msg ( "pInfo->imageInfo.imageLen(%d), imgstartOffset(%d)!\n", pInfo->imageInfo.imageLen, imgstartOffset);
 							#endif
-							pInfo->tagV2Info.bAlbumMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TYER", 4) == 0 && pInfo->tagV2Info.bYearMarked == false)	//TODO. TYER is replaced by the TDRC. but many files use TYER in v2.4
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pYear= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pYear, pExtContent, realCpyFrameNum);
-								pInfo->pYear[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->yearLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pYear, pExtContent, pInfo->yearLen);
-							}
-							else
-							{
-								pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
-							}
-
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
+							debug_msg ( "pExtContent[imgstartOffset](%d) value should setted NULL value for end of description! realCpyFrameNum - imgstartOffset(%d)\n",
+										pExtContent[imgstartOffset], realCpyFrameNum - imgstartOffset);
 							#endif
-							pInfo->tagV2Info.bYearMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "COMM", 4) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
-						{
-							if(realCpyFrameNum > 3)
-							{
-								realCpyFrameNum -= 3;
-								tmp = 3;
+					}
+					else
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "pExtContent[imgstartOffset](%d) value should setted NULL value for end of mimetype! realCpyFrameNum - imgstartOffset(%d)\n",
+								pExtContent[imgstartOffset], realCpyFrameNum - imgstartOffset);
+						#endif
+					}
 
-								if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
-								{
-									while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-									{
-										realCpyFrameNum -= 4;
-										tmp += 4;
-									}
+				}
 
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										realCpyFrameNum -= 2;
-										tmp += 2;
-										textEncodingType = AV_ID3V2_UTF16;
-									}
-									else
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "pInfo->pDescription Never Get Here!!\n");
-										#endif
-									}
-								}
-								else if(textEncodingType == AV_ID3V2_UTF8)
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_UTF8;
-								}
-								else
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_ISO_8859;
-								}
+				checkImgMimeTypeMax = 0;
+				checkImgDescriptionMax = 0;
+				inx = 0;
+				imgstartOffset = 0;
+				pInfo->tagV2Info.bImageMarked= true;
 
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-								#endif
+			}
+			else
+			{
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "CompTmp(%s) This Frame ID currently not Supports!!\n", CompTmp);
+				#endif
+			}
+		}
 
-								if(textEncodingType == AV_ID3V2_UTF16)
-								{
-									pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
-								}
-								else if(textEncodingType == AV_ID3V2_UTF16_BE)
-								{
-									debug_warning ("not implemented\n");
-								}
-								else if(textEncodingType == AV_ID3V2_UTF8)
-								{
-									pInfo->pDescription= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-									memset(pInfo->pDescription, 0, (realCpyFrameNum+2));
-									memcpy(pInfo->pDescription, pExtContent+tmp, realCpyFrameNum);
-									pInfo->pDescription[realCpyFrameNum] = '\0';
-									/*string copy with '\0'*/
-									pInfo->descriptionLen = realCpyFrameNum;
-									_STRNCPY_EX (pInfo->pDescription, pExtContent, pInfo->descriptionLen);
-								}
-								else
-								{
-									pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
-								}
-							}
-							else
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg (  "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
-								#endif
-							}
+	}
+	else
+	{
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "All of the pExtContent Values are NULL\n");
+		#endif
+	}
 
-							tmp = 0;
+	if(pExtContent)	_FREE_EX(pExtContent);
+	if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
+}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
-							#endif
-							pInfo->tagV2Info.bDescriptionMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "SYLT", 4) == 0 && pInfo->tagV2Info.bSyncLyricsMarked == false)
-						{
-							int idx = 0;
-							int copy_len = 0;
-							int copy_start_pos = tmp;
-							AvSynclyricsInfo *synclyrics_info = NULL;
-							GList *synclyrics_info_list = NULL;
-							
-							if(realCpyFrameNum > 5)
-							{
-								realCpyFrameNum -= 5;
-								tmp = 5;
+/* decodes one indexed v2.4 frame, the body of the former frame loop */
+static void _mm_file_id3tag_decode_v224 (AvFileContentInfo* pInfo, const unsigned char *buffer, const AvTagVer2Frame *frame, const char *locale)
+{
+	unsigned long curPos = frame->offset;
+	unsigned long purelyFramelen = frame->size;
+	const char *CompTmp = frame->id;
+	unsigned char *pExtContent = NULL;
+	char *tmpConvert2Pcode = NULL;
+	int inx=0, encodingOffSet=0, realCpyFrameNum=0, checkImgMimeTypeMax=0, checkImgDescriptionMax=0, imgstartOffset=0,  tmp = 0;
+	int textEncodingType = 0;
 
-								if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
-								{
-									while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-									{
-										realCpyFrameNum -= 4;
-										tmp += 4;
-									}
+	curPos += purelyFramelen;
 
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										realCpyFrameNum -= 2;
-										tmp += 2;
-										textEncodingType = AV_ID3V2_UTF16;
-									}
-									else
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "pInfo->pSyncLyrics Never Get Here!!\n");
-										#endif
-									}
-								}
-								else if(textEncodingType == AV_ID3V2_UTF8)
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_UTF8;
-								}
-								else
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_ISO_8859;
-								}
+	//in case of UTF 16 encoding
+	//buffer+(curPos-purelyFramelen) data should '0x01' but in order to expansion, we don't accurately check the value.
+	if(IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen)))
+	{
+		encodingOffSet = 2;
+		textEncodingType = AV_ID3V2_UTF16;
+	}
+	else if (IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen)))
+	{
+		encodingOffSet = 2;
+		textEncodingType = AV_ID3V2_UTF16_BE;
+	}
+	else if(IS_ENCODEDBY_UTF16(buffer+(curPos-purelyFramelen+1)))
+	{
+		encodingOffSet = 3;
+		textEncodingType = AV_ID3V2_UTF16;
+	}
+	else if(IS_ENCODEDBY_UTF16_R(buffer+(curPos-purelyFramelen+1)))
+	{
+		encodingOffSet = 3;
+		textEncodingType = AV_ID3V2_UTF16_BE;
+	}
+	else
+	{
+		//in case of UTF-16 BE encoding
+		if(buffer[curPos-purelyFramelen] == 0x02)
+		{
+			encodingOffSet = 1;
+			while((buffer[curPos-purelyFramelen+encodingOffSet] == '\0') && (encodingOffSet < purelyFramelen))
+				encodingOffSet++;//null skip!
+			textEncodingType = AV_ID3V2_UTF16_BE;
+		}
+		//in case of UTF8 encoding
+		else if (buffer[curPos-purelyFramelen] == 0x03)
+		{
+			encodingOffSet = 1;
+			while((buffer[curPos-purelyFramelen+encodingOffSet] == '\0') && (encodingOffSet < purelyFramelen))
+				encodingOffSet++;//null skip!
+			textEncodingType = AV_ID3V2_UTF8;
+		}
+		//in case of ISO-8859-1 encoding
+		else
+		{
+			//buffer+(curPos-purelyFramelen) data should 0x00 but in order to expansion, we don't accurately check the value.
+			encodingOffSet = 1;
+			while((buffer[curPos-purelyFramelen+encodingOffSet] < 0x20) && (encodingOffSet < purelyFramelen))
+				encodingOffSet++;//less than 0x20 value skip!
+			textEncodingType = AV_ID3V2_ISO_8859;
+		}
+	}
 
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-								#endif
+	if(encodingOffSet < purelyFramelen)
+	{
+		realCpyFrameNum = purelyFramelen - encodingOffSet;
+		pExtContent = mmfile_malloc (realCpyFrameNum+3);
+		memset(pExtContent, '\0', realCpyFrameNum+3);
+		if(textEncodingType == AV_ID3V2_ISO_8859)
+		{
+			if(strncmp((char *)CompTmp, "APIC", 4) != 0)
+			{
+				tmpConvert2Pcode = mmfile_malloc ((realCpyFrameNum)*2+2);
+				memset(tmpConvert2Pcode, 0, (realCpyFrameNum)*2+2);
+			}
+		}
 
-								if(realCpyFrameNum < MMFILE_SYNC_LYRIC_INFO_MIN_LEN)
-								{
-									#ifdef __MMFILE_TEST_MODE__
-									debug_msg ( "failed to get Synchronised lyrics Info realCpyFramNum(%d)\n", realCpyFrameNum);
-									#endif
-									pInfo->syncLyricsNum = 0;
-								}
-								else
-								{
-									if(textEncodingType == AV_ID3V2_UTF16)
-									{
-										debug_warning ("[AV_ID3V2_UTF16] not implemented\n");
-									}
-									else if(textEncodingType == AV_ID3V2_UTF16_BE)
-									{
-										debug_warning ("[AV_ID3V2_UTF16_BE] not implemented\n");
-									}
-									else
-									{
-										for(idx = 0; idx < realCpyFrameNum; idx++)
-										{
-											if(pExtContent[tmp+idx] == 0x00)
-											{
-												synclyrics_info = (AvSynclyricsInfo *)malloc(sizeof(AvSynclyricsInfo));
-
-												if(textEncodingType == AV_ID3V2_UTF8) {
-													synclyrics_info->lyric_info= mmfile_malloc(copy_len+1);
-													memset(synclyrics_info->lyric_info, 0, copy_len+1);
-													memcpy(synclyrics_info->lyric_info, pExtContent+copy_start_pos, copy_len);
-													synclyrics_info->lyric_info[copy_len+1] = '\0';
-												}
-												else {
-													synclyrics_info->lyric_info = mmfile_string_convert ((const char*)&pExtContent[copy_start_pos], copy_len, "UTF-8", locale, NULL, NULL);
-												}
-
-												synclyrics_info->time_info= (unsigned long)pExtContent[tmp+idx+1] << 24 | (unsigned long)pExtContent[tmp+idx+2] << 16 | (unsigned long)pExtContent[tmp+idx+3] << 8  | (unsigned long)pExtContent[tmp+idx+4];
-												idx += 4;
-												copy_start_pos = tmp + idx + 1;
-												#ifdef __MMFILE_TEST_MODE__
-												debug_msg("[%d][%s] idx[%d], copy_len[%d] copy_start_pos[%d]", synclyrics_info->time_info, synclyrics_info->lyric_info, idx, copy_len, copy_start_pos);
-												#endif
-												copy_len = 0;
-												synclyrics_info_list = g_list_append(synclyrics_info_list, synclyrics_info);
-											}
-											copy_len ++;
-										}
-										pInfo->pSyncLyrics = synclyrics_info_list;
-										pInfo->syncLyricsNum = g_list_length(pInfo->pSyncLyrics);
-									}
-								}
-							}
-							else
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg (  "SyncLyrics info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
-								#endif
-							}
+		memcpy(pExtContent, &buffer[curPos-purelyFramelen+encodingOffSet], purelyFramelen-encodingOffSet);
 
-							tmp = 0;
-							pInfo->tagV2Info.bSyncLyricsMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "USLT", 4) == 0 && pInfo->tagV2Info.bUnsyncLyricsMarked == false)
-						{
-							if(realCpyFrameNum > 3)
-							{
-								realCpyFrameNum -= 3;
-								tmp = 3;
+		if(realCpyFrameNum > 0)
+		{
+			if(strncmp((char *)CompTmp, "TIT2", 4) == 0 && pInfo->tagV2Info.bTitleMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->titleLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pTitle= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pTitle, pExtContent, realCpyFrameNum);
+					pInfo->pTitle[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->titleLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pTitle, pExtContent, pInfo->titleLen);
+				}
+				else
+				{
+					pInfo->pTitle = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->titleLen);
+				}
 
-								if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
-								{
-									while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
-									{
-										realCpyFrameNum -= 4;
-										tmp += 4;
-									}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTitle returned = (%s), pInfo->titleLen(%d)\n", pInfo->pTitle, pInfo->titleLen);
+				#endif
+				pInfo->tagV2Info.bTitleMarked = true;
 
-									if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
-									{
-										realCpyFrameNum -= 2;
-										tmp += 2;
-										textEncodingType = AV_ID3V2_UTF16;
-									}
-									else
-									{
-										#ifdef __MMFILE_TEST_MODE__
-										debug_msg ( "pInfo->pUnsyncLyrics Never Get Here!!\n");
-										#endif
-									}
-								}
-								else if(textEncodingType == AV_ID3V2_UTF8)
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_UTF8;
-								}
-								else
-								{
-									while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
-									{
-										realCpyFrameNum --;
-										tmp++;
-									}
-									textEncodingType = AV_ID3V2_ISO_8859;
-								}
+			}
+			else if(strncmp((char *)CompTmp, "TPE1", 4) == 0 && pInfo->tagV2Info.bArtistMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->artistLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pArtist= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pArtist, pExtContent, realCpyFrameNum);
+					pInfo->pArtist[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->artistLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pArtist, pExtContent, pInfo->artistLen);
+				}
+				else
+				{
+					pInfo->pArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->artistLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pArtist returned = (%s), pInfo->artistLen(%d)\n", pInfo->pArtist, pInfo->artistLen);
+				#endif
+				pInfo->tagV2Info.bArtistMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TPE3", 4) == 0 && pInfo->tagV2Info.bConductorMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->conductorLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pConductor= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pConductor, pExtContent, realCpyFrameNum);
+					pInfo->pConductor[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->conductorLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pConductor, pExtContent, pInfo->conductorLen);
+				}
+				else
+				{
+					pInfo->pConductor = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->conductorLen);
+				}
 
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
-								#endif
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pConductor returned = (%s), pInfo->conductorLen(%d)\n", pInfo->pConductor, pInfo->conductorLen);
+				#endif
+				pInfo->tagV2Info.bConductorMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TALB", 4) == 0 && pInfo->tagV2Info.bAlbumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->albumLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pAlbum= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pAlbum, pExtContent, realCpyFrameNum);
+					pInfo->pAlbum[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->albumLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pAlbum, pExtContent, pInfo->albumLen);
+				}
+				else
+				{
+					pInfo->pAlbum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->albumLen);
+				}
 
-								if(textEncodingType == AV_ID3V2_UTF16)
-								{
-									pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->unsynclyricsLen);
-								}
-								else if(textEncodingType == AV_ID3V2_UTF16_BE)
-								{
-									debug_warning ("not implemented\n");
-								}
-								else if(textEncodingType == AV_ID3V2_UTF8)
-								{
-									pInfo->pUnsyncLyrics= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-									memset(pInfo->pUnsyncLyrics, 0, (realCpyFrameNum+2));
-									memcpy(pInfo->pUnsyncLyrics, pExtContent+tmp, realCpyFrameNum);
-									pInfo->pUnsyncLyrics[realCpyFrameNum] = '\0';
-									/*string copy with '\0'*/
-									pInfo->unsynclyricsLen = realCpyFrameNum;
-									_STRNCPY_EX (pInfo->pUnsyncLyrics, pExtContent, pInfo->unsynclyricsLen);
-								}
-								else
-								{
-									pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->unsynclyricsLen);
-								}
-							}
-							else
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg (  "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
-								#endif
-							}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pAlbum returned = (%s), pInfo->albumLen(%d)\n", pInfo->pAlbum, pInfo->albumLen);
+				#endif
+				pInfo->tagV2Info.bAlbumMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TYER", 4) == 0 && pInfo->tagV2Info.bYearMarked == false)	//TODO. TYER is replaced by the TDRC. but many files use TYER in v2.4
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->yearLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pYear= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pYear, pExtContent, realCpyFrameNum);
+					pInfo->pYear[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->yearLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pYear, pExtContent, pInfo->yearLen);
+				}
+				else
+				{
+					pInfo->pYear = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->yearLen);
+				}
 
-							tmp = 0;
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pYear returned = (%s), pInfo->yearLen(%d)\n", pInfo->pYear, pInfo->yearLen);
+				#endif
+				pInfo->tagV2Info.bYearMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "COMM", 4) == 0 && pInfo->tagV2Info.bDescriptionMarked == false)
+			{
+				if(realCpyFrameNum > 3)
+				{
+					realCpyFrameNum -= 3;
+					tmp = 3;
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pUnsyncLyrics returned = (%s), pInfo->unsynclyricsLen(%d)\n", pInfo->pUnsyncLyrics, pInfo->unsynclyricsLen);
-							#endif
-							pInfo->tagV2Info.bDescriptionMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TCON", 4) == 0 && pInfo->tagV2Info.bGenreMarked == false)
+					if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
+					{
+						while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pGenre= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pGenre, pExtContent, realCpyFrameNum);
-								pInfo->pGenre[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->genreLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pGenre, pExtContent, pInfo->genreLen);
-							}
-							else
-							{
-								pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
-							#endif
-							pInfo->tagV2Info.bGenreMarked = true;
+							realCpyFrameNum -= 4;
+							tmp += 4;
 						}
-						else if(strncmp((char *)CompTmp, "TRCK", 4) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
-						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pTrackNum= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pTrackNum, pExtContent, realCpyFrameNum);
-								pInfo->pTrackNum[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->tracknumLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pTrackNum, pExtContent, pInfo->tracknumLen);
-							}
-							else
-							{
-								pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
-							}
-
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
-							#endif
-							pInfo->tagV2Info.bTrackNumMarked = true;
-						}
-						else if(strncmp((char *)CompTmp, "TENC", 4) == 0 && pInfo->tagV2Info.bEncByMarked == false)
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pEncBy= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pEncBy, pExtContent, realCpyFrameNum);
-								pInfo->pEncBy[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->encbyLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pEncBy, pExtContent, pInfo->encbyLen);
-							}
-							else
-							{
-								pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
-							#endif
-							pInfo->tagV2Info.bEncByMarked = true;
+							realCpyFrameNum -= 2;
+							tmp += 2;
+							textEncodingType = AV_ID3V2_UTF16;
 						}
-						else if(strncmp((char *)CompTmp, "WXXX", 4) == 0 && pInfo->tagV2Info.bURLMarked == false)
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pURL= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pURL, pExtContent, realCpyFrameNum);
-								pInfo->pURL[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->urlLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pURL, pExtContent, pInfo->urlLen);
-							}
-							else
-							{
-								pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
-							}
-
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
+							debug_msg ( "pInfo->pDescription Never Get Here!!\n");
 							#endif
-							pInfo->tagV2Info.bURLMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TCOP", 4) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
+					}
+					else if(textEncodingType == AV_ID3V2_UTF8)
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pCopyright= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pCopyright, pExtContent, realCpyFrameNum);
-								pInfo->pCopyright[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->copyrightLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pCopyright, pExtContent, pInfo->copyrightLen);
-							}
-							else
-							{
-								pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
-							#endif
-							pInfo->tagV2Info.bCopyRightMarked = true;
+							realCpyFrameNum --;
+							tmp++;
 						}
-						else if(strncmp((char *)CompTmp, "TOPE", 4) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
+						textEncodingType = AV_ID3V2_UTF8;
+					}
+					else
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pOriginArtist= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pOriginArtist, pExtContent, realCpyFrameNum);
-								pInfo->pOriginArtist[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->originartistLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pOriginArtist, pExtContent, pInfo->originartistLen);
-							}
-							else
-							{
-								pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
-							}
-
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
-							#endif
-							pInfo->tagV2Info.bOriginArtistMarked = true;
+							realCpyFrameNum --;
+							tmp++;
 						}
-						else if(strncmp((char *)CompTmp, "TCOM", 4) == 0 && pInfo->tagV2Info.bComposerMarked == false)
+						textEncodingType = AV_ID3V2_ISO_8859;
+					}
+
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+					#endif
+
+					if(textEncodingType == AV_ID3V2_UTF16)
+					{
+						pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->descriptionLen);
+					}
+					else if(textEncodingType == AV_ID3V2_UTF16_BE)
+					{
+						debug_warning ("not implemented\n");
+					}
+					else if(textEncodingType == AV_ID3V2_UTF8)
+					{
+						pInfo->pDescription= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+						memset(pInfo->pDescription, 0, (realCpyFrameNum+2));
+						memcpy(pInfo->pDescription, pExtContent+tmp, realCpyFrameNum);
+						pInfo->pDescription[realCpyFrameNum] = '\0';
+						/*string copy with '\0'*/
+						pInfo->descriptionLen = realCpyFrameNum;
+						_STRNCPY_EX (pInfo->pDescription, pExtContent, pInfo->descriptionLen);
+					}
+					else
+					{
+						pInfo->pDescription = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->descriptionLen);
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg (  "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+					#endif
+				}
+
+				tmp = 0;
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pDescription returned = (%s), pInfo->descriptionLen(%d)\n", pInfo->pDescription, pInfo->descriptionLen);
+				#endif
+				pInfo->tagV2Info.bDescriptionMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "SYLT", 4) == 0 && pInfo->tagV2Info.bSyncLyricsMarked == false)
+			{
+				int idx = 0;
+				int copy_len = 0;
+				int copy_start_pos = tmp;
+				AvSynclyricsInfo *synclyrics_info = NULL;
+				GList *synclyrics_info_list = NULL;
+				
+				if(realCpyFrameNum > 5)
+				{
+					realCpyFrameNum -= 5;
+					tmp = 5;
+
+					if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
+					{
+						while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
-							}
-							else if (textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pComposer= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pComposer, pExtContent, realCpyFrameNum);
-								pInfo->pComposer[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->composerLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pComposer, pExtContent, pInfo->composerLen);
-							}
-							else
-							{
-								pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
-							}
+							realCpyFrameNum -= 4;
+							tmp += 4;
+						}
 
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pComposer returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
-							#endif
-							pInfo->tagV2Info.bComposerMarked = true;
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
+						{
+							realCpyFrameNum -= 2;
+							tmp += 2;
+							textEncodingType = AV_ID3V2_UTF16;
 						}
-						else if(strncmp((char *)CompTmp, "TDRC", 4) == 0 && pInfo->tagV2Info.bRecDateMarked== false)	//TYER(year) and TRDA are replaced by the TDRC
+						else
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pRecDate= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pRecDate, pExtContent, realCpyFrameNum);
-								pInfo->pRecDate[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->recdateLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pRecDate, pExtContent, pInfo->recdateLen);
-							}
-							else
-							{
-								pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
-							}
-
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
+							debug_msg ( "pInfo->pSyncLyrics Never Get Here!!\n");
 							#endif
-							pInfo->tagV2Info.bRecDateMarked = true;
 						}
-						else if(strncmp((char *)CompTmp, "TIT1", 4) == 0 && pInfo->tagV2Info.bContentGroupMarked== false)
+					}
+					else if(textEncodingType == AV_ID3V2_UTF8)
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 						{
-							if(textEncodingType == AV_ID3V2_UTF16)
-							{
-								pInfo->pContentGroup = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->contentGroupLen);
-							}
-							else if(textEncodingType == AV_ID3V2_UTF16_BE)
-							{
-								debug_warning ("not implemented\n");
-							}
-							else if(textEncodingType == AV_ID3V2_UTF8)
-							{
-								pInfo->pContentGroup= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
-								memcpy(pInfo->pContentGroup, pExtContent, realCpyFrameNum);
-								pInfo->pContentGroup[realCpyFrameNum] = '\0';
-								/*string copy with '\0'*/
-								pInfo->contentGroupLen = realCpyFrameNum;
-								_STRNCPY_EX (pInfo->pContentGroup, pExtContent, pInfo->contentGroupLen);
-							}
-							else
-							{
-								pInfo->pContentGroup = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->contentGroupLen);
-							}
-							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "pInfo->pContentGroup returned = (%s), pInfo->contentGroupLen(%d)\n", pInfo->pContentGroup, pInfo->contentGroupLen);
-							#endif
-							pInfo->tagV2Info.bContentGroupMarked = true;
+							realCpyFrameNum --;
+							tmp++;
 						}
-						else if(strncmp((char *)CompTmp, "APIC", 4) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
+						textEncodingType = AV_ID3V2_UTF8;
+					}
+					else
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
 						{
-							if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE || textEncodingType == AV_ID3V2_UTF8)
-							{
-								#ifdef __MMFILE_TEST_MODE__
-								debug_msg ( "mmf_file_id3tag_parse_v224: this is abnormal case!!\n");
-								#endif
-							}
-							else
-							{
-								if(pExtContent[0] != '\0')
-								{
-									for(inx = 0; inx < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1; inx++)
-										pInfo->imageInfo.imageMIMEType[inx] = '\0';//ini mimetype variable
-
-									while((checkImgMimeTypeMax < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1) && pExtContent[checkImgMimeTypeMax] != '\0')
-									{
-										pInfo->imageInfo.imageMIMEType[checkImgMimeTypeMax] = pExtContent[checkImgMimeTypeMax];
-										checkImgMimeTypeMax++;
-									}
-									pInfo->imageInfo.imgMimetypeLen = checkImgMimeTypeMax;
-								}
-								else
-								{
-									pInfo->imageInfo.imgMimetypeLen = 0;
-								}
-
-								imgstartOffset += checkImgMimeTypeMax;
-
-								if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
-								{
-									imgstartOffset++;//endofMIME(1byte)
+							realCpyFrameNum --;
+							tmp++;
+						}
+						textEncodingType = AV_ID3V2_ISO_8859;
+					}
 
-									if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
-									{
-										pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
-									}
-									imgstartOffset++;//PictureType(1byte)
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+					#endif
 
-									if(pExtContent[imgstartOffset] != 0x0)
-									{
-										for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
-											pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
+					if(realCpyFrameNum < MMFILE_SYNC_LYRIC_INFO_MIN_LEN)
+					{
+						#ifdef __MMFILE_TEST_MODE__
+						debug_msg ( "failed to get Synchronised lyrics Info realCpyFramNum(%d)\n", realCpyFrameNum);
+						#endif
+						pInfo->syncLyricsNum = 0;
+					}
+					else
+					{
+						if(textEncodingType == AV_ID3V2_UTF16)
+						{
+							debug_warning ("[AV_ID3V2_UTF16] not implemented\n");
+						}
+						else if(textEncodingType == AV_ID3V2_UTF16_BE)
+						{
+							debug_warning ("[AV_ID3V2_UTF16_BE] not implemented\n");
+						}
+						else
+						{
+							for(idx = 0; idx < realCpyFrameNum; idx++)
+							{
+								if(pExtContent[tmp+idx] == 0x00)
+								{
+									synclyrics_info = (AvSynclyricsInfo *)malloc(sizeof(AvSynclyricsInfo));
 
-										while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
-										{
-											pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
-											checkImgDescriptionMax++;
-										}
-										pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
+									if(textEncodingType == AV_ID3V2_UTF8) {
+										synclyrics_info->lyric_info= mmfile_malloc(copy_len+1);
+										memset(synclyrics_info->lyric_info, 0, copy_len+1);
+										memcpy(synclyrics_info->lyric_info, pExtContent+copy_start_pos, copy_len);
+										synclyrics_info->lyric_info[copy_len+1] = '\0';
 									}
-									else
-									{
-										pInfo->imageInfo.imgDesLen= 0;
+									else {
+										synclyrics_info->lyric_info = mmfile_string_convert ((const char*)&pExtContent[copy_start_pos], copy_len, "UTF-8", locale, NULL, NULL);
 									}
 
-									imgstartOffset += checkImgDescriptionMax;
-									if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
-									{
-										imgstartOffset ++; // endofDesceriptionType(1byte)
-
-										pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
-										pInfo->imageInfo.pImageBuf= mmfile_malloc (pInfo->imageInfo.imageLen+1);
-										memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
-										pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
-										if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
-											pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
-									}
+									synclyrics_info->time_info= (unsigned long)pExtContent[tmp+idx+1] << 24 | (unsigned long)pExtContent[tmp+idx+2] << 16 | (unsigned long)pExtContent[tmp+idx+3] << 8  | (unsigned long)pExtContent[tmp+idx+4];
+									idx += 4;
+									copy_start_pos = tmp + idx + 1;
+									#ifdef __MMFILE_TEST_MODE__
+									debug_msg("[%d][%s] idx[%d], copy_len[%d] copy_start_pos[%d]", synclyrics_info->time_info, synclyrics_info->lyric_info, idx, copy_len, copy_start_pos);
+									#endif
+									copy_len = 0;
+									synclyrics_info_list = g_list_append(synclyrics_info_list, synclyrics_info);
 								}
+								copy_len ++;
 							}
+							pInfo->pSyncLyrics = synclyrics_info_list;
+							pInfo->syncLyricsNum = g_list_length(pInfo->pSyncLyrics);
+						}
+					}
+				}
+				else
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg (  "SyncLyrics info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
+					#endif
+				}
+
+				tmp = 0;
+				pInfo->tagV2Info.bSyncLyricsMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "USLT", 4) == 0 && pInfo->tagV2Info.bUnsyncLyricsMarked == false)
+			{
+				if(realCpyFrameNum > 3)
+				{
+					realCpyFrameNum -= 3;
+					tmp = 3;
+
+					if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE)
+					{
+						while((NEWLINE_OF_UTF16(pExtContent + tmp) || NEWLINE_OF_UTF16_R(pExtContent + tmp))&& realCpyFrameNum > 4)
+						{
+							realCpyFrameNum -= 4;
+							tmp += 4;
+						}
 
-							checkImgMimeTypeMax = 0;
-							checkImgDescriptionMax = 0;
-							inx = 0;
-							imgstartOffset = 0;
-							pInfo->tagV2Info.bImageMarked= true;
+						if((IS_ENCODEDBY_UTF16(pExtContent+tmp) || IS_ENCODEDBY_UTF16_R(pExtContent+tmp)) && realCpyFrameNum > 2)
+						{
+							realCpyFrameNum -= 2;
+							tmp += 2;
+							textEncodingType = AV_ID3V2_UTF16;
 						}
 						else
 						{
 							#ifdef __MMFILE_TEST_MODE__
-							debug_msg ( "CompTmp(%s) This Frame ID currently not Supports!!\n", CompTmp);
+							debug_msg ( "pInfo->pUnsyncLyrics Never Get Here!!\n");
 							#endif
 						}
 					}
+					else if(textEncodingType == AV_ID3V2_UTF8)
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
+						{
+							realCpyFrameNum --;
+							tmp++;
+						}
+						textEncodingType = AV_ID3V2_UTF8;
+					}
+					else
+					{
+						while(pExtContent[tmp] < 0x20 && (tmp < realCpyFrameNum)) // text string encoded by ISO-8859-1
+						{
+							realCpyFrameNum --;
+							tmp++;
+						}
+						textEncodingType = AV_ID3V2_ISO_8859;
+					}
+
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "tmp(%d) textEncodingType(%d), realCpyFrameNum(%d)\n", tmp, textEncodingType, realCpyFrameNum);
+					#endif
 
+					if(textEncodingType == AV_ID3V2_UTF16)
+					{
+						pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->unsynclyricsLen);
+					}
+					else if(textEncodingType == AV_ID3V2_UTF16_BE)
+					{
+						debug_warning ("not implemented\n");
+					}
+					else if(textEncodingType == AV_ID3V2_UTF8)
+					{
+						pInfo->pUnsyncLyrics= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+						memset(pInfo->pUnsyncLyrics, 0, (realCpyFrameNum+2));
+						memcpy(pInfo->pUnsyncLyrics, pExtContent+tmp, realCpyFrameNum);
+						pInfo->pUnsyncLyrics[realCpyFrameNum] = '\0';
+						/*string copy with '\0'*/
+						pInfo->unsynclyricsLen = realCpyFrameNum;
+						_STRNCPY_EX (pInfo->pUnsyncLyrics, pExtContent, pInfo->unsynclyricsLen);
+					}
+					else
+					{
+						pInfo->pUnsyncLyrics = mmfile_string_convert ((const char*)&pExtContent[tmp], realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->unsynclyricsLen);
+					}
 				}
 				else
 				{
 					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "mmf_file_id3tag_parse_v224: All of the pExtContent Values are NULL\n");
+					debug_msg (  "Description info too small to parse realCpyFrameNum(%d)\n", realCpyFrameNum);
 					#endif
 				}
 
+				tmp = 0;
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pUnsyncLyrics returned = (%s), pInfo->unsynclyricsLen(%d)\n", pInfo->pUnsyncLyrics, pInfo->unsynclyricsLen);
+				#endif
+				pInfo->tagV2Info.bDescriptionMarked = true;
 			}
-			else
+			else if(strncmp((char *)CompTmp, "TCON", 4) == 0 && pInfo->tagV2Info.bGenreMarked == false)
 			{
-				curPos += purelyFramelen;
-				if(purelyFramelen != 0)
-					needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->genreLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pGenre= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pGenre, pExtContent, realCpyFrameNum);
+					pInfo->pGenre[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->genreLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pGenre, pExtContent, pInfo->genreLen);
+				}
+				else
+				{
+					pInfo->pGenre = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->genreLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pGenre returned = (%s), pInfo->genreLen(%d)\n", pInfo->pGenre, pInfo->genreLen);
+				#endif
+				pInfo->tagV2Info.bGenreMarked = true;
 			}
+			else if(strncmp((char *)CompTmp, "TRCK", 4) == 0 && pInfo->tagV2Info.bTrackNumMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pTrackNum= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pTrackNum, pExtContent, realCpyFrameNum);
+					pInfo->pTrackNum[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->tracknumLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pTrackNum, pExtContent, pInfo->tracknumLen);
+				}
+				else
+				{
+					pInfo->pTrackNum = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->tracknumLen);
+				}
 
-			if(pExtContent)	_FREE_EX(pExtContent);
-			if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
-			memset(CompTmp, 0, 4);
-			if(curPos < taglen)
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pTrackNum returned = (%s), pInfo->tracknumLen(%d)\n", pInfo->pTrackNum, pInfo->tracknumLen);
+				#endif
+				pInfo->tagV2Info.bTrackNumMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TENC", 4) == 0 && pInfo->tagV2Info.bEncByMarked == false)
 			{
-				needToloopv2taglen -= oneFrameLen;
-				v2numOfFrames++;
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->encbyLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pEncBy= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pEncBy, pExtContent, realCpyFrameNum);
+					pInfo->pEncBy[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->encbyLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pEncBy, pExtContent, pInfo->encbyLen);
+				}
+				else
+				{
+					pInfo->pEncBy = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->encbyLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pEncBy returned = (%s), pInfo->encbyLen(%d)\n", pInfo->pEncBy, pInfo->encbyLen);
+				#endif
+				pInfo->tagV2Info.bEncByMarked = true;
 			}
-			else
-				needToloopv2taglen = MP3_TAGv2_23_TXT_HEADER_LEN;
+			else if(strncmp((char *)CompTmp, "WXXX", 4) == 0 && pInfo->tagV2Info.bURLMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->urlLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pURL= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pURL, pExtContent, realCpyFrameNum);
+					pInfo->pURL[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->urlLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pURL, pExtContent, pInfo->urlLen);
+				}
+				else
+				{
+					pInfo->pURL = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->urlLen);
+				}
 
-			oneFrameLen = 0;
-			encodingOffSet = 0;
-			realCpyFrameNum = 0;
-			textEncodingType = 0;
-			purelyFramelen = 0;
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pURL returned = (%s), pInfo->urlLen(%d)\n", pInfo->pURL, pInfo->urlLen);
+				#endif
+				pInfo->tagV2Info.bURLMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TCOP", 4) == 0 && pInfo->tagV2Info.bCopyRightMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pCopyright= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pCopyright, pExtContent, realCpyFrameNum);
+					pInfo->pCopyright[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->copyrightLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pCopyright, pExtContent, pInfo->copyrightLen);
+				}
+				else
+				{
+					pInfo->pCopyright = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->copyrightLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pCopyright returned = (%s), pInfo->copyrightLen(%d)\n", pInfo->pCopyright, pInfo->copyrightLen);
+				#endif
+				pInfo->tagV2Info.bCopyRightMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TOPE", 4) == 0 && pInfo->tagV2Info.bOriginArtistMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pOriginArtist= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pOriginArtist, pExtContent, realCpyFrameNum);
+					pInfo->pOriginArtist[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->originartistLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pOriginArtist, pExtContent, pInfo->originartistLen);
+				}
+				else
+				{
+					pInfo->pOriginArtist = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->originartistLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pOriginArtist returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pOriginArtist, pInfo->originartistLen);
+				#endif
+				pInfo->tagV2Info.bOriginArtistMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TCOM", 4) == 0 && pInfo->tagV2Info.bComposerMarked == false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->composerLen);
+				}
+				else if (textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pComposer= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pComposer, pExtContent, realCpyFrameNum);
+					pInfo->pComposer[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->composerLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pComposer, pExtContent, pInfo->composerLen);
+				}
+				else
+				{
+					pInfo->pComposer = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->composerLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pComposer returned = (%s), pInfo->originartistLen(%d)\n", pInfo->pComposer, pInfo->composerLen);
+				#endif
+				pInfo->tagV2Info.bComposerMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TDRC", 4) == 0 && pInfo->tagV2Info.bRecDateMarked== false)	//TYER(year) and TRDA are replaced by the TDRC
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->recdateLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pRecDate= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pRecDate, pExtContent, realCpyFrameNum);
+					pInfo->pRecDate[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->recdateLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pRecDate, pExtContent, pInfo->recdateLen);
+				}
+				else
+				{
+					pInfo->pRecDate = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->recdateLen);
+				}
+
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pRecDate returned = (%s), pInfo->recdateLen(%d)\n", pInfo->pRecDate, pInfo->recdateLen);
+				#endif
+				pInfo->tagV2Info.bRecDateMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "TIT1", 4) == 0 && pInfo->tagV2Info.bContentGroupMarked== false)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16)
+				{
+					pInfo->pContentGroup = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", "UCS2", NULL, (unsigned int*)&pInfo->contentGroupLen);
+				}
+				else if(textEncodingType == AV_ID3V2_UTF16_BE)
+				{
+					debug_warning ("not implemented\n");
+				}
+				else if(textEncodingType == AV_ID3V2_UTF8)
+				{
+					pInfo->pContentGroup= mmfile_malloc (realCpyFrameNum+2);//Ignore NULL char for UTF16
+					memcpy(pInfo->pContentGroup, pExtContent, realCpyFrameNum);
+					pInfo->pContentGroup[realCpyFrameNum] = '\0';
+					/*string copy with '\0'*/
+					pInfo->contentGroupLen = realCpyFrameNum;
+					_STRNCPY_EX (pInfo->pContentGroup, pExtContent, pInfo->contentGroupLen);
+				}
+				else
+				{
+					pInfo->pContentGroup = mmfile_string_convert ((const char*)pExtContent, realCpyFrameNum, "UTF-8", locale, NULL, (unsigned int*)&pInfo->contentGroupLen);
+				}
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "pInfo->pContentGroup returned = (%s), pInfo->contentGroupLen(%d)\n", pInfo->pContentGroup, pInfo->contentGroupLen);
+				#endif
+				pInfo->tagV2Info.bContentGroupMarked = true;
+			}
+			else if(strncmp((char *)CompTmp, "APIC", 4) == 0 && pInfo->tagV2Info.bImageMarked == false && realCpyFrameNum <= 2000000)
+			{
+				if(textEncodingType == AV_ID3V2_UTF16 || textEncodingType == AV_ID3V2_UTF16_BE || textEncodingType == AV_ID3V2_UTF8)
+				{
+					#ifdef __MMFILE_TEST_MODE__
+					debug_msg ( "mmf_file_id3tag_parse_v224: this is abnormal case!!\n");
+					#endif
+				}
+				else
+				{
+					if(pExtContent[0] != '\0')
+					{
+						for(inx = 0; inx < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1; inx++)
+							pInfo->imageInfo.imageMIMEType[inx] = '\0';//ini mimetype variable
 
+						while((checkImgMimeTypeMax < MP3_ID3_IMAGE_MIME_TYPE_MAX_LENGTH-1) && pExtContent[checkImgMimeTypeMax] != '\0')
+						{
+							pInfo->imageInfo.imageMIMEType[checkImgMimeTypeMax] = pExtContent[checkImgMimeTypeMax];
+							checkImgMimeTypeMax++;
+						}
+						pInfo->imageInfo.imgMimetypeLen = checkImgMimeTypeMax;
+					}
+					else
+					{
+						pInfo->imageInfo.imgMimetypeLen = 0;
+					}
+
+					imgstartOffset += checkImgMimeTypeMax;
+
+					if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
+					{
+						imgstartOffset++;//endofMIME(1byte)
+
+						if(pExtContent[imgstartOffset] < AV_ID3V2_PICTURE_TYPE_MAX)
+						{
+							pInfo->imageInfo.pictureType = pExtContent[imgstartOffset];
+						}
+						imgstartOffset++;//PictureType(1byte)
+
+						if(pExtContent[imgstartOffset] != 0x0)
+						{
+							for(inx = 0; inx < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1; inx++)
+								pInfo->imageInfo.imageDescription[inx] = '\0';//ini imgdescripiton variable
+
+							while((checkImgDescriptionMax < MP3_ID3_IMAGE_DESCRIPTION_MAX_LENGTH-1) && pExtContent[imgstartOffset+checkImgDescriptionMax] != '\0')
+							{
+								pInfo->imageInfo.imageDescription[checkImgDescriptionMax] = pExtContent[imgstartOffset+checkImgDescriptionMax];
+								checkImgDescriptionMax++;
+							}
+							pInfo->imageInfo.imgDesLen= checkImgDescriptionMax;
+						}
+						else
+						{
+							pInfo->imageInfo.imgDesLen= 0;
+						}
+
+						imgstartOffset += checkImgDescriptionMax;
+						if((pExtContent[imgstartOffset] == '\0') && (realCpyFrameNum - imgstartOffset > 0))
+						{
+							imgstartOffset ++; // endofDesceriptionType(1byte)
+
+							pInfo->imageInfo.imageLen = realCpyFrameNum - imgstartOffset;
+							pInfo->imageInfo.pImageBuf= mmfile_malloc (pInfo->imageInfo.imageLen+1);
+							memcpy(pInfo->imageInfo.pImageBuf, pExtContent+ imgstartOffset, pInfo->imageInfo.imageLen);
+							pInfo->imageInfo.pImageBuf[pInfo->imageInfo.imageLen] = 0;
+							if(IS_INCLUDE_URL(pInfo->imageInfo.imageMIMEType))
+								pInfo->imageInfo.bURLInfo = true; //if mimetype is "-->", image date has an URL
+						}
+					}
+				}
+
+				checkImgMimeTypeMax = 0;
+				checkImgDescriptionMax = 0;
+				inx = 0;
+				imgstartOffset = 0;
+				pInfo->tagV2Info.bImageMarked= true;
+			}
+			else
+			{
+				#ifdef __MMFILE_TEST_MODE__
+				debug_msg ( "CompTmp(%s) This Frame ID currently not Supports!!\n", CompTmp);
+				#endif
+			}
 		}
-	}
 
-	if(taglen)
-		return true;
+	}
 	else
-		return false;
+	{
+		#ifdef __MMFILE_TEST_MODE__
+		debug_msg ( "mmf_file_id3tag_parse_v224: All of the pExtContent Values are NULL\n");
+		#endif
+	}
+
+	if(pExtContent)	_FREE_EX(pExtContent);
+	if(tmpConvert2Pcode)	_FREE_EX(tmpConvert2Pcode);
+}
+
+EXPORT_API
+void mm_file_id3tag_decode(AvFileContentInfo* pInfo, const unsigned char *buffer, int frameTypes)
+{
+	AvTagVer2AdditionalData *tag = &pInfo->tagV2Info;
+	const char *locale = NULL;
+	int i = 0;
+
+	/* each frame type is decoded once, the first frame of an id wins as before */
+	frameTypes &= ~tag->decodedFrames;
+	if (!frameTypes || !buffer || !tag->frameNum)
+		return;
+
+	locale = MMFileUtilGetLocale (NULL);
+
+	for (i = 0; i < tag->frameNum; i++)
+	{
+		if (!(tag->pFrames[i].type & frameTypes))
+			continue;
+
+		switch (tag->indexVersion)
+		{
+			case 2:
+				_mm_file_id3tag_decode_v222 (pInfo, buffer, &tag->pFrames[i], locale);
+				break;
+			case 3:
+				_mm_file_id3tag_decode_v223 (pInfo, buffer, &tag->pFrames[i], locale);
+				break;
+			case 4:
+				_mm_file_id3tag_decode_v224 (pInfo, buffer, &tag->pFrames[i], locale);
+				break;
+		}
+	}
 
+	tag->decodedFrames |= frameTypes;
 }
 
 EXPORT_API
@@ -23,6 +23,7 @@
 #include <stdlib.h>	/*malloc*/
 #include <mm_error.h>
 #include <mm_debug.h>
+#include <mm_types.h>
 #include "mm_file_utils.h"
 
 /* Description of return value
@@ -44,6 +45,14 @@ static int _MMFileIsMMFHeader  (void *header);
 static int _MMFileIsIMYHeader  (void *header);
 static int _MMFileIsASFHeader  (void *header);
 static int _MMFileIsAMRHeader  (void *header);
+static int _MMFileIsMatroskaHeader (void *header, int length);
+static int _MMFileFindAACCandidate (const unsigned char *buffer, int length);
+
+/* second byte of the frame sync: MPEG audio 0xFFE, AAC ADTS 0xFFF with layer 0 */
+#define _MMFILE_MP3_SYNC_MASK     0xE0
+#define _MMFILE_MP3_SYNC_VALUE    0xE0
+#define _MMFILE_AAC_SYNC_MASK     0xF6
+#define _MMFILE_AAC_SYNC_VALUE    0xF0
 
 
 
@@ -57,14 +66,15 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 #define _MMFILE_MP3_BUFFER_LENGTH   8200
 
 	MMFileIOHandle *fp = NULL;
-	unsigned char *buffer=NULL;
+	const unsigned char *buffer=NULL;
 	long long  filesize = 0;
 	unsigned int  sizeID3 = 0;
 	int           readed = 0;
-	unsigned int  startoffset = 0;
-	unsigned int  endoffset = 0;
-	unsigned int  i = 0, j = 0;
-	int ret = 0,frameSize,count,offset;
+	long long     startoffset = 0;
+	long long     endoffset = 0;
+	long long     i = 0;
+	unsigned int  j = 0;
+	int ret = 0,frameSize,count,offset,pos;
 
 	ret = mmfile_open (&fp, mmfileuri, MMFILE_RDONLY);
 	if(ret == MMFILE_UTIL_FAIL) {
@@ -100,17 +110,11 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 	/* find sync bit */
 	i = startoffset;
 	count = 0;
-	
-	buffer =  mmfile_malloc (_MMFILE_MP3_BUFFER_LENGTH * sizeof(char));
-
-	if (NULL == buffer) {
-		debug_error("Error in allocating memory for MP3 buffer\n");
-		goto exit;
-	}
 
 	while (i < endoffset) {
-		mmfile_seek (fp, i, MMFILE_SEEK_SET);
-		readed = mmfile_read (fp, buffer, _MMFILE_MP3_BUFFER_LENGTH);
+		/* lent by mmap and memory sources, copied otherwise */
+		if (buffer) mmfile_peek_release (fp, buffer);
+		readed = mmfile_peek (fp, i, _MMFILE_MP3_BUFFER_LENGTH, &buffer);
 		if (readed < _MMFILE_MP3_HEADER_LENGTH) {
 			debug_error ( "read error. size = %d. Maybe end of file.\n", readed);
 			ret = 0;
@@ -119,7 +123,15 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 
 		offset = 1;
 		for (j = 0; (j <= readed - _MMFILE_MP3_HEADER_LENGTH); j = j + offset) {
-			frameSize = _MMFileIsMP3Header (buffer+j);
+			/* skip to the next sync word candidate */
+			pos = mmfile_util_find_sync (buffer+j, readed - j - 2, _MMFILE_MP3_SYNC_MASK, _MMFILE_MP3_SYNC_VALUE);
+			if (pos < 0) {
+				j = readed - _MMFILE_MP3_HEADER_LENGTH + 1;
+				break;
+			}
+			j += pos;
+
+			frameSize = _MMFileIsMP3Header ((void *)(buffer+j));
 
 			offset = 1;
 			
@@ -136,7 +148,7 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 					break;
 				}
 
-				frameSize = _MMFileIsMP3Header (buffer+j+frameSize);
+				frameSize = _MMFileIsMP3Header ((void *)(buffer+j+frameSize));
 
 				if(frameSize) {
 					offset = frameSize;
@@ -144,7 +156,7 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 					if(count == frameCnt) {
 						ret = 1;
 						#ifdef __MMFILE_TEST_MODE__
-						debug_msg ( "Header Detected at %d\n", i+j);
+						debug_msg ( "Header Detected at %lld\n", i+j);
 						#endif
 						goto exit;
 					}
@@ -158,12 +170,12 @@ int MMFileFormatIsValidMP3 (const char *mmfileuri, int frameCnt)
 
 failMP3:
 	#ifdef __MMFILE_TEST_MODE__
-	debug_msg ( "Header Not Detected at: %d\n",i+j);
+	debug_msg ( "Header Not Detected at: %lld\n",i+j);
 	#endif
 exit:
 
 	if(buffer) {
-		mmfile_free (buffer);
+		mmfile_peek_release (fp, buffer);
 	}
 
 	if (fp) {
@@ -185,14 +197,16 @@ int MMFileFormatIsValidAAC (const char *mmfileuri)
 #define _MMFILE_AAC_BUFFER_LENGTH   8200
 
 	MMFileIOHandle *fp = NULL;
-	unsigned char *buffer=NULL;
+	const unsigned char *buffer=NULL;
 	unsigned int  sizeID3 = 0;
 	long long     filesize = 0;
 	int           readed = 0;
-	unsigned int  startoffset = 0;
-	unsigned int  endoffset = 0;
-	unsigned int  i = 0, j = 0;
+	long long     startoffset = 0;
+	long long     endoffset = 0;
+	long long     i = 0;
+	unsigned int  j = 0;
 	int ret = 0;
+	int pos = 0;
 	unsigned int sync,frameSize;
 
 	if (NULL == mmfileuri) {
@@ -232,19 +246,12 @@ int MMFileFormatIsValidAAC (const char *mmfileuri)
 	if(endoffset > filesize - _MMFILE_AAC_HEADER_LENGTH)
 		endoffset = filesize - _MMFILE_AAC_HEADER_LENGTH;
 	
-	buffer = mmfile_malloc (_MMFILE_AAC_BUFFER_LENGTH * sizeof(char));
-
-	if (NULL == buffer) {
-		debug_error("Error in allocating memory for AAC buffer\n");
-		goto exit;
-	}
-	
 	i = startoffset;
 
 	while (i < endoffset) {
-		mmfile_seek (fp, i, MMFILE_SEEK_SET);
-
-		readed = mmfile_read (fp, buffer, _MMFILE_AAC_BUFFER_LENGTH);
+		/* lent by mmap and memory sources, copied otherwise */
+		if (buffer) mmfile_peek_release (fp, buffer);
+		readed = mmfile_peek (fp, i, _MMFILE_AAC_BUFFER_LENGTH, &buffer);
 	
 		if (readed < _MMFILE_AAC_HEADER_LENGTH) {
 			debug_error ( "read error. size = %d. Maybe end of file.\n", readed);
@@ -253,9 +260,16 @@ int MMFileFormatIsValidAAC (const char *mmfileuri)
 		}
 
 		#ifdef __MMFILE_TEST_MODE__
-		debug_msg ( "read error. size = %d. i = %d\n", readed,i);
+		debug_msg ( "read error. size = %d. i = %lld\n", readed,i);
 		#endif
 		for(j=0; (j < readed - _MMFILE_AAC_HEADER_LENGTH); j++) {
+			/* skip to the next sync word or ADIF candidate */
+			pos = _MMFileFindAACCandidate (buffer+j, readed - _MMFILE_AAC_HEADER_LENGTH - j);
+			if (pos < 0) {
+				j = readed - _MMFILE_AAC_HEADER_LENGTH;
+				break;
+			}
+			j += pos;
 
 			sync = ((buffer[j]<<8)|(buffer[j+1]));
 
@@ -281,14 +295,14 @@ int MMFileFormatIsValidAAC (const char *mmfileuri)
 				if ((sync & 0xFFF6) == 0xFFF0) {
 					ret = 1;
 					#ifdef __MMFILE_TEST_MODE__
-					debug_msg ( "AAC ADTS Header Detected at %d\n", i+j);
+					debug_msg ( "AAC ADTS Header Detected at %lld\n", i+j);
 					#endif
 					goto exit;
 				}
 			} else if (!memcmp((buffer+j),"ADIF",4)) {
 				ret = 1;
 				#ifdef __MMFILE_TEST_MODE__
-				debug_msg ( "AAC ADIF Header Detected at %d\n", i+j);
+				debug_msg ( "AAC ADIF Header Detected at %lld\n", i+j);
 				#endif
 				goto exit;
 			}
@@ -304,7 +318,7 @@ fail:
 
 exit:
 	if (buffer) {
-		mmfile_free (buffer);
+		mmfile_peek_release (fp, buffer);
 	}
 
 	if (fp) {
@@ -331,11 +345,12 @@ int MMFileFormatIsValidOGG (const char *mmfileuri)
 	unsigned int  sizeID3 = 0;
 	long long     filesize = 0;
 	int           readed = 0;
-	unsigned int  startoffset = 0;
-	unsigned int  endoffset = 0;
-	unsigned int  i = 0, j = 0;
+	long long     startoffset = 0;
+	long long     endoffset = 0;
+	long long     i = 0;
+	unsigned int  j = 0;
 	int ret = 0;
-	unsigned int check_limit = 0;
+	long long     check_limit = 0;
 
 	if (NULL == mmfileuri) {
 		debug_error ("file source is NULL\n");
@@ -390,7 +405,7 @@ int MMFileFormatIsValidOGG (const char *mmfileuri)
 			if (1 == _MMFileIsOGGHeader (buffer+j)) {
 				ret = 1;
 				#ifdef __MMFILE_TEST_MODE__
-				debug_msg ( "Header Detected at %d\n", i+j);
+				debug_msg ( "Header Detected at %lld\n", i+j);
 				#endif
 				goto exit;
 			}
@@ -425,11 +440,12 @@ int MMFileFormatIsValidMID (const char *mmfileuri)
 	unsigned char buffer[_MMFILE_MIDI_BUFFER_LENGTH] = {0,};
 	long long     filesize = 0;
 	int           readed = 0;
-	unsigned int  startoffset = 0;
-	unsigned int  endoffset = 0;
-	unsigned int  i = 0, j = 0;
+	long long     startoffset = 0;
+	long long     endoffset = 0;
+	long long     i = 0;
+	unsigned int  j = 0;
 	int ret = 0;
-	unsigned int check_limit = 0;
+	long long     check_limit = 0;
 
 	if (NULL == mmfileuri) {
 		debug_error ("file source is NULL\n");
@@ -475,7 +491,7 @@ int MMFileFormatIsValidMID (const char *mmfileuri)
 			if (1 == _MMFileIsMIDHeader (buffer+j)) {
 				ret = 1;
 				#ifdef __MMFILE_TEST_MODE__
-				debug_msg ( "Header Detected at %d\n", i+j);
+				debug_msg ( "Header Detected at %lld\n", i+j);
 				#endif
 				goto exit;
 			}
@@ -1214,6 +1230,351 @@ int MMFileFormatIsValidQT (const char *mmfileuri)
 }
 
 
+/***********************************************************************/
+/*                     Format Probe API                                */
+/***********************************************************************/
+#define _MMFILE_PROBE_ID3_HEADER_LENGTH   10
+#define _MMFILE_PROBE_ID3V1_LENGTH        128
+#define _MMFILE_PROBE_SYNC_RANGE          102400	/*same range as MMFileFormatIsValidMP3*/
+#define _MMFILE_PROBE_AAC_RANGE           10240
+#define _MMFILE_PROBE_MP4_RANGE           (1024*10)
+#define _MMFILE_PROBE_OGG_RANGE           (4000 + 512)
+#define _MMFILE_PROBE_MID_RANGE           (4096 + 512)
+#define _MMFILE_PROBE_MP3_FRAME_COUNT     50
+#define _MMFILE_PROBE_MP3_WEAK_FRAME_COUNT 5
+
+/* A magic at offset 0 is certain. A magic found by scanning, or a run of
+ * audio frame syncs, is only as good as the old validity check it replaces. */
+#define _MMFILE_PROBE_SCORE_MAGIC         100
+#define _MMFILE_PROBE_SCORE_MP4_BOX       90
+#define _MMFILE_PROBE_SCORE_MP3_SYNC      75
+#define _MMFILE_PROBE_SCORE_AAC_ADIF      75
+#define _MMFILE_PROBE_SCORE_OGG_SCAN      70
+#define _MMFILE_PROBE_SCORE_AAC_ADTS      60
+#define _MMFILE_PROBE_SCORE_MID_SCAN      50
+#define _MMFILE_PROBE_SCORE_MP4_SCAN      30
+#define _MMFILE_PROBE_SCORE_TAG_BONUS     10
+
+static int _MMFileProbeID3Size (MMFileIOHandle *fp, const unsigned char *head, int headLen, unsigned int *offset)
+{
+	unsigned char tagHeader[_MMFILE_PROBE_ID3_HEADER_LENGTH] = {0,};
+	const unsigned char *s = NULL;
+	unsigned int tagInfoSize = 0;
+	int encSize = 0;
+
+	*offset = 0;
+
+	while (1) {
+		/* the first tag header is always in the head, chained ones may be beyond it */
+		if (*offset + _MMFILE_PROBE_ID3_HEADER_LENGTH <= (unsigned int) headLen) {
+			s = head + *offset;
+		} else {
+			if (NULL == fp)
+				break;
+			mmfile_seek (fp, *offset, MMFILE_SEEK_SET);
+			if (mmfile_read (fp, tagHeader, _MMFILE_PROBE_ID3_HEADER_LENGTH) != _MMFILE_PROBE_ID3_HEADER_LENGTH)
+				break;
+			s = tagHeader;
+		}
+
+		if (memcmp (s, "ID3", 3) != 0)
+			break;
+
+		/**@note weak id3v2 tag checking*/
+		if (s[3] == 0xFF || s[4] == 0xFF || (s[6] & 0x80) || (s[7] & 0x80) || (s[8] & 0x80) || (s[9] & 0x80) || s[3] > 4) {
+			debug_warning ("It's bad ID3V2 tag.\n");
+			break;
+		}
+
+		encSize = (int)((s[6] << 24) | (s[7] << 16) | (s[8] << 8) | s[9]);
+		tagInfoSize = _MMFILE_PROBE_ID3_HEADER_LENGTH;
+		tagInfoSize += (((encSize & 0x0000007F) >> 0) | ((encSize & 0x00007F00) >> 1) | ((encSize & 0x007F0000) >> 2) | ((encSize & 0x7F000000) >> 3));
+
+		*offset += tagInfoSize;
+	}
+
+	return (*offset > 0);
+}
+
+static int _MMFileProbeMP3Sync (const unsigned char *buffer, int length, int frameCnt)
+{
+	int count = 0;
+	int frameSize = 0;
+	int pos = 0;
+	int j = 0;
+
+	/* counts frame pairs the same way MMFileFormatIsValidMP3 does, up to frameCnt */
+	while (j <= length - _MMFILE_MP3_HEADER_LENGTH) {
+		pos = mmfile_util_find_sync (buffer + j, length - j - 2, _MMFILE_MP3_SYNC_MASK, _MMFILE_MP3_SYNC_VALUE);
+		if (pos < 0)
+			break;
+		j += pos;
+
+		frameSize = _MMFileIsMP3Header ((void *)(buffer + j));
+		if (frameSize == 0) {
+			j++;
+			continue;
+		}
+
+		if (j + frameSize > length - _MMFILE_MP3_HEADER_LENGTH)
+			break;
+
+		if (_MMFileIsMP3Header ((void *)(buffer + j + frameSize))) {
+			if (++count == frameCnt)
+				break;
+			j += frameSize;
+		} else {
+			j++;
+		}
+	}
+
+	return count;
+}
+
+static int _MMFileProbeAACSync (const unsigned char *buffer, int length)
+{
+	unsigned int sync = 0, frameSize = 0;
+	int pos = 0;
+	int j = 0;
+
+	for (j = 0; j < length - 6; j++) {
+		pos = _MMFileFindAACCandidate (buffer + j, length - 6 - j);
+		if (pos < 0)
+			break;
+		j += pos;
+
+		sync = ((buffer[j] << 8) | (buffer[j+1]));
+
+		if ((sync & 0xFFF6) == 0xFFF0) {
+			frameSize = (((buffer[j+3] & 0x03) << 11) | (buffer[j+4] << 3) | ((buffer[j+5] & 0xE0) >> 5));
+			if (frameSize == 0)
+				continue;
+
+			if (j + frameSize + 2 > length)
+				break;
+
+			sync = ((buffer[j+frameSize] << 8) | (buffer[j+frameSize+1]));
+			if ((sync & 0xFFF6) == 0xFFF0)
+				return _MMFILE_PROBE_SCORE_AAC_ADTS;
+		} else if (!memcmp ((buffer + j), "ADIF", 4)) {
+			return _MMFILE_PROBE_SCORE_AAC_ADIF;
+		}
+	}
+
+	return 0;
+}
+
+static int _MMFileProbeAdd (MMFileProbeResult *result, int count, int max, int format, int score)
+{
+	int i = 0;
+
+	if (score <= 0)
+		return count;
+
+	if (score > MMFILE_PROBE_SCORE_MAX)
+		score = MMFILE_PROBE_SCORE_MAX;
+
+	/* keep it sorted by score, ties stay in insertion order */
+	for (i = count; i > 0 && result[i-1].score < score; i--) {
+		if (i < max)
+			result[i] = result[i-1];
+	}
+
+	if (i >= max)
+		return count;
+
+	result[i].format = format;
+	result[i].score = score;
+
+	return (count < max) ? count + 1 : max;
+}
+
+/**
+ * Probes the format of a content from its head and tail, which the caller
+ * read once. Every header check runs against the same buffers and the
+ * candidates are returned in @result, best score first. @fp is read only
+ * when ID3v2 tags are longer than the head.
+ *
+ * @return number of candidates in @result, 0 when nothing matches.
+ */
+EXPORT_API
+int MMFileFormatProbeBuffer (MMFileIOHandle *fp, long long filesize, const unsigned char *head, int headLen, const unsigned char *tail, int tailLen, MMFileProbeResult *result, int max)
+{
+	const unsigned char *sync = NULL;
+	const unsigned char *window = NULL;
+	unsigned int sizeID3 = 0;
+	int windowLen = 0;
+	int hasID3v1 = 0;
+	int count = 0;
+	int score = 0;
+	int limit = 0;
+	int i = 0;
+
+	if (NULL == head || NULL == result || max <= 0) {
+		debug_error ("invalid param\n");
+		return 0;
+	}
+
+	if (headLen < _MMFILE_MP3_HEADER_LENGTH) {
+		debug_error ("header is too small.\n");
+		return 0;
+	}
+
+	/* fixed magic at the start of the file */
+	if (headLen >= 16 && _MMFileIsASFHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_ASF, _MMFILE_PROBE_SCORE_MAGIC);
+	if (headLen >= 12 && _MMFileIsAVIHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_AVI, _MMFILE_PROBE_SCORE_MAGIC);
+	if (headLen >= 15 && _MMFileIsWAVHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_WAV, _MMFILE_PROBE_SCORE_MAGIC);
+	if (headLen >= 15 && _MMFileIsAMRHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_AMR, _MMFILE_PROBE_SCORE_MAGIC);
+	if (headLen >= 18 && _MMFileIsMMFHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_MMF, _MMFILE_PROBE_SCORE_MAGIC);
+	if (headLen >= 13 && _MMFileIsIMYHeader ((void *)head))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_IMELODY, _MMFILE_PROBE_SCORE_MAGIC);
+	if (_MMFileIsMatroskaHeader ((void *)head, headLen))
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_MATROSKA, _MMFILE_PROBE_SCORE_MAGIC);
+
+	/**@note weak check, a box name anywhere in the first 10Kbyte*/
+	limit = (headLen < _MMFILE_PROBE_MP4_RANGE) ? headLen : _MMFILE_PROBE_MP4_RANGE;
+	for (i = 0; i + _MMFILE_MP4_HEADER_LENGTH < limit; i++) {
+		if (_MMFileIsMP4Header ((void *)(head + i))) {
+			score = (i == 4) ? _MMFILE_PROBE_SCORE_MP4_BOX : _MMFILE_PROBE_SCORE_MP4_SCAN;
+			count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_3GP, score);
+			break;
+		}
+	}
+
+	limit = (headLen < _MMFILE_PROBE_MID_RANGE) ? headLen : _MMFILE_PROBE_MID_RANGE;
+	for (i = 0; i <= limit - _MMFILE_MIDI_HEADER_LENGTH; i++) {
+		if (_MMFileIsMIDHeader ((void *)(head + i))) {
+			score = (i == 0) ? _MMFILE_PROBE_SCORE_MAGIC : _MMFILE_PROBE_SCORE_MID_SCAN;
+			count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_MID, score);
+			break;
+		}
+	}
+
+	/* the rest may be preceded by ID3v2 tags */
+	_MMFileProbeID3Size (fp, head, headLen, &sizeID3);
+
+	if (sizeID3 < _MMFILE_PROBE_OGG_RANGE) {
+		limit = (headLen < _MMFILE_PROBE_OGG_RANGE) ? headLen : _MMFILE_PROBE_OGG_RANGE;
+		for (i = sizeID3; i <= limit - _MMFILE_OGG_HEADER_LENGTH; i++) {
+			if (_MMFileIsOGGHeader ((void *)(head + i))) {
+				score = (i == 0) ? _MMFILE_PROBE_SCORE_MAGIC : _MMFILE_PROBE_SCORE_OGG_SCAN;
+				count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_OGG, score);
+				break;
+			}
+		}
+	}
+
+	/* a tag at the end of the file raises the confidence of a frame sync match */
+	if (tail && tailLen >= _MMFILE_PROBE_ID3V1_LENGTH && filesize > sizeID3 + _MMFILE_PROBE_ID3V1_LENGTH &&
+		!memcmp (tail + tailLen - _MMFILE_PROBE_ID3V1_LENGTH, "TAG", 3))
+		hasID3v1 = 1;
+
+	if (filesize > headLen && sizeID3 + _MMFILE_PROBE_SYNC_RANGE + _MMFILE_MP3_HEADER_LENGTH > (unsigned int) headLen) {
+		/* the audio data starts beyond the head, look at one more window there */
+		if (fp) {
+			windowLen = mmfile_peek (fp, sizeID3, MMFILE_PROBE_HEAD_SIZE, &sync);
+			window = sync;
+		}
+	} else if (sizeID3 < (unsigned int) headLen) {
+		window = head + sizeID3;
+		windowLen = headLen - sizeID3;
+	}
+
+	if (window && windowLen >= _MMFILE_MP3_HEADER_LENGTH) {
+		limit = (windowLen < _MMFILE_PROBE_SYNC_RANGE + _MMFILE_MP3_HEADER_LENGTH) ? windowLen : _MMFILE_PROBE_SYNC_RANGE + _MMFILE_MP3_HEADER_LENGTH;
+		i = _MMFileProbeMP3Sync (window, limit, _MMFILE_PROBE_MP3_FRAME_COUNT);
+		if (i >= _MMFILE_PROBE_MP3_FRAME_COUNT) {
+			score = _MMFILE_PROBE_SCORE_MP3_SYNC;
+			if (sizeID3 > 0 || hasID3v1)
+				score += _MMFILE_PROBE_SCORE_TAG_BONUS;
+			count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_MP3, score);
+		} else if (i >= _MMFILE_PROBE_MP3_WEAK_FRAME_COUNT) {
+			/* enough when the extension says mp3, see MMFILE_PROBE_SCORE_WEAK */
+			count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_MP3, MMFILE_PROBE_SCORE_WEAK);
+		}
+
+		limit = (windowLen < _MMFILE_PROBE_AAC_RANGE) ? windowLen : _MMFILE_PROBE_AAC_RANGE;
+		score = _MMFileProbeAACSync (window, limit);
+		if (score > 0 && sizeID3 > 0)
+			score += _MMFILE_PROBE_SCORE_TAG_BONUS;
+		count = _MMFileProbeAdd (result, count, max, MM_FILE_FORMAT_AAC, score);
+	}
+
+	#ifdef __MMFILE_TEST_MODE__
+	for (i = 0; i < count; i++)
+		debug_msg ("probe [%d] format: %d, score: %d\n", i, result[i].format, result[i].score);
+	#endif
+
+	if (sync)
+		mmfile_peek_release (fp, sync);
+
+	return count;
+}
+
+/**
+ * Same as MMFileFormatProbeBuffer() for a content which is not opened yet.
+ */
+EXPORT_API
+int MMFileFormatProbe (const char *mmfileuri, MMFileProbeResult *result, int max)
+{
+	MMFileIOHandle *fp = NULL;
+	unsigned char *head = NULL;
+	unsigned char tail[MMFILE_PROBE_TAIL_SIZE] = {0,};
+	long long filesize = 0;
+	int headLen = 0;
+	int tailLen = 0;
+	int count = 0;
+
+	if (NULL == mmfileuri || NULL == result || max <= 0) {
+		debug_error ("invalid param\n");
+		return 0;
+	}
+
+	if (mmfile_open (&fp, mmfileuri, MMFILE_RDONLY) == MMFILE_UTIL_FAIL) {
+		debug_error ("error: mmfile_open\n");
+		return 0;
+	}
+
+	mmfile_seek (fp, 0L, MMFILE_SEEK_END);
+	filesize = mmfile_tell (fp);
+	mmfile_seek (fp, 0L, MMFILE_SEEK_SET);
+
+	head = mmfile_malloc (MMFILE_PROBE_HEAD_SIZE);
+	if (NULL == head) {
+		debug_error ("error: mmfile_malloc probe buffer\n");
+		goto exit;
+	}
+
+	headLen = mmfile_read (fp, head, MMFILE_PROBE_HEAD_SIZE);
+	if (headLen < _MMFILE_MP3_HEADER_LENGTH) {
+		debug_error ("read error. size = %d.\n", headLen);
+		goto exit;
+	}
+
+	if (filesize > headLen) {
+		tailLen = (filesize - headLen < MMFILE_PROBE_TAIL_SIZE) ? (int)(filesize - headLen) : MMFILE_PROBE_TAIL_SIZE;
+		mmfile_seek (fp, -tailLen, MMFILE_SEEK_END);
+		tailLen = mmfile_read (fp, tail, tailLen);
+	}
+
+	count = MMFileFormatProbeBuffer (fp, filesize, head, headLen, tailLen > 0 ? tail : NULL, tailLen, result, max);
+
+exit:
+	if (head)
+		mmfile_free (head);
+
+	if (fp)
+		mmfile_close (fp);
+
+	return count;
+}
+
+
 /***********************************************************************/
 /*            Implementation of Internal Functions                     */
 /***********************************************************************/
@@ -1245,6 +1606,40 @@ static int _MMFileIsASFHeader  (void *header)
 	return 0;
 }
 
+static int _MMFileIsMatroskaHeader (void *header, int length)
+{
+	unsigned char *s = header;
+	const char probe_data[] = { 'm', 'a', 't', 'r', 'o', 's', 'k', 'a' };
+	const char probe_webm[] = { 'w', 'e', 'b', 'm' };
+	int total = 0;
+	int n = 0;
+
+	if (length < 5)
+		return 0;
+
+	/* ebml header? */
+	if (s[0] != 0x1A || s[1] != 0x45 || s[2] != 0xDF || s[3] != 0xA3)
+		return 0;
+
+	/* only a one byte header length is handled, as in MMFileFormatIsValidMatroska */
+	if (!(s[4] & 0x80))
+		return 0;
+
+	total = s[4] & 0x7F;
+	if (5 + total > length)
+		total = length - 5;
+
+	for (n = 0; n + (int) sizeof (probe_webm) <= total; n++) {
+		if (n + (int) sizeof (probe_data) <= total && !memcmp (s + 5 + n, probe_data, sizeof (probe_data)))
+			return 1;
+		/* WebM is a Matroska subset with its own doctype */
+		if (!memcmp (s + 5 + n, probe_webm, sizeof (probe_webm)))
+			return 1;
+	}
+
+	return 0;
+}
+
 static int _MMFileIsAMRHeader  (void *header)
 {
 #define _MMFILE_AMR_SINGLE_CH_HEADER_SIZE       6
@@ -1376,6 +1771,33 @@ static int _MMFileIsOGGHeader (void *header)
 	return 0;
 }
 
+/**
+ * Returns the first offset below @length holding an ADTS sync word or "ADIF".
+ * The buffer must have 4 readable bytes beyond @length - 1.
+ */
+static int _MMFileFindAACCandidate (const unsigned char *buffer, int length)
+{
+	const unsigned char *adif = NULL;
+	int sync = 0;
+	int limit = 0;
+
+	if (length <= 0)
+		return -1;
+
+	/* the sync finder looks at byte pairs, the last candidate starts at length - 1 */
+	sync = mmfile_util_find_sync (buffer, length + 1, _MMFILE_AAC_SYNC_MASK, _MMFILE_AAC_SYNC_VALUE);
+
+	limit = (sync < 0) ? length : sync;
+	adif = buffer;
+	while ((adif = memchr (adif, 'A', limit - (adif - buffer))) != NULL) {
+		if (!memcmp (adif, "ADIF", 4))
+			return adif - buffer;
+		adif++;
+	}
+
+	return sync;
+}
+
 static int _MMFileIsMP3Header (void *header)
 {
 	unsigned long head = 0;